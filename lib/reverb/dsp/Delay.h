@@ -45,16 +45,27 @@ class Delay
 		uint size;
 		sample_t * data;
 		uint read, write;
+		uint capacity;
 
-		Delay() { read = write = 0; data = 0; }
+		Delay() { read = write = 0; data = 0; capacity = 0; }
 
 		~Delay() { free (data); }
 
+		/// (mixxx) Reuse the buffer if it is large enough, so the reverb
+		/// can be reinitialized in the audio thread without allocating
+		/// and without leaking the previous buffer.
 		void init (uint n)
 			{
 				size = next_power_of_2 (n);
 				assert (size <= (1 << 20));
-				data = (sample_t *) calloc (sizeof (sample_t), size);
+				if (size > capacity)
+				{
+					free (data);
+					data = (sample_t *) calloc (sizeof (sample_t), size);
+					capacity = size;
+				}
+				else
+					memset (data, 0, size * sizeof (sample_t));
 				--size; /* used as mask for confining access */
 				write = n;
 			}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "analyzer/analyzerchunk.h"
 #include "analyzer/analyzertrack.h"
 #include "audio/signalinfo.h"
 #include "audio/types.h"
@@ -35,6 +36,19 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
 
+    // The shared views of each chunk that are needed by processChunk().
+    // Only valid after initialize() returned true.
+    virtual int requiredChunkViews() const {
+        return AnalyzerChunk::None;
+    }
+
+    // Analyze the next chunk with the shared views that have been
+    // requested by requiredChunkViews(). Analyzers that don't need
+    // any views simply process the decoded samples.
+    virtual bool processChunk(const AnalyzerChunk& chunk) {
+        return processSamples(chunk.samples(), chunk.sampleCount());
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -75,9 +89,16 @@ class AnalyzerWithState final {
         return m_active = m_analyzer->initialize(track, sampleRate, channelCount, frameLength);
     }
 
-    void processSamples(const CSAMPLE* pIn, const int count) {
+    int requiredChunkViews() const {
+        if (!m_active) {
+            return AnalyzerChunk::None;
+        }
+        return m_analyzer->requiredChunkViews();
+    }
+
+    void processChunk(const AnalyzerChunk& chunk) {
         if (m_active) {
-            m_active = m_analyzer->processSamples(pIn, count);
+            m_active = m_analyzer->processChunk(chunk);
             if (!m_active) {
                 // Ensure that cleanup() is invoked after processing
                 // failed and the analyzer became inactive!
@@ -243,6 +243,31 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
     return ret;
 }
 
+int AnalyzerBeats::requiredChunkViews() const {
+    if (!m_pPlugin || !m_pPlugin->supportsMonoSamples()) {
+        return AnalyzerChunk::None;
+    }
+    if (m_channelCount == mixxx::audio::ChannelCount::stem() &&
+            m_bpmSettings.getStemStrategy() == BeatDetectionSettings::StemStrategy::Enforced) {
+        // Only the drum stem is analyzed, see processSamples()
+        return AnalyzerChunk::None;
+    }
+    return AnalyzerChunk::MonoMix;
+}
+
+bool AnalyzerBeats::processChunk(const AnalyzerChunk& chunk) {
+    if (requiredChunkViews() != AnalyzerChunk::MonoMix) {
+        return processSamples(chunk.samples(), chunk.sampleCount());
+    }
+
+    m_currentFrame += chunk.frameCount();
+    if (m_currentFrame > m_maxFramesToProcess) {
+        return true; // silently ignore all remaining samples
+    }
+
+    return m_pPlugin->processMonoSamples(chunk.monoMix(), chunk.frameCount());
+}
+
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
 }
@@ -24,6 +24,8 @@ class AnalyzerBeats : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    int requiredChunkViews() const override;
+    bool processChunk(const AnalyzerChunk& chunk) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
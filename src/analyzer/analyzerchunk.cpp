@@ -0,0 +1,50 @@
+#include "analyzer/analyzerchunk.h"
+
+#include "analyzer/constants.h"
+#include "util/sample.h"
+
+AnalyzerChunk::AnalyzerChunk()
+        : m_frameCount(0),
+          m_views(None),
+          m_pSamples(nullptr),
+          m_pStereoMix(nullptr),
+          m_stereoMix(mixxx::kAnalysisFramesPerChunk * mixxx::audio::ChannelCount::stereo()),
+          m_monoMix(mixxx::kAnalysisFramesPerChunk) {
+}
+
+void AnalyzerChunk::prepare(
+        const CSAMPLE* pSamples,
+        SINT sampleCount,
+        mixxx::audio::ChannelCount channelCount,
+        int views) {
+    DEBUG_ASSERT(channelCount.isValid());
+    DEBUG_ASSERT(sampleCount % channelCount == 0);
+    m_channelCount = channelCount;
+    m_frameCount = sampleCount / channelCount;
+    m_views = views;
+    m_pSamples = pSamples;
+    m_pStereoMix = nullptr;
+    VERIFY_OR_DEBUG_ASSERT(m_frameCount <= mixxx::kAnalysisFramesPerChunk) {
+        m_views = None;
+        return;
+    }
+
+    if (m_views & StereoMix) {
+        if (m_channelCount == mixxx::audio::ChannelCount::stereo()) {
+            m_pStereoMix = m_pSamples;
+        } else {
+            SampleUtil::mixMultichannelToStereo(
+                    m_stereoMix.data(),
+                    m_pSamples,
+                    m_frameCount,
+                    m_channelCount);
+            m_pStereoMix = m_stereoMix.data();
+        }
+    }
+    if ((m_views & MonoMix) == MonoMix) {
+        SampleUtil::mixMultichannelToMono(
+                m_monoMix.data(),
+                m_pStereoMix,
+                m_frameCount * mixxx::audio::ChannelCount::stereo());
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "audio/types.h"
+#include "util/assert.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// A chunk of decoded audio data together with derived views that are
+/// shared by all analyzers.
+///
+/// Many analyzers don't process the decoded samples as is, but a stereo
+/// mix of all stems or a mono downmix. These views are computed once per
+/// chunk by the AnalyzerThread before the chunk is handed over to the
+/// analyzers instead of repeating the same conversion in every analyzer
+/// or analyzer plugin. Only the views that are requested by at least one
+/// analyzer are computed.
+///
+/// The chunk is immutable while being processed by the analyzers and
+/// safe to be read from multiple threads concurrently.
+class AnalyzerChunk final {
+  public:
+    enum Views {
+        None = 0x00,
+        // All channels mixed down to stereo
+        StereoMix = 0x01,
+        // The stereo mix downmixed to mono
+        MonoMix = 0x02 | StereoMix,
+    };
+
+    AnalyzerChunk();
+
+    /// Reference the decoded samples and compute the requested views.
+    /// The decoded samples must stay valid until the chunk has been
+    /// processed by all analyzers.
+    void prepare(
+            const CSAMPLE* pSamples,
+            SINT sampleCount,
+            mixxx::audio::ChannelCount channelCount,
+            int views);
+
+    mixxx::audio::ChannelCount channelCount() const {
+        return m_channelCount;
+    }
+
+    SINT frameCount() const {
+        return m_frameCount;
+    }
+
+    /// The decoded samples with channelCount() interleaved channels
+    const CSAMPLE* samples() const {
+        return m_pSamples;
+    }
+    SINT sampleCount() const {
+        return m_frameCount * m_channelCount;
+    }
+
+    /// Interleaved stereo samples with 2 * frameCount() samples. Points
+    /// to the decoded samples if the source is stereo.
+    const CSAMPLE* stereoMix() const {
+        DEBUG_ASSERT(m_views & StereoMix);
+        return m_pStereoMix;
+    }
+
+    /// Mono samples with frameCount() samples
+    const CSAMPLE* monoMix() const {
+        DEBUG_ASSERT((m_views & MonoMix) == MonoMix);
+        return m_monoMix.data();
+    }
+
+  private:
+    mixxx::audio::ChannelCount m_channelCount;
+    SINT m_frameCount;
+    int m_views;
+    const CSAMPLE* m_pSamples;
+    const CSAMPLE* m_pStereoMix;
+
+    // Allocated upfront for the maximum chunk size
+    mixxx::SampleBuffer m_stereoMix;
+    mixxx::SampleBuffer m_monoMix;
+};
@@ -39,8 +39,6 @@ void AnalyzerGain::cleanup() {
 }
 
 bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
-    ScopedTimer t(QStringLiteral("AnalyzerGain::process()"));
-
     SINT numFrames = count / m_channelCount;
 
     const CSAMPLE* pGainInput = pIn;
@@ -65,6 +63,21 @@ bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
         return false;
     }
 
+    bool ret = processStereoSamples(pGainInput, numFrames);
+    if (pMixedChannel) {
+        SampleUtil::free(pMixedChannel);
+    }
+    return ret;
+}
+
+bool AnalyzerGain::processChunk(const AnalyzerChunk& chunk) {
+    // The shared stereo mix of all stems
+    return processStereoSamples(chunk.stereoMix(), chunk.frameCount());
+}
+
+bool AnalyzerGain::processStereoSamples(const CSAMPLE* pGainInput, SINT numFrames) {
+    ScopedTimer t(QStringLiteral("AnalyzerGain::process()"));
+
     if (numFrames > static_cast<SINT>(m_pLeftTempBuffer.size())) {
         m_pLeftTempBuffer.resize(numFrames);
         m_pRightTempBuffer.resize(numFrames);
@@ -75,12 +88,8 @@ bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
             numFrames);
     SampleUtil::applyGain(m_pLeftTempBuffer.data(), 32767, numFrames);
     SampleUtil::applyGain(m_pRightTempBuffer.data(), 32767, numFrames);
-    bool ret = m_pReplayGain->process(
+    return m_pReplayGain->process(
             m_pLeftTempBuffer.data(), m_pRightTempBuffer.data(), numFrames);
-    if (pMixedChannel) {
-        SampleUtil::free(pMixedChannel);
-    }
-    return ret;
 }
 
 void AnalyzerGain::storeResults(TrackPointer pTrack) {
@@ -28,10 +28,16 @@ class AnalyzerGain : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    int requiredChunkViews() const override {
+        return AnalyzerChunk::StereoMix;
+    }
+    bool processChunk(const AnalyzerChunk& chunk) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
+    bool processStereoSamples(const CSAMPLE* pIn, SINT numFrames);
+
     ReplayGainSettings m_rgSettings;
     std::vector<CSAMPLE> m_pLeftTempBuffer;
     std::vector<CSAMPLE> m_pRightTempBuffer;
@@ -208,6 +208,31 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
     return ret;
 }
 
+int AnalyzerKey::requiredChunkViews() const {
+    if (!m_pPlugin || !m_pPlugin->supportsMonoSamples()) {
+        return AnalyzerChunk::None;
+    }
+    if (m_channelCount == mixxx::audio::ChannelCount::stem() &&
+            m_keySettings.getStemStrategy() == KeyDetectionSettings::StemStrategy::Enforced) {
+        // The drum stem is excluded, see processSamples()
+        return AnalyzerChunk::None;
+    }
+    return AnalyzerChunk::MonoMix;
+}
+
+bool AnalyzerKey::processChunk(const AnalyzerChunk& chunk) {
+    if (requiredChunkViews() != AnalyzerChunk::MonoMix) {
+        return processSamples(chunk.samples(), chunk.sampleCount());
+    }
+
+    m_currentFrame += chunk.frameCount();
+    if (m_currentFrame > m_maxFramesToProcess) {
+        return true; // silently ignore remaining samples
+    }
+
+    return m_pPlugin->processMonoSamples(chunk.monoMix(), chunk.frameCount());
+}
+
 void AnalyzerKey::cleanup() {
     m_pPlugin.reset();
 }
@@ -23,6 +23,8 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    int requiredChunkViews() const override;
+    bool processChunk(const AnalyzerChunk& chunk) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
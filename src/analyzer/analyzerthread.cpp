@@ -11,6 +11,7 @@
 #include "analyzer/constants.h"
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
+#include "preferences/waveformsettings.h"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -60,12 +61,14 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalyzerWorkerPool> pWorkerPool) {
     return Pointer(new AnalyzerThread(
                            id,
                            dbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           std::move(pWorkerPool)),
             deleteAnalyzerThread);
 }
 
@@ -73,7 +76,8 @@ AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalyzerWorkerPool> pWorkerPool)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
             (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
@@ -81,7 +85,10 @@ AnalyzerThread::AnalyzerThread(
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
+          m_pWorkerPool(std::move(pWorkerPool)),
           m_nextTrack(2), // minimum capacity
+          m_analyzerTasksPending(false),
+          m_chunkViews(AnalyzerChunk::None),
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
@@ -101,7 +108,14 @@ void AnalyzerThread::doRun() {
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        // Full resolution waveforms of batch analysis are only useful if
+        // they are cached in the database
+        const auto waveformMode = (m_modeFlags & AnalyzerModeFlags::LowPriority) &&
+                        !WaveformSettings(m_pConfig).waveformCachingEnabled()
+                ? AnalyzerWaveform::Mode::SummaryOnly
+                : AnalyzerWaveform::Mode::Full;
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(
+                m_pConfig, dbConnection, waveformMode)));
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
         m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
@@ -118,6 +132,16 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    // The vector of analyzers must not be modified while the tasks exist
+    m_analyzerTasks.reserve(m_analyzers.size());
+    for (auto&& analyzer : m_analyzers) {
+        m_analyzerTasks.push_back(std::make_unique<AnalyzerChunkTask>(&analyzer));
+    }
+    if (m_pWorkerPool && m_pWorkerPool->isEnabled()) {
+        // Decoding continues while the analyzers process the previous chunk
+        mixxx::SampleBuffer(mixxx::kAnalysisSamplesPerChunk).swap(m_pendingSampleBuffer);
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -158,6 +182,11 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
+            // Only compute the views that are actually needed
+            m_chunkViews = AnalyzerChunk::None;
+            for (const auto& analyzer : m_analyzers) {
+                m_chunkViews |= analyzer.requiredChunkViews();
+            }
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
@@ -187,6 +216,8 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    DEBUG_ASSERT(!m_analyzerTasksPending);
+    m_analyzerTasks.clear();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -238,6 +269,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
         if (isStopping()) {
+            waitForAnalyzerTasks();
             return AnalysisResult::Cancelled;
         }
 
@@ -294,16 +326,19 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         sleepWhileSuspended();
         if (isStopping()) {
+            waitForAnalyzerTasks();
             return AnalysisResult::Cancelled;
         }
 
-        // 2nd: step: Analyze chunk of decoded audio data
+        // 2nd: step: Analyze chunk of decoded audio data. The analyzers
+        // must have finished the previous chunk before receiving the next
+        // one. Meanwhile the next chunk is decoded into the other buffer.
+        waitForAnalyzerTasks();
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
-            }
+            submitAnalyzerTasks(
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength(),
+                    audioSource->getSignalInfo().getChannelCount());
         }
 
         // Don't check again for paused/stopped again and simply finish
@@ -327,10 +362,39 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             emitBusyProgress(kAnalyzerProgressUnknown);
         }
     }
+    waitForAnalyzerTasks();
 
     return AnalysisResult::Finished;
 }
 
+void AnalyzerThread::submitAnalyzerTasks(
+        const CSAMPLE* pIn,
+        SINT count,
+        mixxx::audio::ChannelCount channelCount) {
+    DEBUG_ASSERT(!m_analyzerTasksPending);
+    // The conversions are done once for all analyzers
+    m_chunk.prepare(pIn, count, channelCount, m_chunkViews);
+    for (auto&& pTask : m_analyzerTasks) {
+        pTask->submit(m_pWorkerPool.get(), &m_chunk);
+    }
+    m_analyzerTasksPending = true;
+    if (m_pendingSampleBuffer.size() > 0) {
+        // The submitted chunk remains in use until the analyzers are
+        // done. Continue decoding into the other buffer.
+        m_sampleBuffer.swap(m_pendingSampleBuffer);
+    }
+}
+
+void AnalyzerThread::waitForAnalyzerTasks() {
+    if (!m_analyzerTasksPending) {
+        return;
+    }
+    for (auto&& pTask : m_analyzerTasks) {
+        pTask->waitReady(m_pWorkerPool.get());
+    }
+    m_analyzerTasksPending = false;
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
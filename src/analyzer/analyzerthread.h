@@ -7,6 +7,7 @@
 #include "analyzer/analyzer.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
+#include "analyzer/analyzerworkerpool.h"
 #include "preferences/usersettings.h"
 #include "rigtorp/SPSCQueue.h"
 #include "sources/audiosource.h"
@@ -59,13 +60,15 @@ class AnalyzerThread : public WorkerThread {
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalyzerWorkerPool> pWorkerPool = nullptr);
 
     /*private*/ AnalyzerThread(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalyzerWorkerPool> pWorkerPool);
     ~AnalyzerThread() override = default;
 
     int id() const {
@@ -100,6 +103,8 @@ class AnalyzerThread : public WorkerThread {
     const mixxx::DbConnectionPoolPtr m_dbConnectionPool;
     const UserSettingsPointer m_pConfig;
     const AnalyzerModeFlags m_modeFlags;
+    // Shared with all other analyzer threads of the scheduler, optional
+    const std::shared_ptr<AnalyzerWorkerPool> m_pWorkerPool;
 
     /////////////////////////////////////////////////////////////////////////
     // Thread-safe atomic values
@@ -118,7 +123,19 @@ class AnalyzerThread : public WorkerThread {
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    // One task per analyzer for processing the current chunk
+    std::vector<std::unique_ptr<AnalyzerChunkTask>> m_analyzerTasks;
+    bool m_analyzerTasksPending;
+
+    // The current chunk with all views that are needed by the active
+    // analyzers of the current track
+    AnalyzerChunk m_chunk;
+    int m_chunkViews;
+
+    // The next chunk is decoded into m_sampleBuffer while the analyzers
+    // are still busy with the previous chunk in m_pendingSampleBuffer
     mixxx::SampleBuffer m_sampleBuffer;
+    mixxx::SampleBuffer m_pendingSampleBuffer;
 
     std::optional<AnalyzerTrack> m_currentTrack;
 
@@ -134,6 +151,14 @@ class AnalyzerThread : public WorkerThread {
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
+    // Hand over a decoded chunk to all analyzers
+    void submitAnalyzerTasks(
+            const CSAMPLE* pIn,
+            SINT count,
+            mixxx::audio::ChannelCount channelCount);
+    // Blocks until all analyzers have processed the submitted chunk
+    void waitForAnalyzerTasks();
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
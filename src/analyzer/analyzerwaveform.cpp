@@ -5,6 +5,7 @@
 #include "engine/filters/enginefilterbessel4.h"
 #include "track/track.h"
 #include "util/logger.h"
+#include "util/samplesimd.h"
 #include "waveform/waveformfactory.h"
 
 namespace {
@@ -19,8 +20,10 @@ constexpr double kMidHighFreqHz = 4000.0;
 
 AnalyzerWaveform::AnalyzerWaveform(
         UserSettingsPointer pConfig,
-        const QSqlDatabase& dbConnection)
+        const QSqlDatabase& dbConnection,
+        Mode mode)
         : m_analysisDao(pConfig),
+          m_mode(mode),
           m_waveformData(nullptr),
           m_waveformSummaryData(nullptr),
           m_stride(0, 0, 0),
@@ -65,21 +68,30 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
     int stemCount = channelCount == mixxx::kAnalysisChannels
             ? 0
             : channelCount / mixxx::kAnalysisChannels;
-    m_waveform = WaveformPointer(new Waveform(
-            sampleRate, frameLength, mainWaveformSampleRate, -1, stemCount));
     m_waveformSummary = WaveformPointer(new Waveform(
             sampleRate, frameLength, mainWaveformSampleRate, summaryWaveformSamples, stemCount));
-
-    // Now, that the Waveform memory is initialized, we can set set them to
-    // the TIO. Be aware that other threads of Mixxx can touch them from
-    // now.
-    track.getTrack()->setWaveform(m_waveform);
+    double audioVisualRatio;
+    if (m_mode == Mode::SummaryOnly) {
+        // The strides of the summary are still averaged over the strides
+        // of the (virtual) full resolution waveform
+        audioVisualRatio = Waveform::computeAudioVisualRatio(
+                sampleRate, frameLength, mainWaveformSampleRate, -1);
+        m_waveform.clear();
+        m_waveformData = nullptr;
+    } else {
+        m_waveform = WaveformPointer(new Waveform(
+                sampleRate, frameLength, mainWaveformSampleRate, -1, stemCount));
+        audioVisualRatio = m_waveform->getAudioVisualRatio();
+        // Now, that the Waveform memory is initialized, we can set set them to
+        // the TIO. Be aware that other threads of Mixxx can touch them from
+        // now.
+        track.getTrack()->setWaveform(m_waveform);
+        m_waveformData = m_waveform->data();
+    }
     track.getTrack()->setWaveformSummary(m_waveformSummary);
-
-    m_waveformData = m_waveform->data();
     m_waveformSummaryData = m_waveformSummary->data();
 
-    m_stride = WaveformStride(m_waveform->getAudioVisualRatio(),
+    m_stride = WaveformStride(audioVisualRatio,
             m_waveformSummary->getAudioVisualRatio(),
             stemCount);
 
@@ -111,6 +123,11 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     bool missingWaveform = pTrackWaveform.isNull();
     bool missingWavesummary = pTrackWaveformSummary.isNull();
 
+    if (m_mode == Mode::SummaryOnly) {
+        // Generated on demand when the track is loaded
+        missingWaveform = false;
+    }
+
     if (trackId.isValid() && (missingWaveform || missingWavesummary)) {
         QList<AnalysisDao::AnalysisInfo> analyses =
                 m_analysisDao.getAnalysesForTrack(trackId);
@@ -122,9 +139,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
 
             if (analysis.type == AnalysisDao::TYPE_WAVEFORM) {
                 vc = WaveformFactory::waveformVersionToVersionClass(analysis.version);
-                if (missingWaveform && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveform = ConstWaveformPointer(
-                            WaveformFactory::loadWaveformFromAnalysis(analysis));
+                if (missingWaveform &&
+                        (vc == WaveformFactory::VC_USE || vc == WaveformFactory::VC_CONVERT)) {
+                    pLoadedTrackWaveform = loadWaveformFromAnalysis(analysis, vc);
                     missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -133,9 +150,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
             }
             if (analysis.type == AnalysisDao::TYPE_WAVESUMMARY) {
                 vc = WaveformFactory::waveformSummaryVersionToVersionClass(analysis.version);
-                if (missingWavesummary && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveformSummary = ConstWaveformPointer(
-                            WaveformFactory::loadWaveformFromAnalysis(analysis));
+                if (missingWavesummary &&
+                        (vc == WaveformFactory::VC_USE || vc == WaveformFactory::VC_CONVERT)) {
+                    pLoadedTrackWaveformSummary = loadWaveformFromAnalysis(analysis, vc);
                     missingWavesummary = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -149,7 +166,7 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     // If the waveform was generated without stem information but the track has
     // some, or the waveform contains stem information but the track doesn't
     // have any, we need to regenerate the waveform.
-    if (!missingWaveform &&
+    if (m_mode == Mode::Full && !missingWaveform &&
             ((!pTrackWaveform.isNull() &&
                      pTrackWaveform->hasStem() != isStemTrack) ||
                     (!pLoadedTrackWaveform.isNull() &&
@@ -172,6 +189,20 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     return true;
 }
 
+ConstWaveformPointer AnalyzerWaveform::loadWaveformFromAnalysis(
+        const AnalysisDao::AnalysisInfo& analysis,
+        WaveformFactory::VersionClass vc) const {
+    auto pWaveform = WaveformPointer(WaveformFactory::loadWaveformFromAnalysis(analysis));
+    if (vc == WaveformFactory::VC_CONVERT && pWaveform->getDataSize() > 0) {
+        // Transparently migrate to the current encoding that loads faster
+        if (WaveformFactory::convertAnalysis(&m_analysisDao, analysis, pWaveform.data())) {
+            kLogger.debug() << "Converted analysis" << analysis.analysisId
+                            << "from version" << analysis.version;
+        }
+    }
+    return pWaveform;
+}
+
 void AnalyzerWaveform::createFilters(mixxx::audio::SampleRate sampleRate) {
     // m_filter[Low] = new EngineFilterButterworth8Low(sampleRate, kLowMidFreqHz);
     // m_filter[Mid] = new EngineFilterButterworth8Band(sampleRate, kLowMidFreqHz, kMidHighFreqHz);
@@ -195,16 +226,7 @@ void AnalyzerWaveform::destroyFilters() {
 }
 
 bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
-    VERIFY_OR_DEBUG_ASSERT(m_waveform) {
-        return false;
-    }
-    VERIFY_OR_DEBUG_ASSERT(m_waveformSummary) {
-        return false;
-    }
-
     SINT numFrames = count / m_channelCount;
-    count = numFrames * mixxx::audio::ChannelCount::stereo();
-    int stemCount = 0;
 
     const CSAMPLE* pWaveformInput = pIn;
     CSAMPLE* pMixedChannel = nullptr;
@@ -212,15 +234,40 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
     if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
         DEBUG_ASSERT(0 == m_channelCount % mixxx::audio::ChannelCount::stereo());
 
-        pMixedChannel = SampleUtil::alloc(count);
+        pMixedChannel = SampleUtil::alloc(numFrames * mixxx::audio::ChannelCount::stereo());
         VERIFY_OR_DEBUG_ASSERT(pMixedChannel) {
             return false;
         }
         SampleUtil::mixMultichannelToStereo(pMixedChannel, pIn, numFrames, m_channelCount);
-        stemCount = m_channelCount / mixxx::audio::ChannelCount::stereo();
         pWaveformInput = pMixedChannel;
     }
 
+    bool ret = processStereoSamples(pWaveformInput, pIn, numFrames);
+    if (pMixedChannel) {
+        SampleUtil::free(pMixedChannel);
+    }
+    return ret;
+}
+
+bool AnalyzerWaveform::processChunk(const AnalyzerChunk& chunk) {
+    // The shared stereo mix of all stems
+    return processStereoSamples(chunk.stereoMix(), chunk.samples(), chunk.frameCount());
+}
+
+bool AnalyzerWaveform::processStereoSamples(
+        const CSAMPLE* pWaveformInput, const CSAMPLE* pIn, SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(m_waveform || m_mode == Mode::SummaryOnly) {
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_waveformSummary) {
+        return false;
+    }
+
+    const SINT count = numFrames * mixxx::audio::ChannelCount::stereo();
+    const int stemCount = m_channelCount > mixxx::audio::ChannelCount::stereo()
+            ? m_channelCount / mixxx::audio::ChannelCount::stereo()
+            : 0;
+
     // This should only append once if count is constant
     if (count > static_cast<SINT>(m_buffers[0].size())) {
         m_buffers[Low].resize(count);
@@ -232,56 +279,36 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
     m_filter[Mid]->process(pWaveformInput, &m_buffers[Mid][0], count);
     m_filter[High]->process(pWaveformInput, &m_buffers[High][0], count);
 
-    m_waveform->setSaveState(Waveform::SaveState::NotSaved);
+    if (m_waveform) {
+        m_waveform->setSaveState(Waveform::SaveState::NotSaved);
+    }
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
 
-    for (SINT i = 0; i < count; i += 2) {
-        // Take max value, not average of data
-        CSAMPLE cover[2] = {fabs(pWaveformInput[i]), fabs(pWaveformInput[i + 1])};
-        CSAMPLE clow[2] = {fabs(m_buffers[Low][i]), fabs(m_buffers[Low][i + 1])};
-        CSAMPLE cmid[2] = {fabs(m_buffers[Mid][i]), fabs(m_buffers[Mid][i + 1])};
-        CSAMPLE chigh[2] = {fabs(m_buffers[High][i]), fabs(m_buffers[High][i + 1])};
-
-        // This is for if you want to experiment with averaging instead of
-        // maxing.
-        // m_stride.m_overallData[Right] += buffer[i]*buffer[i];
-        // m_stride.m_overallData[Left] += buffer[i + 1]*buffer[i + 1];
-        // m_stride.m_filteredData[Right][Low] += m_buffers[Low][i]*m_buffers[Low][i];
-        // m_stride.m_filteredData[Left][Low] += m_buffers[Low][i + 1]*m_buffers[Low][i + 1];
-        // m_stride.m_filteredData[Right][Mid] += m_buffers[Mid][i]*m_buffers[Mid][i];
-        // m_stride.m_filteredData[Left][Mid] += m_buffers[Mid][i + 1]*m_buffers[Mid][i + 1];
-        // m_stride.m_filteredData[Right][High] += m_buffers[High][i]*m_buffers[High][i];
-        // m_stride.m_filteredData[Left][High] += m_buffers[High][i + 1]*m_buffers[High][i + 1];
-
-        // Record the max across this stride.
-        storeIfGreater(&m_stride.m_overallData[Left], cover[Left]);
-        storeIfGreater(&m_stride.m_overallData[Right], cover[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Low], clow[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Low], clow[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Mid], cmid[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Mid], cmid[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][High], chigh[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][High], chigh[Right]);
-
-        for (int s = 0; s < stemCount; s++) {
-            CSAMPLE cstem[2] = {
-                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels]),
-                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels +
-                            1])};
-            storeIfGreater(&m_stride.m_stemData[Left][s], cstem[Left]);
-            storeIfGreater(&m_stride.m_stemData[Right][s], cstem[Right]);
-        }
-
-        m_stride.m_position++;
+    SINT frame = 0;
+    while (frame < numFrames) {
+        // Accumulate all frames up to the end of the next stride at once
+        const SINT runFrames = math_min(numFrames - frame,
+                static_cast<SINT>(math_min(
+                        WaveformStride::framesUntilStrideEnd(
+                                m_stride.m_position, m_stride.m_length),
+                        WaveformStride::framesUntilStrideEnd(
+                                m_stride.m_position, m_stride.m_averageLength))));
+        accumulatePeaks(pWaveformInput, pIn, frame, runFrames, stemCount);
+        frame += runFrames;
+        m_stride.m_position += static_cast<int>(runFrames);
 
         if (fmod(m_stride.m_position, m_stride.m_length) < 1) {
-            VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
-                qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
-                return false;
+            if (m_waveform) {
+                VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
+                    qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
+                    return false;
+                }
+                m_stride.store(m_waveformData + m_currentStride);
+                m_currentStride += ChannelCount;
+                m_waveform->setCompletion(m_currentStride);
+            } else {
+                m_stride.store(nullptr);
             }
-            m_stride.store(m_waveformData + m_currentStride);
-            m_currentStride += ChannelCount;
-            m_waveform->setCompletion(m_currentStride);
         }
 
         if (fmod(m_stride.m_position, m_stride.m_averageLength) < 1) {
@@ -308,12 +335,39 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
 
     //kLogger.debug() << "process - m_waveform->getCompletion()" << m_waveform->getCompletion() << "off" << m_waveform->getDataSize();
     //kLogger.debug() << "process - m_waveformSummary->getCompletion()" << m_waveformSummary->getCompletion() << "off" << m_waveformSummary->getDataSize();
-    if (pMixedChannel) {
-        SampleUtil::free(pMixedChannel);
-    }
     return true;
 }
 
+void AnalyzerWaveform::accumulatePeaks(const CSAMPLE* pWaveformInput,
+        const CSAMPLE* pIn,
+        SINT firstFrame,
+        SINT numFrames,
+        int stemCount) {
+    // Record the max across this stride. This is for if you want to
+    // experiment with averaging instead of maxing:
+    // m_stride.m_overallData[Right] += buffer[i]*buffer[i];
+    // m_stride.m_overallData[Left] += buffer[i + 1]*buffer[i + 1];
+    const SINT offset = firstFrame * mixxx::audio::ChannelCount::stereo();
+    mixxx::simd::peakAbsStereo(pWaveformInput + offset,
+            numFrames,
+            &m_stride.m_overallData[Left],
+            &m_stride.m_overallData[Right]);
+    for (int f = 0; f < FilterCount; ++f) {
+        mixxx::simd::peakAbsStereo(&m_buffers[f][offset],
+                numFrames,
+                &m_stride.m_filteredData[Left][f],
+                &m_stride.m_filteredData[Right][f]);
+    }
+
+    for (SINT i = firstFrame; i < firstFrame + numFrames; ++i) {
+        for (int s = 0; s < stemCount; s++) {
+            const CSAMPLE* pStem = pIn + i * m_channelCount + s * mixxx::kAnalysisChannels;
+            storeIfGreater(&m_stride.m_stemData[Left][s], fabs(pStem[0]));
+            storeIfGreater(&m_stride.m_stemData[Right][s], fabs(pStem[1]));
+        }
+    }
+}
+
 void AnalyzerWaveform::cleanup() {
     m_waveform.clear();
     m_waveformData = nullptr;
@@ -329,7 +383,9 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
     }
-    tio->setWaveform(m_waveform);
+    if (m_mode == Mode::Full) {
+        tio->setWaveform(m_waveform);
+    }
 
     // Force completion to waveform size
     if (m_waveformSummary) {
@@ -8,6 +8,7 @@
 #include "util/performancetimer.h"
 #include "util/sample.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformfactory.h"
 
 //NOTS vrince some test to segment sound, to apply color in the waveform
 //#define TEST_HEAT_MAP
@@ -64,8 +65,27 @@ struct WaveformStride {
         }
     }
 
+    // The number of frames until the position at which the next stride of
+    // the given length is completed, i.e. fmod(position, length) < 1.
+    static int framesUntilStrideEnd(int position, double length) {
+        if (length <= 1) {
+            return 1;
+        }
+        int end = static_cast<int>(std::ceil((std::floor(position / length) + 1) * length));
+        // Correct rounding errors of the floating point estimate
+        while (end > position + 1 && std::fmod(end - 1, length) < 1) {
+            --end;
+        }
+        while (end <= position || std::fmod(end, length) >= 1) {
+            ++end;
+        }
+        return end - position;
+    }
+
+    // Completes the current stride. The data is only accumulated for the
+    // summary if data is null.
     inline void store(WaveformData* data) {
-        for (int i = 0; i < ChannelCount; ++i) {
+        for (int i = 0; data && i < ChannelCount; ++i) {
             WaveformData& datum = *(data + i);
             datum.filtered.all = static_cast<unsigned char>(math_min(255.0,
                     m_postScaleConversion * scaleSignal(m_overallData[i]) + 0.5));
@@ -151,9 +171,20 @@ struct WaveformStride {
 
 class AnalyzerWaveform : public Analyzer {
   public:
+    enum class Mode {
+        // Generate both the waveform and the waveform summary
+        Full,
+        // Only generate the waveform summary while streaming through the
+        // track. The full resolution waveform is never allocated. Used for
+        // batch analysis if waveforms are not cached in the database and
+        // the full resolution waveform would be discarded anyway.
+        SummaryOnly,
+    };
+
     AnalyzerWaveform(
             UserSettingsPointer pConfig,
-            const QSqlDatabase& dbConnection);
+            const QSqlDatabase& dbConnection,
+            Mode mode = Mode::Full);
     ~AnalyzerWaveform() override;
 
     bool initialize(const AnalyzerTrack& track,
@@ -161,11 +192,26 @@ class AnalyzerWaveform : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* buffer, SINT count) override;
+    int requiredChunkViews() const override {
+        return AnalyzerChunk::StereoMix;
+    }
+    bool processChunk(const AnalyzerChunk& chunk) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
     bool shouldAnalyze(TrackPointer tio) const;
+    ConstWaveformPointer loadWaveformFromAnalysis(
+            const AnalysisDao::AnalysisInfo& analysis,
+            WaveformFactory::VersionClass vc) const;
+
+    // pWaveformInput contains the stereo mix of pIn
+    bool processStereoSamples(const CSAMPLE* pWaveformInput, const CSAMPLE* pIn, SINT numFrames);
+    void accumulatePeaks(const CSAMPLE* pWaveformInput,
+            const CSAMPLE* pIn,
+            SINT firstFrame,
+            SINT numFrames,
+            int stemCount);
 
     void storeCurrentStridePower();
     void resetCurrentStride();
@@ -175,6 +221,7 @@ class AnalyzerWaveform : public Analyzer {
     void storeIfGreater(float* pDest, float source);
 
     mutable AnalysisDao m_analysisDao;
+    const Mode m_mode;
 
     WaveformPointer m_waveform;
     WaveformPointer m_waveformSummary;
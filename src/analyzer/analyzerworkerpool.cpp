@@ -0,0 +1,73 @@
+#include "analyzer/analyzerworkerpool.h"
+
+#include <QThread>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("AnalyzerWorkerPool");
+
+const ConfigKey kAnalyzerMultiThreadingConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("analyzer_multithreading"));
+
+} // anonymous namespace
+
+AnalyzerChunkTask::AnalyzerChunkTask(AnalyzerWithState* pAnalyzer)
+        : QRunnable(),
+          m_pAnalyzer(pAnalyzer),
+          m_pChunk(nullptr),
+          m_completedSema(0) {
+    DEBUG_ASSERT(m_pAnalyzer);
+    // Tasks are owned by the AnalyzerThread and reused for every chunk.
+    // This is also required for taking them back from the pool.
+    setAutoDelete(false);
+}
+
+void AnalyzerChunkTask::submit(AnalyzerWorkerPool* pPool, const AnalyzerChunk* pChunk) {
+    DEBUG_ASSERT(m_completedSema.available() == 0);
+    DEBUG_ASSERT(pChunk);
+    m_pChunk = pChunk;
+    if (pPool && pPool->isEnabled()) {
+        pPool->start(this);
+    } else {
+        run();
+    }
+}
+
+void AnalyzerChunkTask::waitReady(AnalyzerWorkerPool* pPool) {
+    if (pPool && pPool->tryTake(this)) {
+        run();
+    }
+    m_completedSema.acquire();
+}
+
+void AnalyzerChunkTask::run() {
+    m_pAnalyzer->processChunk(*m_pChunk);
+    m_completedSema.release();
+}
+
+AnalyzerWorkerPool::AnalyzerWorkerPool(
+        UserSettingsPointer pConfig,
+        QThread::Priority threadPriority)
+        : QThreadPool() {
+    // Opt-in: The workers compete with the audio engine for the cores
+    const bool multiThreaded = pConfig &&
+            pConfig->getValue(kAnalyzerMultiThreadingConfigKey, false);
+    // The AnalyzerThreads only help out with their own chunks, so
+    // all cores are available for the workers of the pool.
+    const int numWorkers = (multiThreaded && QThread::idealThreadCount() > 1)
+            ? QThread::idealThreadCount()
+            : 0;
+    kLogger.debug()
+            << "Using"
+            << numWorkers
+            << "worker threads";
+    setThreadPriority(threadPriority);
+    setMaxThreadCount(numWorkers);
+}
+
+AnalyzerWorkerPool::~AnalyzerWorkerPool() {
+    waitForDone();
+}
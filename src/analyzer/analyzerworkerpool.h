@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include "analyzer/analyzer.h"
+#include "preferences/usersettings.h"
+
+class AnalyzerWorkerPool;
+
+/// Processes a single chunk of decoded audio data with one analyzer.
+///
+/// Each AnalyzerThread owns one task per analyzer and reuses it for every
+/// chunk. An analyzer must process the chunks of a track in order, so a
+/// task is only submitted again after waitReady() has returned.
+class AnalyzerChunkTask : public QRunnable {
+  public:
+    explicit AnalyzerChunkTask(AnalyzerWithState* pAnalyzer);
+    ~AnalyzerChunkTask() override = default;
+
+    /// Queue the task in the pool or, if there are no workers, run it
+    /// directly on the calling thread. Every call must be followed by a
+    /// call to waitReady().
+    void submit(AnalyzerWorkerPool* pPool, const AnalyzerChunk* pChunk);
+
+    /// Wait for the previously submitted task to complete. A task that
+    /// has not been picked up by a worker yet is taken back and run by
+    /// the calling thread instead of waiting idle.
+    void waitReady(AnalyzerWorkerPool* pPool);
+
+    void run() override;
+
+  private:
+    AnalyzerWithState* const m_pAnalyzer;
+    const AnalyzerChunk* m_pChunk;
+
+    // Released once the chunk has been processed
+    QSemaphore m_completedSema;
+};
+
+/// AnalyzerWorkerPool is shared by all AnalyzerThreads of a
+/// TrackAnalysisScheduler. The analyzers of a track are independent from
+/// each other and process each chunk concurrently on the workers of the
+/// pool while the AnalyzerThread already decodes the next chunk.
+///
+/// All AnalyzerThreads feed the same queue. Workers that become idle when
+/// most tracks of a batch are finished pick up the chunks of the remaining
+/// long tracks instead of leaving a single thread to do all the work.
+///
+/// The pool is disabled by default and needs to be enabled with
+/// [App],analyzer_multithreading. Without workers all analyzers are run
+/// sequentially by the AnalyzerThread. The workers run with the same
+/// priority as the AnalyzerThreads.
+class AnalyzerWorkerPool : public QThreadPool {
+  public:
+    AnalyzerWorkerPool(
+            UserSettingsPointer pConfig,
+            QThread::Priority threadPriority);
+    ~AnalyzerWorkerPool() override;
+
+    bool isEnabled() const {
+        return maxThreadCount() > 0;
+    }
+};
@@ -32,6 +32,11 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, SINT iLen) override;
+
+    bool supportsMonoSamples() const override {
+        return true;
+    }
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
@@ -3,6 +3,7 @@
 #include <soundtouch/BPMDetect.h>
 
 #include "analyzer/constants.h"
+#include "util/sample.h"
 
 namespace mixxx {
 
@@ -15,7 +16,8 @@ AnalyzerSoundTouchBeats::~AnalyzerSoundTouchBeats() {
 
 bool AnalyzerSoundTouchBeats::initialize(mixxx::audio::SampleRate sampleRate) {
     m_resultBpm = mixxx::Bpm();
-    m_pSoundTouch = std::make_unique<soundtouch::BPMDetect>(2, sampleRate);
+    // The signal is analyzed as a mono downmix
+    m_pSoundTouch = std::make_unique<soundtouch::BPMDetect>(1, sampleRate);
     return true;
 }
 
@@ -26,13 +28,19 @@ bool AnalyzerSoundTouchBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
     // We analyze a mono mixdown of the signal since we don't think stereo does
     // us any good.
-
-    CSAMPLE* pDownmix = m_downmixBuffer.data();
-    for (int i = 0; i < iLen / 2; i += 2) {
-        pDownmix[i] = (pIn[i * 2] + pIn[i * 2 + 1]) * 0.5f;
+    const SINT numFrames = iLen / kAnalysisChannels;
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_downmixBuffer.size()) {
+        return false;
     }
+    SampleUtil::mixMultichannelToMono(m_downmixBuffer.data(), pIn, iLen);
+    return processMonoSamples(m_downmixBuffer.data(), numFrames);
+}
 
-    m_pSoundTouch->inputSamples(pIn, iLen / 2);
+bool AnalyzerSoundTouchBeats::processMonoSamples(const CSAMPLE* pIn, SINT iLen) {
+    if (!m_pSoundTouch) {
+        return false;
+    }
+    m_pSoundTouch->inputSamples(pIn, iLen);
     return true;
 }
 
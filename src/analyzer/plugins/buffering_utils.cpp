@@ -20,7 +20,11 @@ bool DownmixAndOverlapHelper::initialize(size_t windowSize,
 
 bool DownmixAndOverlapHelper::processStereoSamples(const CSAMPLE* pInput, size_t inputStereoSamples) {
     const size_t numInputFrames = inputStereoSamples / 2;
-    return processInner(pInput, numInputFrames);
+    return processInner(Input::Stereo, pInput, numInputFrames);
+}
+
+bool DownmixAndOverlapHelper::processMonoSamples(const CSAMPLE* pInput, size_t inputMonoSamples) {
+    return processInner(Input::Mono, pInput, inputMonoSamples);
 }
 
 bool DownmixAndOverlapHelper::finalize() {
@@ -31,11 +35,11 @@ bool DownmixAndOverlapHelper::finalize() {
     // instead of "m_windowSize / 2 - m_stepSize"
     size_t framesToFillWindow = m_windowSize - m_bufferWritePosition;
     size_t numInputFrames = math_max(framesToFillWindow, m_windowSize / 2 - 1);
-    return processInner(nullptr, numInputFrames);
+    return processInner(Input::Silence, nullptr, numInputFrames);
 }
 
 bool DownmixAndOverlapHelper::processInner(
-        const CSAMPLE* pInput, size_t numInputFrames) {
+        Input input, const CSAMPLE* pInput, size_t numInputFrames) {
     size_t inRead = 0;
     double* pDownmix = m_buffer.data();
 
@@ -44,7 +48,8 @@ bool DownmixAndOverlapHelper::processInner(
         DEBUG_ASSERT(m_bufferWritePosition <= m_windowSize);
         size_t writeAvailable = m_windowSize - m_bufferWritePosition;
         size_t numFrames = math_min(readAvailable, writeAvailable);
-        if (pInput) {
+        switch (input) {
+        case Input::Stereo:
             for (size_t i = 0; i < numFrames; ++i) {
                 // We analyze a mono downmix of the signal since we don't think
                 // stereo does us any good.
@@ -52,12 +57,19 @@ bool DownmixAndOverlapHelper::processInner(
                                                               pInput[(inRead + i) * 2 + 1]) *
                         0.5;
             }
-        } else {
+            break;
+        case Input::Mono:
+            for (size_t i = 0; i < numFrames; ++i) {
+                pDownmix[m_bufferWritePosition + i] = pInput[inRead + i];
+            }
+            break;
+        case Input::Silence:
             // we are in the finalize call. Add silence to
             // complete samples left in th buffer.
             for (size_t i = 0; i < numFrames; ++i) {
                 pDownmix[m_bufferWritePosition + i] = 0;
             }
+            break;
         }
         m_bufferWritePosition += numFrames;
         inRead += numFrames;
@@ -25,10 +25,22 @@ class DownmixAndOverlapHelper {
             const CSAMPLE* pInput,
             size_t inputStereoSamples);
 
+    // Frames a signal that has already been downmixed to mono,
+    // e.g. the shared mono view of an AnalyzerChunk.
+    bool processMonoSamples(
+            const CSAMPLE* pInput,
+            size_t inputMonoSamples);
+
     bool finalize();
 
   private:
-    bool processInner(const CSAMPLE* pInput, size_t numInputFrames);
+    enum class Input {
+        Stereo,
+        Mono,
+        Silence,
+    };
+
+    bool processInner(Input input, const CSAMPLE* pInput, size_t numInputFrames);
 
     std::vector<double> m_buffer;
     // The window size in frames.
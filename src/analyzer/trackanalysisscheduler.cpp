@@ -70,6 +70,14 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 << "worker threads. Priority: "
                 << (modeFlags & AnalyzerModeFlags::LowPriority ? "low" : "normal");
     }
+    // The analyzers of all worker threads share a single pool. Long
+    // tracks that are still analyzed at the end of a batch will then
+    // occupy all cores instead of just a single one.
+    const auto pWorkerPool = std::make_shared<AnalyzerWorkerPool>(
+            pConfig,
+            modeFlags & AnalyzerModeFlags::LowPriority
+                    ? QThread::LowPriority
+                    : QThread::InheritPriority);
     // 1st pass: Create worker threads
     m_workers.reserve(numWorkerThreads);
     for (int threadId = 0; threadId < numWorkerThreads; ++threadId) {
@@ -77,7 +85,8 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 threadId,
                 pDbConnectionPool,
                 pConfig,
-                modeFlags));
+                modeFlags,
+                pWorkerPool));
         connect(m_workers.back().thread(),
                 &AnalyzerThread::progress,
                 this,
@@ -2,6 +2,7 @@
 
 #include "control/controlobject.h"
 #include "moc_control.cpp"
+#include "util/performancetimer.h"
 #include "util/stat.h"
 
 namespace {
@@ -38,8 +39,9 @@ ControlDoublePrivate::ControlDoublePrivate()
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           // default CO is read only
           m_confirmRequired(true),
-          m_kbdRepeatable(false) {
-    m_value.setValue(0.0);
+          m_kbdRepeatable(false),
+          m_pValue(&m_value) {
+    m_pValue->setValue(0.0);
 }
 
 ControlDoublePrivate::ControlDoublePrivate(
@@ -58,7 +60,9 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           m_confirmRequired(false),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_pArena(ControlValueArena::forKey(key)),
+          m_pValue(m_pArena ? m_pArena->allocate() : &m_value) {
     initialize(defaultValue);
 }
 
@@ -73,16 +77,16 @@ void ControlDoublePrivate::initialize(double defaultValue) {
         }
     }
     m_defaultValue.setValue(defaultValue);
-    m_value.setValue(value);
+    m_pValue->setValue(value);
 
-    //qDebug() << "Creating:" << m_trackKey << "at" << &m_value << sizeof(m_value);
+    //qDebug() << "Creating:" << m_trackKey << "at" << m_pValue << sizeof(*m_pValue);
 
     if (m_bTrack) {
         // TODO(rryan): Make configurable.
         m_trackKey = "control " + m_key.group + "," + m_key.item;
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
                     static_cast<Stat::ComputeFlags>(m_trackFlags),
-                    m_value.getValue());
+                    m_pValue->getValue());
     }
 }
 
@@ -99,6 +103,10 @@ ControlDoublePrivate::~ControlDoublePrivate() {
         }
         pConfig->set(m_key, QString::number(get()));
     }
+
+    if (m_pArena) {
+        m_pArena->release(m_pValue);
+    }
 }
 
 //static
@@ -294,8 +302,17 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
     if (m_bIgnoreNops && get() == value) {
         return;
     }
-    m_value.setValue(value);
-    emit valueChanged(value, pSender);
+    m_pValue->setValue(value);
+    m_pLastSender.storeRelaxed(pSender);
+    m_changeCount.fetchAndAddRelease(1);
+    if (ControlProfiler::isEnabled()) {
+        PerformanceTimer timer;
+        timer.start();
+        emit valueChanged(value, pSender);
+        m_profile.recordSet(pSender, timer.elapsed());
+    } else {
+        emit valueChanged(value, pSender);
+    }
 
     if (m_bTrack) {
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QAtomicInteger>
 #include <QAtomicPointer>
 #include <QHash>
 #include <QObject>
@@ -7,7 +8,9 @@
 #include <QString>
 
 #include "control/controlbehavior.h"
+#include "control/controlprofiler.h"
 #include "control/controlvalue.h"
+#include "control/controlvaluearena.h"
 #include "preferences/usersettings.h"
 #include "util/mutex.h"
 
@@ -95,11 +98,40 @@ class ControlDoublePrivate : public QObject {
     void setAndConfirm(double value, QObject* pSender);
     // Gets the control value.
     double get() const {
-        return m_value.getValue();
+        return m_pValue->getValue();
+    }
+    // The storage of the control value for reading it without accessing
+    // the control, e.g. by the engine. Valid for the lifetime of the control.
+    const ControlValueAtomic<double>* valueSlot() const {
+        return m_pValue;
     }
     // Resets the control value to its default.
     void reset();
 
+    // The number of changes of the control value, wraps around. Allows
+    // consumers like ControlChangeSet to poll for changes instead of
+    // receiving a valueChanged() signal for every change.
+    quint32 changeCount() const {
+        return m_changeCount.loadAcquire();
+    }
+
+    // The sender of the most recent change. Only meant for comparison,
+    // the object might have been deleted in the meantime. Concurrent
+    // changes from different threads might be attributed to the wrong
+    // sender.
+    const QObject* lastSender() const {
+        return m_pLastSender.loadRelaxed();
+    }
+
+    // The counters recorded while the ControlProfiler is enabled.
+    const ControlProfile& profile() const {
+        return m_profile;
+    }
+    // The number of connections to valueChanged(). Not real-time safe.
+    int listenerCount() const {
+        return receivers(SIGNAL(valueChanged(double, QObject*)));
+    }
+
     // Set the behavior to be used when setting values and translating between
     // parameter and value space. Returns the previously set behavior (if any).
     // Callers must allocate the passed behavior using new and ownership to this
@@ -211,9 +243,19 @@ class ControlDoublePrivate : public QObject {
 
     // The control value.
     ControlValueAtomic<double> m_value;
+    // Incremented after every change of m_value
+    QAtomicInteger<quint32> m_changeCount;
+    // Stored before m_changeCount is incremented
+    QAtomicPointer<QObject> m_pLastSender;
+    ControlProfile m_profile;
     // The default control value.
     ControlValueAtomic<double> m_defaultValue;
 
+    // The arena that stores the control value instead of m_value, if any
+    const QSharedPointer<ControlValueArena> m_pArena;
+    // Points either to m_value or to a slot of m_pArena
+    ControlValueAtomic<double>* const m_pValue;
+
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
 };
 
@@ -0,0 +1,84 @@
+#include "control/controlchangeset.h"
+
+#include "util/assert.h"
+
+ControlChangeSet::ControlChangeSet()
+        : m_draining(false) {
+}
+
+ControlChangeSet::~ControlChangeSet() {
+    DEBUG_ASSERT(!m_draining);
+}
+
+int ControlChangeSet::subscribe(const ConfigKey& key,
+        Callback callback,
+        const QObject* pReceiver) {
+    QSharedPointer<ControlDoublePrivate> pControl =
+            ControlDoublePrivate::getControl(key, ControlFlag::NoAssertIfMissing);
+    if (!pControl) {
+        return -1;
+    }
+    const quint32 changeCount = pControl->changeCount();
+    Subscription subscription{
+            std::move(pControl), changeCount, pReceiver, std::move(callback)};
+    if (m_freeHandles.empty()) {
+        m_subscriptions.push_back(std::move(subscription));
+        return static_cast<int>(m_subscriptions.size()) - 1;
+    }
+    const int handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+    m_subscriptions[handle] = std::move(subscription);
+    return handle;
+}
+
+void ControlChangeSet::unsubscribe(int handle) {
+    VERIFY_OR_DEBUG_ASSERT(handle >= 0 &&
+            handle < static_cast<int>(m_subscriptions.size()) &&
+            m_subscriptions[handle].pControl) {
+        return;
+    }
+    Subscription& subscription = m_subscriptions[handle];
+    subscription.pControl.reset();
+    if (m_draining) {
+        // The callback might currently be invoked and must
+        // not be destroyed before it returns
+        m_pendingFreeHandles.push_back(handle);
+    } else {
+        subscription.callback = nullptr;
+        m_freeHandles.push_back(handle);
+    }
+}
+
+int ControlChangeSet::drain() {
+    DEBUG_ASSERT(!m_draining);
+    m_draining = true;
+    int changes = 0;
+    // Subscriptions that are added by a callback are checked in
+    // the same pass, but they are only notified after their next
+    // change.
+    for (std::size_t i = 0; i < m_subscriptions.size(); ++i) {
+        Subscription& subscription = m_subscriptions[i];
+        if (!subscription.pControl) {
+            continue;
+        }
+        const quint32 changeCount = subscription.pControl->changeCount();
+        if (changeCount == subscription.lastChangeCount) {
+            continue;
+        }
+        subscription.lastChangeCount = changeCount;
+        if (subscription.pReceiver &&
+                subscription.pControl->lastSender() == subscription.pReceiver) {
+            // The receiver already knows the latest value
+            continue;
+        }
+        subscription.callback(subscription.pControl->get());
+        ++changes;
+    }
+    m_draining = false;
+    for (const int handle : m_pendingFreeHandles) {
+        m_subscriptions[handle].callback = nullptr;
+        m_freeHandles.push_back(handle);
+    }
+    m_pendingFreeHandles.clear();
+    return changes;
+}
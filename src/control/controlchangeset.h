@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "control/control.h"
+
+/// A set of controls whose changes are collected and delivered in a batch
+/// when the owner drains the set, typically once per rendered frame.
+///
+/// Instead of receiving a signal for every single change, consumers only
+/// need the latest value of a control. Each control counts its changes and
+/// drain() compares the counters with the last seen values, so setting a
+/// control neither locks nor allocates. Changes between two calls of
+/// drain() are coalesced into a single callback with the latest value.
+///
+/// The set itself is not thread-safe and must only be used from the thread
+/// that drains it. Controls may be changed from any thread.
+class ControlChangeSet final {
+  public:
+    typedef std::function<void(double)> Callback;
+
+    ControlChangeSet();
+    ~ControlChangeSet();
+
+    /// Invoke the callback with the latest value on the next drain after
+    /// the control has changed. Returns a handle for unsubscribing or -1
+    /// if the control does not exist.
+    ///
+    /// Like a ControlProxy, a receiver is not notified about changes it has
+    /// made itself: the callback is skipped if pReceiver is the sender of
+    /// the most recent change.
+    int subscribe(const ConfigKey& key,
+            Callback callback,
+            const QObject* pReceiver = nullptr);
+    void unsubscribe(int handle);
+
+    /// Invoke the callbacks of all controls that have changed since the
+    /// previous call. Callbacks may subscribe or unsubscribe controls.
+    /// Returns the number of callbacks that have been invoked.
+    int drain();
+
+    int size() const {
+        return static_cast<int>(m_subscriptions.size() - m_freeHandles.size() -
+                m_pendingFreeHandles.size());
+    }
+
+  private:
+    struct Subscription {
+        QSharedPointer<ControlDoublePrivate> pControl;
+        quint32 lastChangeCount;
+        const QObject* pReceiver;
+        Callback callback;
+    };
+
+    // Subscriptions must not be moved while their callback is invoked
+    std::deque<Subscription> m_subscriptions;
+    std::vector<int> m_freeHandles;
+    // Handles that have been released while draining the set
+    std::vector<int> m_pendingFreeHandles;
+    bool m_draining;
+};
@@ -6,7 +6,8 @@
 #include "moc_controlobject.cpp"
 
 ControlObject::ControlObject()
-        : m_pControl(ControlDoublePrivate::getDefaultControl()) {
+        : m_pControl(ControlDoublePrivate::getDefaultControl()),
+          m_pValue(m_pControl->valueSlot()) {
 }
 
 ControlObject::ControlObject(const ConfigKey& key,
@@ -36,6 +37,7 @@ ControlObject::ControlObject(const ConfigKey& key,
     } else {
         m_pControl = ControlDoublePrivate::getDefaultControl();
     }
+    m_pValue = m_pControl->valueSlot();
 }
 
 ControlObject::~ControlObject() {
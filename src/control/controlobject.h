@@ -77,7 +77,9 @@ class ControlObject : public QObject {
 
     // Returns the value of the ControlObject
     inline double get() const {
-        return m_pControl ? m_pControl->get() : 0.0;
+        // Read directly from the slot that might be allocated in a
+        // ControlValueArena, without touching the control.
+        return m_pValue->getValue();
     }
 
     // Returns the bool interpretation of the ControlObject
@@ -181,6 +183,10 @@ class ControlObject : public QObject {
     ConfigKey m_key;
     QSharedPointer<ControlDoublePrivate> m_pControl;
 
+  private:
+    // The value of m_pControl, never null
+    const ControlValueAtomic<double>* m_pValue;
+
   private slots:
     void privateValueChanged(double value, QObject* pSetter);
     void readOnlyHandler(double v);
@@ -0,0 +1,296 @@
+#include "control/controlprofiler.h"
+
+#include <QHash>
+#include <QMetaObject>
+#include <QObject>
+#include <QtDebug>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "control/control.h"
+#include "util/mutex.h"
+#include "util/stat.h"
+#include "util/time.h"
+
+namespace {
+
+const QString kUnknownSender = QStringLiteral("(unknown)");
+const QString kDroppedSenders = QStringLiteral("(not recorded)");
+
+// The buffer is emptied by updateStats(), which is called every 50 ms
+// from the GuiTick. This is sufficient for more than 300,000 sets per
+// second. Records that do not fit are counted per control.
+constexpr std::size_t kSenderRecordCapacity = 1 << 14;
+
+struct SenderRecord {
+    const ControlProfile* pProfile;
+    // The class names are static strings
+    const char* senderClassName;
+};
+
+// Bounded multi-producer queue after Dmitry Vyukov. Producers neither
+// block nor allocate and may run concurrently in any thread. There must
+// be only a single consumer at a time.
+class SenderRecordQueue final {
+  public:
+    SenderRecordQueue()
+            : m_writePos(0),
+              m_readPos(0) {
+        for (std::size_t i = 0; i < m_slots.size(); ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const SenderRecord& record) {
+        std::size_t pos = m_writePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos % m_slots.size()];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                // On failure pos is updated with the current position
+                if (m_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Full
+                return false;
+            } else {
+                pos = m_writePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(SenderRecord* pRecord) {
+        Slot& slot = m_slots[m_readPos % m_slots.size()];
+        if (slot.sequence.load(std::memory_order_acquire) != m_readPos + 1) {
+            return false;
+        }
+        *pRecord = slot.record;
+        slot.sequence.store(m_readPos + m_slots.size(), std::memory_order_release);
+        ++m_readPos;
+        return true;
+    }
+
+  private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        SenderRecord record;
+    };
+
+    std::array<Slot, kSenderRecordCapacity> m_slots;
+    std::atomic<std::size_t> m_writePos;
+    std::size_t m_readPos;
+};
+
+// Statically allocated, so it is never allocated by a thread that
+// sets a control
+SenderRecordQueue& senderRecordQueue() {
+    static SenderRecordQueue s_queue;
+    return s_queue;
+}
+
+// Guards the consumer side of the queue and the aggregated senders
+MMutex s_aggregationMutex;
+// The number of sets per control and class name of the sender
+QHash<ConfigKey, QHash<const char*, quint64>> s_setCountBySender;
+// Drained records that have not been attributed to a control yet
+QHash<const ControlProfile*, QHash<const char*, quint64>> s_pendingSetCountBySender;
+
+// Cheap enough to be called frequently, the controls are only resolved
+// by aggregateSenders()
+void drainSenderRecords() {
+    const MMutexLocker locker(&s_aggregationMutex);
+    SenderRecord record;
+    while (senderRecordQueue().tryPop(&record)) {
+        ++s_pendingSetCountBySender[record.pProfile][record.senderClassName];
+    }
+}
+
+// Guarded by the GUI thread
+mixxx::Duration s_enabledSince;
+mixxx::Duration s_lastStatsUpdate;
+QHash<ConfigKey, ControlProfiler::Entry> s_lastStatsEntries;
+
+ControlProfiler::Entry makeEntry(ControlDoublePrivate* pControl,
+        double elapsedSeconds,
+        const QHash<const char*, quint64>& setCountBySender) {
+    const ControlProfile& profile = pControl->profile();
+    ControlProfiler::Entry entry;
+    entry.key = pControl->getKey();
+    entry.setCount = profile.setCount();
+    entry.setsPerSecond = elapsedSeconds > 0 ? entry.setCount / elapsedSeconds : 0.0;
+    entry.listenerCount = pControl->listenerCount();
+    entry.dispatchTime = profile.dispatchTime();
+    entry.droppedSenderCount = profile.droppedSenderCount();
+    for (auto it = setCountBySender.constBegin(); it != setCountBySender.constEnd(); ++it) {
+        entry.senders.append(qMakePair(
+                it.key() ? QString::fromLatin1(it.key()) : kUnknownSender,
+                it.value()));
+    }
+    std::sort(entry.senders.begin(),
+            entry.senders.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.second > rhs.second;
+            });
+    return entry;
+}
+
+} // anonymous namespace
+
+QAtomicInt ControlProfiler::s_enabled;
+
+void ControlProfile::recordSet(const QObject* pSender, mixxx::Duration dispatchTime) {
+    m_setCount.fetchAndAddRelaxed(1);
+    m_dispatchNanos.fetchAndAddRelaxed(dispatchTime.toIntegerNanos());
+    if (!ControlProfiler::recordSender(this,
+                pSender ? pSender->metaObject()->className() : nullptr)) {
+        m_droppedSenderCount.fetchAndAddRelaxed(1);
+    }
+}
+
+// static
+bool ControlProfiler::recordSender(
+        const ControlProfile* pProfile, const char* senderClassName) {
+    return senderRecordQueue().tryPush({pProfile, senderClassName});
+}
+
+// static
+void ControlProfiler::aggregateSenders() {
+    drainSenderRecords();
+    // The records are only resolved for controls that still exist. A record
+    // of a deleted control might be attributed to a new control at the same
+    // address, which is acceptable for profiling.
+    const auto controls = ControlDoublePrivate::getAllInstances();
+    QHash<const ControlProfile*, ConfigKey> keysByProfile;
+    keysByProfile.reserve(controls.size());
+    for (const auto& pControl : controls) {
+        keysByProfile.insert(&pControl->profile(), pControl->getKey());
+    }
+    const MMutexLocker locker(&s_aggregationMutex);
+    for (auto pending = s_pendingSetCountBySender.constBegin();
+            pending != s_pendingSetCountBySender.constEnd();
+            ++pending) {
+        const auto it = keysByProfile.constFind(pending.key());
+        if (it == keysByProfile.constEnd()) {
+            continue;
+        }
+        auto& setCountBySender = s_setCountBySender[it.value()];
+        for (auto sender = pending.value().constBegin();
+                sender != pending.value().constEnd();
+                ++sender) {
+            setCountBySender[sender.key()] += sender.value();
+        }
+    }
+    s_pendingSetCountBySender.clear();
+}
+
+// static
+void ControlProfiler::setEnabled(bool enabled) {
+    if (enabled && !isEnabled()) {
+        // Construct the queue before any control is recorded
+        senderRecordQueue();
+        s_enabledSince = mixxx::Time::elapsed();
+    }
+    s_enabled.storeRelaxed(enabled ? 1 : 0);
+}
+
+// static
+QList<ControlProfiler::Entry> ControlProfiler::report() {
+    aggregateSenders();
+    const double elapsedSeconds = (mixxx::Time::elapsed() - s_enabledSince).toDoubleSeconds();
+    QList<Entry> entries;
+    const auto controls = ControlDoublePrivate::getAllInstances();
+    const MMutexLocker locker(&s_aggregationMutex);
+    for (const auto& pControl : controls) {
+        if (pControl->profile().setCount() == 0) {
+            continue;
+        }
+        entries.append(makeEntry(pControl.data(),
+                elapsedSeconds,
+                s_setCountBySender.value(pControl->getKey())));
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.setCount > rhs.setCount;
+    });
+    return entries;
+}
+
+// static
+void ControlProfiler::logReport(int maxEntries) {
+    const QList<Entry> entries = report();
+    qInfo() << "Control profile of the" << std::min(maxEntries, static_cast<int>(entries.size()))
+            << "most frequently set out of" << entries.size() << "controls:";
+    for (int i = 0; i < entries.size() && i < maxEntries; ++i) {
+        const Entry& entry = entries[i];
+        QStringList senders;
+        for (const auto& sender : entry.senders) {
+            senders << QStringLiteral("%1: %2").arg(sender.first).arg(sender.second);
+        }
+        if (entry.droppedSenderCount > 0) {
+            senders << QStringLiteral("%1: %2").arg(kDroppedSenders).arg(entry.droppedSenderCount);
+        }
+        qInfo().noquote()
+                << QStringLiteral("%1,%2").arg(entry.key.group, entry.key.item)
+                << "sets:" << entry.setCount
+                << "sets/s:" << QString::number(entry.setsPerSecond, 'f', 1)
+                << "listeners:" << entry.listenerCount
+                << "dispatch:" << entry.dispatchTime.formatMillisWithUnit()
+                << "by" << senders.join(QStringLiteral(", "));
+    }
+    quint64 droppedSenderRecords = 0;
+    for (const Entry& entry : entries) {
+        droppedSenderRecords += entry.droppedSenderCount;
+    }
+    if (droppedSenderRecords > 0) {
+        qInfo() << "The senders of" << droppedSenderRecords
+                << "control changes have not been recorded";
+    }
+}
+
+// static
+void ControlProfiler::updateStats() {
+    if (!isEnabled()) {
+        return;
+    }
+    // Keep the buffer of sender records from overflowing
+    drainSenderRecords();
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    const double intervalSeconds = (now - s_lastStatsUpdate).toDoubleSeconds();
+    if (intervalSeconds < 1.0) {
+        return;
+    }
+    s_lastStatsUpdate = now;
+    aggregateSenders();
+
+    const auto controls = ControlDoublePrivate::getAllInstances();
+    for (const auto& pControl : controls) {
+        const ControlProfile& profile = pControl->profile();
+        const quint64 setCount = profile.setCount();
+        if (setCount == 0) {
+            continue;
+        }
+        const ConfigKey& key = pControl->getKey();
+        Entry& lastEntry = s_lastStatsEntries[key];
+        const quint64 sets = setCount - lastEntry.setCount;
+        if (sets == 0) {
+            continue;
+        }
+        const mixxx::Duration dispatchTime = profile.dispatchTime();
+        const QString tag = key.group + QChar(',') + key.item;
+        Stat::track(QStringLiteral("control sets/s ") + tag,
+                Stat::COUNTER,
+                Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+                sets / intervalSeconds);
+        Stat::track(QStringLiteral("control dispatch ") + tag,
+                Stat::DURATION_NANOSEC,
+                Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+                (dispatchTime - lastEntry.dispatchTime).toDoubleNanos() / sets);
+        lastEntry.setCount = setCount;
+        lastEntry.dispatchTime = dispatchTime;
+    }
+}
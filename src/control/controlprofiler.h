@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QAtomicInteger>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+#include "preferences/configobject.h"
+#include "util/duration.h"
+
+class QObject;
+
+/// The counters of a single control that are recorded while the
+/// ControlProfiler is enabled.
+class ControlProfile final {
+  public:
+    ControlProfile() = default;
+
+    /// Record a change of the control by pSender. Lock-free, because
+    /// controls are also set by the engine thread and its workers. The
+    /// sender is attributed later by the ControlProfiler.
+    void recordSet(const QObject* pSender, mixxx::Duration dispatchTime);
+
+    quint64 setCount() const {
+        return m_setCount.loadRelaxed();
+    }
+    mixxx::Duration dispatchTime() const {
+        return mixxx::Duration::fromNanos(m_dispatchNanos.loadRelaxed());
+    }
+    /// The number of sets whose sender could not be recorded
+    quint64 droppedSenderCount() const {
+        return m_droppedSenderCount.loadRelaxed();
+    }
+
+  private:
+    QAtomicInteger<quint64> m_setCount;
+    QAtomicInteger<qint64> m_dispatchNanos;
+    QAtomicInteger<quint64> m_droppedSenderCount;
+};
+
+/// Finds the controls that are written most often and how expensive their
+/// notifications are, e.g. to identify controller mappings or skins that
+/// flood the control system. Enabled with the --control-profiler command
+/// line option.
+///
+/// Recording is off by default and costs a single relaxed atomic load per
+/// control change. While enabled the dispatch of the valueChanged() signal
+/// is timed and the sender of every change is written to a preallocated
+/// buffer, which is aggregated by report() and updateStats(). The listeners
+/// are counted when the report is created.
+class ControlProfiler {
+  public:
+    struct Entry {
+        ConfigKey key;
+        quint64 setCount = 0;
+        double setsPerSecond = 0.0;
+        int listenerCount = 0;
+        mixxx::Duration dispatchTime;
+        // Sorted by the number of sets in descending order
+        QList<QPair<QString, quint64>> senders;
+        // Sets that are missing in senders, because the buffer was full
+        quint64 droppedSenderCount = 0;
+    };
+
+    static bool isEnabled() {
+        return s_enabled.loadRelaxed() != 0;
+    }
+    static void setEnabled(bool enabled);
+
+    /// All controls that have been set since the profiler has been enabled,
+    /// sorted by the number of sets in descending order.
+    static QList<Entry> report();
+    /// Write the report of the maxEntries most frequently set controls to
+    /// the log.
+    static void logReport(int maxEntries);
+
+    /// Publish the set rates of all controls about once per second as
+    /// live counters to the StatsManager. Must be called frequently from
+    /// the GUI thread, because it also drains the buffered senders.
+    static void updateStats();
+
+  private:
+    friend class ControlProfile;
+
+    /// Called by ControlProfile::recordSet() from any thread. Returns
+    /// false if the record has been dropped, because the buffer is full.
+    static bool recordSender(const ControlProfile* pProfile, const char* senderClassName);
+    /// Aggregates the pending records of the senders.
+    static void aggregateSenders();
+
+    static QAtomicInt s_enabled;
+};
@@ -0,0 +1,94 @@
+#include "control/controlvaluearena.h"
+
+#include <QHash>
+
+#include "util/assert.h"
+
+namespace {
+
+// The innermost scope of the current thread
+thread_local ControlValueArena::Scope* t_pCurrentScope = nullptr;
+
+MMutex s_arenasMutex;
+QHash<QString, QWeakPointer<ControlValueArena>> s_arenas GUARDED_BY(s_arenasMutex);
+
+} // anonymous namespace
+
+ControlValueArena::Scope::Scope(const QString& group)
+        : m_pArena(ControlValueArena::forGroup(group)),
+          m_pOuterScope(t_pCurrentScope) {
+    t_pCurrentScope = this;
+}
+
+ControlValueArena::Scope::~Scope() {
+    DEBUG_ASSERT(t_pCurrentScope == this);
+    t_pCurrentScope = m_pOuterScope;
+}
+
+ControlValueArena::ControlValueArena(const QString& group)
+        : m_group(group),
+          m_lastBlockSize(kSlotsPerBlock) {
+}
+
+ControlValueArena::~ControlValueArena() {
+    const MMutexLocker locker(&s_arenasMutex);
+    // The entry might already refer to a new arena for the same group
+    const auto iter = s_arenas.find(m_group);
+    if (iter != s_arenas.end() && iter.value().isNull()) {
+        s_arenas.erase(iter);
+    }
+}
+
+// static
+QSharedPointer<ControlValueArena> ControlValueArena::forGroup(const QString& group) {
+    const MMutexLocker locker(&s_arenasMutex);
+    QSharedPointer<ControlValueArena> pArena = s_arenas.value(group).lock();
+    if (!pArena) {
+        pArena = QSharedPointer<ControlValueArena>(new ControlValueArena(group));
+        s_arenas.insert(group, pArena);
+    }
+    return pArena;
+}
+
+// static
+QSharedPointer<ControlValueArena> ControlValueArena::forKey(const ConfigKey& key) {
+    const Scope* pScope = t_pCurrentScope;
+    if (pScope && pScope->m_pArena->group() == key.group) {
+        return pScope->m_pArena;
+    }
+    return {};
+}
+
+ControlValueArena::Slot* ControlValueArena::allocate() {
+    Slot* pSlot;
+    {
+        const MMutexLocker locker(&m_mutex);
+        if (!m_freeSlots.empty()) {
+            pSlot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            if (m_lastBlockSize == kSlotsPerBlock) {
+                m_blocks.push_back(std::make_unique<Block>());
+                m_lastBlockSize = 0;
+            }
+            pSlot = &m_blocks.back()->slots[m_lastBlockSize++];
+        }
+    }
+    pSlot->setValue(0.0);
+    return pSlot;
+}
+
+void ControlValueArena::release(Slot* pSlot) {
+    DEBUG_ASSERT(pSlot);
+    const MMutexLocker locker(&m_mutex);
+    m_freeSlots.push_back(pSlot);
+}
+
+int ControlValueArena::size() const {
+    const MMutexLocker locker(&m_mutex);
+    if (m_blocks.empty()) {
+        return 0;
+    }
+    return static_cast<int>((m_blocks.size() - 1) * kSlotsPerBlock +
+            m_lastBlockSize - m_freeSlots.size());
+}
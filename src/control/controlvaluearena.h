@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "control/controlvalue.h"
+#include "preferences/configobject.h"
+#include "util/mutex.h"
+
+/// Stores the values of the controls of a single group, e.g. [Channel1],
+/// in contiguous blocks instead of inside each separately allocated
+/// ControlDoublePrivate.
+///
+/// The engine reads dozens of controls of its group in every callback.
+/// With an arena these reads touch only a few cache lines, because
+/// ControlObject and PollingControlProxy read the value directly from
+/// its slot.
+///
+/// Arenas are optional. Only controls that are created while a Scope for
+/// their group is active on the creating thread are allocated from the
+/// arena, all other controls store their value inline.
+class ControlValueArena final {
+  public:
+    typedef ControlValueAtomic<double> Slot;
+
+    /// Controls of the group that are created by the current thread
+    /// while the scope exists are allocated from the arena of the group.
+    /// Scopes can be nested.
+    class Scope final {
+      public:
+        explicit Scope(const QString& group);
+        ~Scope();
+
+      private:
+        const QSharedPointer<ControlValueArena> m_pArena;
+        Scope* const m_pOuterScope;
+
+        friend class ControlValueArena;
+    };
+
+    ~ControlValueArena();
+
+    /// Returns the arena of the innermost active scope if it has been
+    /// created for the group of the key or nullptr otherwise.
+    static QSharedPointer<ControlValueArena> forKey(const ConfigKey& key);
+
+    const QString& group() const {
+        return m_group;
+    }
+
+    /// Returns a slot with the value 0.0
+    Slot* allocate();
+    void release(Slot* pSlot);
+
+    /// The number of allocated slots
+    int size() const;
+
+  private:
+    explicit ControlValueArena(const QString& group);
+
+    static QSharedPointer<ControlValueArena> forGroup(const QString& group);
+
+    // 64 doubles occupy 8 cache lines on 64-bit architectures
+    static constexpr int kSlotsPerBlock = 64;
+    struct alignas(64) Block {
+        Slot slots[kSlotsPerBlock];
+    };
+
+    const QString m_group;
+
+    mutable MMutex m_mutex;
+    std::vector<std::unique_ptr<Block>> m_blocks GUARDED_BY(m_mutex);
+    // The number of used slots in the last block
+    int m_lastBlockSize GUARDED_BY(m_mutex);
+    std::vector<Slot*> m_freeSlots GUARDED_BY(m_mutex);
+};
@@ -25,6 +25,7 @@ class PollingControlProxy {
             m_pControl = ControlDoublePrivate::getDefaultControl();
         }
         DEBUG_ASSERT(m_pControl);
+        m_pValue = m_pControl->valueSlot();
     }
 
     bool valid() const {
@@ -33,7 +34,7 @@ class PollingControlProxy {
 
     /// Returns the value of the object. Thread safe, non-blocking.
     double get() const {
-        return m_pControl->get();
+        return m_pValue->getValue();
     }
 
     /// Returns the bool interpretation of the value
@@ -73,4 +74,6 @@ class PollingControlProxy {
   private:
     // not null
     QSharedPointer<ControlDoublePrivate> m_pControl;
+    // The value of m_pControl, read without touching the control
+    const ControlValueAtomic<double>* m_pValue;
 };
@@ -9,10 +9,12 @@
 #include "broadcast/broadcastmanager.h"
 #endif
 #include "control/controlindicatortimer.h"
+#include "control/controlprofiler.h"
 #include "controllers/controllermanager.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
 #include "effects/effectsmanager.h"
+#include "engine/bufferscalers/soundtouchworkerpool.h"
 #include "engine/enginemixer.h"
 #ifdef __RUBBERBAND__
 #include "engine/bufferscalers/rubberbandworkerpool.h"
@@ -80,6 +82,7 @@ const mixxx::Logger kLogger("CoreServices");
 constexpr int kMicrophoneCount = 4;
 constexpr int kAuxiliaryCount = 4;
 constexpr int kSamplerCount = 4;
+constexpr int kControlProfilerReportSize = 50;
 
 #define CLEAR_AND_CHECK_DELETED(x) clearHelper(x, #x);
 
@@ -140,6 +143,7 @@ CoreServices::CoreServices(const CmdlineArgs& args, QApplication* pApp)
     if (m_cmdlineArgs.getDeveloper()) {
         StatsManager::createInstance();
     }
+    ControlProfiler::setEnabled(m_cmdlineArgs.getControlProfiler());
     mixxx::Translations::initializeTranslations(
             m_pSettingsManager->settings(), pApp, m_cmdlineArgs.getLocale());
     initializeKeyboard();
@@ -287,6 +291,7 @@ void CoreServices::initialize(QApplication* pApp) {
 #ifdef __RUBBERBAND__
     RubberBandWorkerPool::createInstance(pConfig);
 #endif
+    SoundTouchWorkerPool::createInstance(pConfig);
 
     emit initializationProgressUpdate(30, tr("audio interface"));
     // Although m_pSoundManager is created here, m_pSoundManager->setupDevices()
@@ -355,7 +360,9 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    // Pre-scaled cover art images are stored next to the analysis data
+    CoverArtCache::createInstance(
+            pConfig->getSettingsPath() + QStringLiteral("/coverart"));
     Clipboard::createInstance();
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
@@ -602,6 +609,10 @@ void CoreServices::finalize() {
     Timer t("CoreServices::~CoreServices");
     t.start();
 
+    if (ControlProfiler::isEnabled()) {
+        ControlProfiler::logReport(kControlProfilerReportSize);
+    }
+
 #ifdef MIXXX_USE_QML
     // Delete all the QML singletons in order to prevent controller leaks
     mixxx::qml::QmlEffectsManagerProxy::registerEffectsManager(nullptr);
@@ -668,6 +679,7 @@ void CoreServices::finalize() {
 #ifdef __RUBBERBAND__
     RubberBandWorkerPool::destroy();
 #endif
+    SoundTouchWorkerPool::destroy();
 
     // Destroy PlayerInfo explicitly to release the track
     // pointers of tracks that were still loaded in decks
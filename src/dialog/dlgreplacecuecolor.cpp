@@ -312,7 +312,7 @@ void DlgReplaceCueColor::slotApply() {
     // Flush cached tracks to database
     QSet<TrackId> cachedTrackIds = GlobalTrackCacheLocker().getCachedTrackIds();
     for (const TrackId& trackId : cachedTrackIds) {
-        TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+        TrackPointer pTrack = GlobalTrackCacheLocker(trackId).lookupTrackById(trackId);
         if (pTrack) {
             m_pTrackCollectionManager->saveTrack(pTrack);
         }
@@ -406,7 +406,7 @@ void DlgReplaceCueColor::slotApply() {
             // If the track that these cues belong to is cached, store a
             // reference to them so that we can update the in-memory objects
             // after committing the database changes
-            TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(row.trackId);
+            TrackPointer pTrack = GlobalTrackCacheLocker(row.trackId).lookupTrackById(row.trackId);
             if (pTrack) {
                 cues.insert(pTrack, row.id);
             }
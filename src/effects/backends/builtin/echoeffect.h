@@ -20,6 +20,11 @@ class EchoGroupState : public EffectState {
     }
     ~EchoGroupState() override = default;
 
+    bool resetForReuse() override {
+        clear();
+        return true;
+    }
+
     void audioParametersChanged(const mixxx::EngineParameters& engineParameters) {
         delay_buf = mixxx::SampleBuffer(kMaxDelaySeconds *
                 engineParameters.sampleRate() *
@@ -21,18 +21,27 @@ constexpr double kMaxLfoBeats = 32.0;
 
 struct FlangerGroupState : public EffectState {
     FlangerGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters),
-              delayPos(0),
-              lfoFrames(0),
-              previousPeriodFrames(-1),
-              prev_regen(0),
-              prev_mix(0),
-              prev_width(0),
-              prev_manual(static_cast<CSAMPLE_GAIN>(kCenterDelayMs)) {
+            : EffectState(engineParameters) {
+        clear();
+    }
+    ~FlangerGroupState() override = default;
+
+    bool resetForReuse() override {
+        clear();
+        return true;
+    }
+
+    void clear() {
         SampleUtil::clear(delayLeft, kBufferLenth);
         SampleUtil::clear(delayRight, kBufferLenth);
+        delayPos = 0;
+        lfoFrames = 0;
+        previousPeriodFrames = -1;
+        prev_regen = 0;
+        prev_mix = 0;
+        prev_width = 0;
+        prev_manual = static_cast<CSAMPLE_GAIN>(kCenterDelayMs);
     }
-    ~FlangerGroupState() override = default;
 
     CSAMPLE delayLeft[kBufferLenth];
     CSAMPLE delayRight[kBufferLenth];
@@ -23,6 +23,11 @@ class GlitchGroupState : public EffectState {
         clear();
     }
 
+    bool resetForReuse() override {
+        clear();
+        return true;
+    }
+
     void audioParametersChanged(const mixxx::EngineParameters& engineParameters) {
         repeat_buf = mixxx::SampleBuffer(engineParameters.samplesPerBuffer());
     };
@@ -17,9 +17,18 @@ class ReverbGroupState : public EffectState {
             : EffectState(engineParameters),
               sampleRate(engineParameters.sampleRate()),
               sendPrevious(0) {
+        // Allocate the delay lines in the main thread. Reinitializing them
+        // in the audio thread reuses the memory up to this sample rate.
+        reverb.init(sampleRate);
     }
     ~ReverbGroupState() override = default;
 
+    bool resetForReuse() override {
+        reverb.activate();
+        sendPrevious = 0;
+        return true;
+    }
+
     void engineParametersChanged(const mixxx::EngineParameters& engineParameters) {
         sampleRate = engineParameters.sampleRate();
         sendPrevious = 0;
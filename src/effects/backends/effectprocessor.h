@@ -4,6 +4,8 @@
 #include <QHash>
 #include <QPair>
 #include <QString>
+#include <memory>
+#include <vector>
 
 #include "effects/defs.h"
 #include "engine/channelhandle.h"
@@ -51,6 +53,10 @@
 /// without wasting a lot of memory. (EffectStates could be (de)allocated when toggling
 /// the enable switches for EffectSlots as well, but the memory savings would be
 /// relatively small compared to the additional code complexity.)
+///
+/// EffectStates of destroyed EffectProcessors can be kept in an EffectStatePool
+/// and are reused by the next EffectProcessor of the same effect, so swapping
+/// effects back and forth does not allocate and free large buffers again.
 class EffectState {
   public:
     EffectState(const mixxx::EngineParameters& engineParameters) {
@@ -58,6 +64,75 @@ class EffectState {
         Q_UNUSED(engineParameters);
     };
     virtual ~EffectState(){};
+
+    /// Called from the main thread when the EffectProcessor owning this state
+    /// is destroyed. Subclasses that own large buffers may reset themselves
+    /// to the state after construction without reallocating and return true
+    /// to be reused. By default states are deleted.
+    virtual bool resetForReuse() {
+        return false;
+    }
+};
+
+/// EffectStatePool keeps the reusable EffectStates of destroyed EffectProcessors
+/// for one EffectState subclass, i.e. for one effect. There is a single pool per
+/// subclass, which is only accessed from the main thread.
+template<typename EffectSpecificState>
+class EffectStatePool {
+  public:
+    /// The number of states kept per effect. Enough for a few effect units
+    /// with all decks and samplers routed to them, without holding on to
+    /// an unbounded amount of memory.
+    static constexpr std::size_t kMaxStates = 32;
+
+    static EffectStatePool& instance() {
+        static EffectStatePool s_pool;
+        return s_pool;
+    }
+
+    /// Returns a state that has been created with the same engine parameters
+    /// or nullptr if there is none.
+    std::unique_ptr<EffectSpecificState> acquire(
+            const mixxx::EngineParameters& engineParameters) {
+        for (auto it = m_states.rbegin(); it != m_states.rend(); ++it) {
+            if (it->sampleRate == engineParameters.sampleRate() &&
+                    it->framesPerBuffer == engineParameters.framesPerBuffer()) {
+                std::unique_ptr<EffectSpecificState> pState = std::move(it->pState);
+                m_states.erase(std::next(it).base());
+                return pState;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Takes ownership of a state that has been created with the given
+    /// engine parameters. It is deleted unless it can be reused.
+    void release(std::unique_ptr<EffectSpecificState> pState,
+            const mixxx::EngineParameters& engineParameters) {
+        if (!pState || m_states.size() >= kMaxStates || !pState->resetForReuse()) {
+            return;
+        }
+        m_states.push_back(PooledState{std::move(pState),
+                engineParameters.sampleRate(),
+                engineParameters.framesPerBuffer()});
+    }
+
+    std::size_t size() const {
+        return m_states.size();
+    }
+
+    void clear() {
+        m_states.clear();
+    }
+
+  private:
+    struct PooledState {
+        std::unique_ptr<EffectSpecificState> pState;
+        mixxx::audio::SampleRate sampleRate;
+        SINT framesPerBuffer;
+    };
+
+    std::vector<PooledState> m_states;
 };
 
 /// EffectProcessor is an abstract base class for interfacing with an EffectSlot
@@ -127,6 +202,16 @@ class EffectProcessorImpl : public EffectProcessor {
         if (kEffectDebugOutput) {
             qDebug() << "~EffectProcessorImpl" << this;
         }
+        if (!m_pStateEngineParameters) {
+            // No states have been created
+            return;
+        }
+        auto& pool = EffectStatePool<EffectSpecificState>::instance();
+        for (auto& outputChannelStates : m_channelStateMatrix) {
+            for (auto& pState : outputChannelStates) {
+                pool.release(std::move(pState), *m_pStateEngineParameters);
+            }
+        }
     };
 
     /// NOTE: Subclasses for Built-In effects must implement the following static methods for
@@ -208,6 +293,16 @@ class EffectProcessorImpl : public EffectProcessor {
         for (int i = 0; i < requiredVectorSize; ++i) {
             outputChannelStates.push_back(std::unique_ptr<EffectSpecificState>());
         }
+        // All states are created with the same parameters, which are
+        // needed for returning them to the EffectStatePool.
+        DEBUG_ASSERT(!m_pStateEngineParameters ||
+                (m_pStateEngineParameters->sampleRate() == engineParameters.sampleRate() &&
+                        m_pStateEngineParameters->framesPerBuffer() ==
+                                engineParameters.framesPerBuffer()));
+        if (!m_pStateEngineParameters) {
+            m_pStateEngineParameters = std::make_unique<mixxx::EngineParameters>(
+                    engineParameters.sampleRate(), engineParameters.framesPerBuffer());
+        }
         for (const ChannelHandleAndGroup& outputChannel :
                 std::as_const(m_registeredOutputChannels)) {
             outputChannelStates[outputChannel.handle()].reset(
@@ -238,6 +333,15 @@ class EffectProcessorImpl : public EffectProcessor {
     /// subclasses for built-in effects should not.
     virtual EffectSpecificState* createSpecificState(
             const mixxx::EngineParameters& engineParameters) {
+        std::unique_ptr<EffectSpecificState> pPooledState =
+                EffectStatePool<EffectSpecificState>::instance().acquire(engineParameters);
+        if (pPooledState) {
+            if (kEffectDebugOutput) {
+                qDebug() << this << "EffectProcessorImpl reusing EffectState"
+                         << pPooledState.get();
+            }
+            return pPooledState.release();
+        }
         EffectSpecificState* pState = new EffectSpecificState(engineParameters);
         if (kEffectDebugOutput) {
             qDebug() << this << "EffectProcessorImpl creating EffectState" << pState;
@@ -248,4 +352,6 @@ class EffectProcessorImpl : public EffectProcessor {
   private:
     QSet<ChannelHandleAndGroup> m_registeredOutputChannels;
     ChannelHandleMap<unique_ptr_vector<EffectSpecificState>> m_channelStateMatrix;
+    // EngineParameters are not assignable
+    std::unique_ptr<const mixxx::EngineParameters> m_pStateEngineParameters;
 };
@@ -131,9 +131,26 @@ EffectSlot::EffectSlot(const QString& group,
     m_pControlMetaParameter->set(0.0);
     m_pControlMetaParameter->setDefaultValue(0.0);
 
+    // Published by the EngineEffect, which shares them because it may
+    // outlive this slot.
+    m_pControlCpuUsage = QSharedPointer<ControlObject>(
+            new ControlObject(ConfigKey(m_group, "cpu_usage")));
+    m_pControlCpuUsage->setReadOnly();
+    m_pControlCpuBypassed = QSharedPointer<ControlObject>(
+            new ControlObject(ConfigKey(m_group, "cpu_bypassed")));
+    m_pControlCpuBypassed->setReadOnly();
+
     m_pControlLoaded->forceSet(0.0);
 }
 
+double EffectSlot::getCpuUsage() const {
+    return m_pControlCpuUsage->get();
+}
+
+bool EffectSlot::isBypassedByCpuGovernor() const {
+    return m_pControlCpuBypassed->toBool();
+}
+
 EffectSlot::~EffectSlot() {
     //qDebug() << debugString() << "destroyed";
     unloadEffect();
@@ -153,7 +170,9 @@ void EffectSlot::addToEngine() {
             m_pBackendManager,
             m_pChain->getActiveChannels(),
             m_pEffectsManager->registeredInputChannels(),
-            m_pEffectsManager->registeredOutputChannels());
+            m_pEffectsManager->registeredOutputChannels(),
+            m_pControlCpuUsage,
+            m_pControlCpuBypassed);
 
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
@@ -176,6 +195,8 @@ void EffectSlot::removeFromEngine() {
     m_pMessenger->writeRequest(request);
 
     m_pEngineEffect = nullptr;
+    m_pControlCpuUsage->forceSet(0.0);
+    m_pControlCpuBypassed->forceSet(0.0);
 }
 
 void EffectSlot::updateEngineState() {
@@ -109,6 +109,13 @@ class EffectSlot : public QObject {
 
     double getMetaParameter() const;
 
+    /// The smoothed time spent processing the effect relative to the
+    /// buffer duration
+    double getCpuUsage() const;
+    /// Whether the effect is currently bypassed by the CPU governor
+    /// of the engine to avoid buffer underflows
+    bool isBypassedByCpuGovernor() const;
+
     /// Ensures that Softtakover is bypassed for the following
     /// ChainParameterChange. Uses for testing only
     void syncSofttakeover();
@@ -188,6 +195,8 @@ class EffectSlot : public QObject {
     std::unique_ptr<ControlEncoder> m_pControlEffectSelector;
     std::unique_ptr<ControlObject> m_pControlClear;
     std::unique_ptr<ControlPotmeter> m_pControlMetaParameter;
+    QSharedPointer<ControlObject> m_pControlCpuUsage;
+    QSharedPointer<ControlObject> m_pControlCpuBypassed;
 
     SoftTakeover m_metaknobSoftTakeover;
 
@@ -1,11 +1,9 @@
 #include "engine/bufferscalers/enginebufferscalest.h"
 
-#include "moc_enginebufferscalest.cpp"
-
-// Fixes redefinition warnings from SoundTouch.
-#include <soundtouch/SoundTouch.h>
-
+#include "engine/bufferscalers/soundtouchtask.h"
+#include "engine/bufferscalers/soundtouchworkerpool.h"
 #include "engine/readaheadmanager.h"
+#include "moc_enginebufferscalest.cpp"
 #include "util/math.h"
 #include "util/sample.h"
 
@@ -26,15 +24,49 @@ constexpr SINT kSeekOffsetFramesV20101 = 429;
 
 constexpr SINT kBackBufferFrameSize = 512;
 
+// Copies the interleaved channels of pSrc into a block of blockSize samples
+// per group of channelPerWorker channels.
+void splitChannels(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        SINT frames,
+        int channelCount,
+        int channelPerWorker,
+        SINT blockSize) {
+    for (int ch = 0; ch < channelCount; ++ch) {
+        CSAMPLE* pDestChannel = pDest +
+                (ch / channelPerWorker) * blockSize + ch % channelPerWorker;
+        const CSAMPLE* pSrcChannel = pSrc + ch;
+        for (SINT f = 0; f < frames; ++f) {
+            pDestChannel[f * channelPerWorker] = pSrcChannel[f * channelCount];
+        }
+    }
+}
+
+// The inverse of splitChannels()
+void mergeChannels(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        SINT frames,
+        int channelCount,
+        int channelPerWorker,
+        SINT blockSize) {
+    for (int ch = 0; ch < channelCount; ++ch) {
+        CSAMPLE* pDestChannel = pDest + ch;
+        const CSAMPLE* pSrcChannel = pSrc +
+                (ch / channelPerWorker) * blockSize + ch % channelPerWorker;
+        for (SINT f = 0; f < frames; ++f) {
+            pDestChannel[f * channelCount] = pSrcChannel[f * channelPerWorker];
+        }
+    }
+}
+
 }  // namespace
 
 EngineBufferScaleST::EngineBufferScaleST(ReadAheadManager* pReadAheadManager)
         : m_pReadAheadManager(pReadAheadManager),
-          m_pSoundTouch(std::make_unique<soundtouch::SoundTouch>()),
+          m_channelPerWorker(getOutputSignal().getChannelCount()),
           m_bBackwards(false) {
-    m_pSoundTouch->setRate(m_dBaseRate);
-    m_pSoundTouch->setPitch(1.0);
-    m_pSoundTouch->setSetting(SETTING_USE_QUICKSEEK, 1);
+    m_pInstances.push_back(std::make_unique<SoundTouchTask>());
+    initInstance(m_pInstances.back().get());
     // Initialize the internal buffers to prevent re-allocations
     // in the real-time thread.
     onSignalChanged();
@@ -43,6 +75,14 @@ EngineBufferScaleST::EngineBufferScaleST(ReadAheadManager* pReadAheadManager)
 EngineBufferScaleST::~EngineBufferScaleST() {
 }
 
+void EngineBufferScaleST::initInstance(SoundTouchTask* pInstance) const {
+    pInstance->setSetting(SETTING_USE_QUICKSEEK, 1);
+    pInstance->setRate(m_dBaseRate);
+    pInstance->setTempo(m_dTempoRatio > 0.0 ? m_dTempoRatio : 1.0);
+    const double pitch = fabs(m_dPitchRatio);
+    pInstance->setPitch(pitch > 0.0 ? pitch : 1.0);
+}
+
 void EngineBufferScaleST::setScaleParameters(double base_rate,
                                              double* pTempoRatio,
                                              double* pPitchRatio) {
@@ -68,11 +108,15 @@ void EngineBufferScaleST::setScaleParameters(double base_rate,
     if (speed_abs != m_dTempoRatio) {
         // Note: A rate of zero would make Soundtouch crash,
         // this is caught in scaleBuffer()
-        m_pSoundTouch->setTempo(speed_abs);
+        for (auto& pInstance : m_pInstances) {
+            pInstance->setTempo(speed_abs);
+        }
         m_dTempoRatio = speed_abs;
     }
     if (base_rate != m_dBaseRate) {
-        m_pSoundTouch->setRate(base_rate);
+        for (auto& pInstance : m_pInstances) {
+            pInstance->setRate(base_rate);
+        }
         m_dBaseRate = base_rate;
     }
 
@@ -80,7 +124,9 @@ void EngineBufferScaleST::setScaleParameters(double base_rate,
         // Note: pitch ratio must be positive
         double pitch = fabs(*pPitchRatio);
         if (pitch > 0.0) {
-            m_pSoundTouch->setPitch(pitch);
+            for (auto& pInstance : m_pInstances) {
+                pInstance->setPitch(pitch);
+            }
         }
         m_dPitchRatio = *pPitchRatio;
     }
@@ -90,28 +136,46 @@ void EngineBufferScaleST::setScaleParameters(double base_rate,
 }
 
 void EngineBufferScaleST::onSignalChanged() {
-    int backBufferSize = kBackBufferFrameSize * getOutputSignal().getChannelCount();
+    const auto channelCount = getOutputSignal().getChannelCount();
+    int backBufferSize = kBackBufferFrameSize * channelCount;
     if (m_bufferBack.size() == backBufferSize) {
         m_bufferBack.clear();
     } else {
         m_bufferBack = mixxx::SampleBuffer(backBufferSize);
+        m_bufferWorkers = mixxx::SampleBuffer(backBufferSize);
     }
     if (!getOutputSignal().isValid()) {
         return;
     }
-    m_pSoundTouch->setSampleRate(getOutputSignal().getSampleRate());
-    m_pSoundTouch->setChannels(getOutputSignal().getChannelCount());
 
-    // Setting the tempo to a very low value will force SoundTouch
-    // to preallocate buffers large enough to (almost certainly)
-    // avoid memory reallocations during playback.
-    m_pSoundTouch->setTempo(0.1);
-    m_pSoundTouch->setTempo(m_dTempoRatio);
+    // There should always be a pool set, even if multi threading isn't
+    // enabled, because stem decks are distributed among the workers.
+    SoundTouchWorkerPool* pPool = SoundTouchWorkerPool::instance();
+    m_channelPerWorker = pPool ? pPool->channelPerWorker(channelCount) : channelCount;
+    const std::size_t numInstances = channelCount / m_channelPerWorker;
+    m_pInstances.resize(std::min(m_pInstances.size(), numInstances));
+    while (m_pInstances.size() < numInstances) {
+        m_pInstances.push_back(std::make_unique<SoundTouchTask>());
+        initInstance(m_pInstances.back().get());
+    }
+
+    for (auto& pInstance : m_pInstances) {
+        pInstance->setSampleRate(getOutputSignal().getSampleRate());
+        pInstance->setChannels(m_channelPerWorker);
+
+        // Setting the tempo to a very low value will force SoundTouch
+        // to preallocate buffers large enough to (almost certainly)
+        // avoid memory reallocations during playback.
+        pInstance->setTempo(0.1);
+        pInstance->setTempo(m_dTempoRatio);
+    }
     clear();
 }
 
 void EngineBufferScaleST::clear() {
-    m_pSoundTouch->clear();
+    for (auto& pInstance : m_pInstances) {
+        pInstance->clear();
+    }
 
     // compensate seek offset for a rate of 1.0
     if (SoundTouch::getVersionId() < 20302) {
@@ -119,8 +183,79 @@ void EngineBufferScaleST::clear() {
         // from SoundTouch 2.3.0 the initial offset is corrected internally
         m_effectiveRate = m_dBaseRate * m_dTempoRatio;
         SampleUtil::clear(m_bufferBack.data(), m_bufferBack.size());
-        m_pSoundTouch->putSamples(m_bufferBack.data(), kSeekOffsetFramesV20101);
+        for (auto& pInstance : m_pInstances) {
+            pInstance->putSamples(m_bufferBack.data(), kSeekOffsetFramesV20101);
+        }
+    }
+}
+
+void EngineBufferScaleST::putSamples(SINT frames) {
+    DEBUG_ASSERT(frames > 0 && frames <= kBackBufferFrameSize);
+    if (m_pInstances.size() == 1) {
+        m_pInstances[0]->putSamples(m_bufferBack.data(), frames);
+        return;
+    }
+
+    const SINT blockSize = kBackBufferFrameSize * m_channelPerWorker;
+    splitChannels(m_bufferWorkers.data(),
+            m_bufferBack.data(),
+            frames,
+            getOutputSignal().getChannelCount(),
+            m_channelPerWorker,
+            blockSize);
+
+    SoundTouchWorkerPool* pPool = SoundTouchWorkerPool::instance();
+    const CSAMPLE* pInput = m_bufferWorkers.data();
+    for (auto& pInstance : m_pInstances) {
+        pInstance->set(pInput, frames);
+        // The engine thread processes the instance itself if no worker
+        // is available
+        if (!pPool->tryStart(pInstance.get())) {
+            pInstance->run();
+        }
+        pInput += blockSize;
+    }
+    // We always perform a wait, even for tasks that were run in the engine
+    // thread, so it resets the semaphore
+    for (auto& pInstance : m_pInstances) {
+        pInstance->waitReady();
+    }
+}
+
+SINT EngineBufferScaleST::receiveSamples(CSAMPLE* pOutput, SINT maxFrames) {
+    if (m_pInstances.size() == 1) {
+        return m_pInstances[0]->receiveSamples(pOutput, maxFrames);
+    }
+
+    // All instances process the same number of frames with the same
+    // parameters and are supposed to be in lockstep.
+    SINT frames = maxFrames;
+    for (const auto& pInstance : m_pInstances) {
+        frames = math_min(frames, static_cast<SINT>(pInstance->numSamples()));
+    }
+
+    const SINT blockSize = kBackBufferFrameSize * m_channelPerWorker;
+    SINT receivedFrames = 0;
+    while (receivedFrames < frames) {
+        const SINT chunkFrames = math_min(frames - receivedFrames, kBackBufferFrameSize);
+        CSAMPLE* pBlock = m_bufferWorkers.data();
+        for (auto& pInstance : m_pInstances) {
+            const SINT chunkFramesReceived = pInstance->receiveSamples(pBlock, chunkFrames);
+            VERIFY_OR_DEBUG_ASSERT(chunkFramesReceived == chunkFrames) {
+                SampleUtil::clear(pBlock + chunkFramesReceived * m_channelPerWorker,
+                        (chunkFrames - chunkFramesReceived) * m_channelPerWorker);
+            }
+            pBlock += blockSize;
+        }
+        mergeChannels(pOutput + getOutputSignal().frames2samples(receivedFrames),
+                m_bufferWorkers.data(),
+                chunkFrames,
+                getOutputSignal().getChannelCount(),
+                m_channelPerWorker,
+                blockSize);
+        receivedFrames += chunkFrames;
     }
+    return frames;
 }
 
 double EngineBufferScaleST::scaleBuffer(
@@ -138,8 +273,7 @@ double EngineBufferScaleST::scaleBuffer(
     CSAMPLE* read = pOutputBuffer;
     bool last_read_failed = false;
     while (remaining_frames > 0) {
-        SINT received_frames = m_pSoundTouch->receiveSamples(
-                read, remaining_frames);
+        SINT received_frames = receiveSamples(read, remaining_frames);
         DEBUG_ASSERT(remaining_frames >= received_frames);
         remaining_frames -= received_frames;
         readFramesProcessed += m_effectiveRate * received_frames;
@@ -159,7 +293,7 @@ double EngineBufferScaleST::scaleBuffer(
 
             if (iAvailFrames > 0) {
                 last_read_failed = false;
-                m_pSoundTouch->putSamples(m_bufferBack.data(), iAvailFrames);
+                putSamples(iAvailFrames);
             } else {
                 // We may get 0 samples once if we just hit a loop trigger, e.g.
                 // when reloop_toggle jumps back to loop_in, or when moving a
@@ -167,12 +301,12 @@ double EngineBufferScaleST::scaleBuffer(
                 if (last_read_failed) {
                     // If we get 0 samples repeatedly, add silence that allows
                     // to flush the last samples out of Soundtouch.
-                    // m_pSoundTouch->flush() must not be used, because it allocates
+                    // SoundTouch::flush() must not be used, because it allocates
                     // a temporary buffer in the heap which maybe locking
                     qDebug() << "ReadAheadManager::getNextSamples() returned "
                                 "zero samples repeatedly. Padding with silence.";
                     SampleUtil::clear(m_bufferBack.data(), m_bufferBack.size());
-                    m_pSoundTouch->putSamples(m_bufferBack.data(), m_bufferBack.size());
+                    putSamples(kBackBufferFrameSize);
                 }
                 last_read_failed = true;
             }
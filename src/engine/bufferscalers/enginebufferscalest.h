@@ -1,17 +1,17 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "engine/bufferscalers/enginebufferscale.h"
 #include "util/samplebuffer.h"
 
 class ReadAheadManager;
+class SoundTouchTask;
 
-namespace soundtouch {
-class SoundTouch;
-}  // namespace soundtouch
-
-// Uses libsoundtouch to scale audio.
+// Uses libsoundtouch to scale audio. The channels are distributed among
+// multiple SoundTouch instances that are processed in parallel by the
+// SoundTouchWorkerPool.
 class EngineBufferScaleST : public EngineBufferScale {
     Q_OBJECT
   public:
@@ -34,15 +34,29 @@ class EngineBufferScaleST : public EngineBufferScale {
   private:
     void onSignalChanged() override;
 
+    /// Applies the current scale parameters to a new SoundTouch instance
+    void initInstance(SoundTouchTask* pInstance) const;
+
+    /// Processes the first frames of m_bufferBack by all instances
+    void putSamples(SINT frames);
+
+    /// Fetches up to maxFrames processed frames that are available from
+    /// all instances and returns the number of frames written to pOutput.
+    SINT receiveSamples(CSAMPLE* pOutput, SINT maxFrames);
+
     // The read-ahead manager that we use to fetch samples
     ReadAheadManager* m_pReadAheadManager;
 
-    // SoundTouch time/pitch scaling lib
-    std::unique_ptr<soundtouch::SoundTouch> m_pSoundTouch;
+    // SoundTouch time/pitch scaling lib, one instance per channel group
+    std::vector<std::unique_ptr<SoundTouchTask>> m_pInstances;
+    mixxx::audio::ChannelCount m_channelPerWorker;
 
     // Temporary buffer for reading from the RAMAN.
     mixxx::SampleBuffer m_bufferBack;
 
+    // The channels of m_bufferBack split into one block per instance
+    mixxx::SampleBuffer m_bufferWorkers;
+
     // Holds the playback direction.
     bool m_bBackwards;
 };
@@ -0,0 +1,33 @@
+#include "engine/bufferscalers/soundtouchtask.h"
+
+#include "util/assert.h"
+
+SoundTouchTask::SoundTouchTask()
+        : soundtouch::SoundTouch(),
+          QRunnable(),
+          m_completedSema(0),
+          m_pInput(nullptr),
+          m_frames(0) {
+    setAutoDelete(false);
+}
+
+void SoundTouchTask::set(const CSAMPLE* pInput, SINT frames) {
+    DEBUG_ASSERT(m_completedSema.available() == 0);
+    m_pInput = pInput;
+    m_frames = frames;
+}
+
+void SoundTouchTask::waitReady() {
+    VERIFY_OR_DEBUG_ASSERT(m_pInput && m_frames) {
+        return;
+    };
+    m_completedSema.acquire();
+}
+
+void SoundTouchTask::run() {
+    VERIFY_OR_DEBUG_ASSERT(m_completedSema.available() == 0 && m_pInput && m_frames) {
+        return;
+    };
+    putSamples(m_pInput, static_cast<soundtouch::uint>(m_frames));
+    m_completedSema.release();
+}
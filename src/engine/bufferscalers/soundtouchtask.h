@@ -0,0 +1,32 @@
+#pragma once
+
+// Fixes redefinition warnings from SoundTouch.
+#include <soundtouch/SoundTouch.h>
+
+#include <QRunnable>
+#include <QSemaphore>
+
+#include "util/types.h"
+
+/// A SoundTouch instance that processes its input frames either in a
+/// SoundTouchWorkerPool thread or in the engine thread.
+class SoundTouchTask : public soundtouch::SoundTouch, public QRunnable {
+  public:
+    SoundTouchTask();
+
+    /// Set the interleaved frames for the next run(). The buffer must
+    /// remain valid until waitReady() has returned.
+    void set(const CSAMPLE* pInput, SINT frames);
+
+    /// Wait for the current task to complete.
+    void waitReady();
+
+    void run() override;
+
+  private:
+    // Released when the scheduled job has completed
+    QSemaphore m_completedSema;
+
+    const CSAMPLE* m_pInput;
+    SINT m_frames;
+};
@@ -0,0 +1,48 @@
+#include "engine/bufferscalers/soundtouchworkerpool.h"
+
+#include "engine/engine.h"
+#include "util/assert.h"
+
+SoundTouchWorkerPool::SoundTouchWorkerPool(UserSettingsPointer pConfig)
+        : QThreadPool() {
+    bool multiThreadedOnStereo = pConfig &&
+            pConfig->getValue(ConfigKey(QStringLiteral("[App]"),
+                                      QStringLiteral("keylock_multithreading")),
+                    false);
+    m_channelPerWorker = multiThreadedOnStereo
+            ? mixxx::audio::ChannelCount::mono()
+            : mixxx::audio::ChannelCount::stereo();
+    DEBUG_ASSERT(mixxx::kMaxEngineChannelInputCount % m_channelPerWorker == 0);
+
+    int numCore = QThread::idealThreadCount();
+    int numSTTasks = qMin(numCore, mixxx::kMaxEngineChannelInputCount / m_channelPerWorker);
+
+    qDebug() << "SoundTouch will use" << numSTTasks << "tasks to scale the audio signal";
+
+    setThreadPriority(QThread::HighPriority);
+    // The engine thread always processes the last instance itself instead
+    // of idling while waiting for the workers.
+    setMaxThreadCount(numSTTasks - 1);
+    for (int w = 0; w < maxThreadCount(); w++) {
+        reserveThread();
+    }
+}
+
+mixxx::audio::ChannelCount SoundTouchWorkerPool::channelPerWorker(
+        mixxx::audio::ChannelCount channelCount) const {
+    // The task count includes all the threads in the pool + the engine thread
+    const int maxTaskCount = maxThreadCount() + 1;
+    VERIFY_OR_DEBUG_ASSERT(channelCount % m_channelPerWorker == 0) {
+        return channelCount;
+    }
+    const int numTasks = channelCount / m_channelPerWorker;
+    if (numTasks > maxTaskCount) {
+        // Group the channels, so that each task processes the same number
+        // of channels.
+        if (numTasks % maxTaskCount != 0) {
+            return channelCount;
+        }
+        return mixxx::audio::ChannelCount(channelCount / maxTaskCount);
+    }
+    return m_channelPerWorker;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QThreadPool>
+
+#include "audio/types.h"
+#include "preferences/usersettings.h"
+#include "util/singleton.h"
+
+/// SoundTouchWorkerPool is a global pool of workers that share the
+/// time-stretching of the channels of a deck with the engine thread. Stem
+/// decks are always split into stereo pairs, stereo decks are only split into
+/// mono channels if the keylock multi-threading mode is enabled.
+class SoundTouchWorkerPool : public QThreadPool, public Singleton<SoundTouchWorkerPool> {
+  public:
+    /// Returns the number of channels each SoundTouch instance processes
+    /// for a signal with the given channel count
+    mixxx::audio::ChannelCount channelPerWorker(
+            mixxx::audio::ChannelCount channelCount) const;
+
+  protected:
+    SoundTouchWorkerPool(UserSettingsPointer pConfig = nullptr);
+
+  private:
+    mixxx::audio::ChannelCount m_channelPerWorker;
+
+    friend class Singleton<SoundTouchWorkerPool>;
+};
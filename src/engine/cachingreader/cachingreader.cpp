@@ -1,12 +1,14 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <cstdlib>
 
+#include "control/controlobject.h"
 #include "moc_cachingreader.cpp"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
-#include "util/counter.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/sample.h"
 
 namespace {
@@ -18,22 +20,43 @@ mixxx::Logger kLogger("CachingReader");
 // TODO() Do we suffer cache misses if we use an audio buffer of above 23 ms?
 constexpr SINT kDefaultHintFrames = 1024;
 
-// With CachingReaderChunk::kFrames = 8192 each chunk consumes
-// 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB for stereo frame.
-//
-//     80 chunks ->  5120 KB =  5 MB
-//
-// Each deck (including sample decks) will use their own CachingReader.
-// Consequently the total memory required for all allocated chunks depends
-// on the number of decks. The amount of memory reserved for a single
-// CachingReader must be multiplied by the number of decks to calculate
-// the total amount!
-//
-// NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
-// to verify that the MRU/LRU cache works as expected. Even though
-// massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+// The FIFO capacities are independent of the actual size of the chunk pool.
+constexpr SINT kChunkReadRequestFIFOSize = CachingReaderWorker::kDefaultNumCachedChunks / 4;
+constexpr SINT kReaderStatusUpdateFIFOSize = CachingReaderWorker::kDefaultNumCachedChunks;
+
+// Only a few chunks of a resident track are prefetched at once to leave
+// enough room in the FIFOs for reading chunks that are needed immediately.
+constexpr SINT kMaxPendingPrefetchChunks = kChunkReadRequestFIFOSize / 2;
+
+// Number of pools that might be waiting for deletion by the worker
+constexpr SINT kRetiredChunkPoolFIFOSize = 16;
+
+// The current position hint covers the chunk at the playhead and the
+// following chunks that are read ahead. Moving further than this is
+// considered a jump.
+constexpr SINT kMaxPlayPositionChunkIndexDelta = 2;
+
+CachingReaderChunk::ReadPriority readPriorityForHint(Hint::Type type) {
+    switch (type) {
+    case Hint::Type::SlipPosition:
+    case Hint::Type::CurrentPosition:
+        return CachingReaderChunk::ReadPriority::PlayPosition;
+    case Hint::Type::LoopStartEnabled:
+    case Hint::Type::LoopEndEnabled:
+        return CachingReaderChunk::ReadPriority::ActiveLoop;
+    case Hint::Type::MainCue:
+    case Hint::Type::HotCue:
+    case Hint::Type::LoopStart:
+        return CachingReaderChunk::ReadPriority::Cue;
+    case Hint::Type::FirstSound:
+    case Hint::Type::IntroStart:
+    case Hint::Type::IntroEnd:
+    case Hint::Type::OutroStart:
+        return CachingReaderChunk::ReadPriority::Marker;
+    }
+    DEBUG_ASSERT(!"unreachable code");
+    return CachingReaderChunk::ReadPriority::Marker;
+}
 
 } // anonymous namespace
 
@@ -50,34 +73,44 @@ CachingReader::CachingReader(const QString& group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
-          // The capacity of the back channel must be equal to the number of
-          // allocated chunks, because the worker use writeBlocking(). Otherwise
-          // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_chunkReadRequestFIFO(kChunkReadRequestFIFOSize),
+          // The capacity of the back channel must exceed the number of
+          // chunks that are pending at any time, because the worker use
+          // writeBlocking(). Otherwise the worker could get stuck in a hot
+          // loop!!! Pending chunks are limited by the capacity of the request
+          // FIFO and prefetching, not by the actual size of the chunk pool.
+          m_readerStatusUpdateFIFO(kReaderStatusUpdateFIFOSize),
+          m_retiredChunkPoolFIFO(kRetiredChunkPoolFIFOSize),
           m_state(STATE_IDLE),
+          m_pChunkPool(nullptr),
+          m_pPendingChunkPool(nullptr),
+          m_numReadPendingChunks(0),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
-                  kNumberOfCachedChunksInMemory),
+          m_nextPrefetchChunkIndex(0),
+          m_playPositionChunkIndex(kInvalidPlayPositionChunkIndex),
+          m_playPositionEpoch(0),
+          m_cacheMissCounter(QStringLiteral("CachingReader %1 cache miss").arg(group)),
+          m_cacheSilenceFramesCounter(
+                  QStringLiteral("CachingReader %1 silence frames").arg(group)),
           m_worker(group,
+                  m_pConfig,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
+                  &m_retiredChunkPoolFIFO,
                   maxSupportedChannel) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kFrames * maxSupportedChannel * i,
-                                CachingReaderChunk::kFrames * maxSupportedChannel));
-        m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
-    }
+    m_pChunkPool = m_worker.createInitialChunkPool();
+
+    // Number of reads that could not be served, because the first
+    // required chunk was not cached yet
+    m_pCacheMissCount = std::make_unique<ControlObject>(
+            ConfigKey(group, QStringLiteral("cache_miss_count")));
+    m_pCacheMissCount->setReadOnly();
+    // Number of frames that have been replaced by silence, because the
+    // audio data was not cached or could not be decoded
+    m_pCacheSilenceFrames = std::make_unique<ControlObject>(
+            ConfigKey(group, QStringLiteral("cache_silence_frames")));
+    m_pCacheSilenceFrames->setReadOnly();
 
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
@@ -95,7 +128,20 @@ CachingReader::CachingReader(const QString& group,
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
-    qDeleteAll(m_chunks);
+    m_worker.deleteRetiredChunkPools();
+    // Delete new pools that have not been received yet
+    ReaderStatusUpdate update;
+    while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
+        delete update.takeChunkPool();
+    }
+    delete m_pPendingChunkPool;
+    delete m_pChunkPool;
+}
+
+void CachingReader::reportSilenceFrames(SINT frames) {
+    DEBUG_ASSERT(frames > 0);
+    m_pCacheSilenceFrames->forceSet(m_pCacheSilenceFrames->get() + frames);
+    m_cacheSilenceFramesCounter.increment(static_cast<int>(frames));
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -103,14 +149,14 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    m_pChunkPool->putFreeChunk(pChunk);
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
     DEBUG_ASSERT(pChunk);
     DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
 
-    const int removed = m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
+    const int removed = m_pChunkPool->removeAllocatedChunk(pChunk);
     Q_UNUSED(removed); // only used in DEBUG_ASSERT
     // We'll tolerate not being in allocatedCachingReaderChunks,
     // because sometime you free a chunk right after you allocated it.
@@ -120,33 +166,33 @@ void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
 }
 
 void CachingReader::freeAllChunks() {
-    for (const auto& pChunk : std::as_const(m_chunks)) {
-        // We will receive CHUNK_READ_INVALID for all pending chunk reads
-        // which should free the chunks individually.
-        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+    for (const auto& pChunk : m_pChunkPool->chunks()) {
+        // Pending chunks are removed from the index, but remain in the
+        // possession of the worker. We will receive CHUNK_READ_INVALID
+        // for all pending chunk reads which should free the chunks
+        // individually.
+        if (pChunk->getState() == CachingReaderChunkForOwner::FREE) {
             continue;
         }
-
-        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
-            freeChunkFromList(pChunk);
+        m_pChunkPool->removeAllocatedChunk(pChunk);
+        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            continue;
         }
+        freeChunkFromList(pChunk);
     }
     DEBUG_ASSERT(!m_mruCachingReaderChunk);
     DEBUG_ASSERT(!m_lruCachingReaderChunk);
-
-    m_allocatedCachingReaderChunks.clear();
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
+    CachingReaderChunkForOwner* pChunk = m_pChunkPool->takeFreeChunk();
+    if (!pChunk) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
 
     pChunk->init(chunkIndex);
 
-    m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+    m_pChunkPool->insertAllocatedChunk(pChunk);
 
     return pChunk;
 }
@@ -167,9 +213,98 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     return pChunk;
 }
 
+bool CachingReader::submitReadRequest(CachingReaderChunkForOwner* pChunk,
+        CachingReaderChunk::ReadPriority priority) {
+    pChunk->initReadPriority(priority, m_playPositionEpoch);
+    // Do not insert the allocated chunk into the MRU/LRU list,
+    // because it will be handed over to the worker immediately
+    CachingReaderChunkReadRequest request;
+    request.giveToWorker(pChunk);
+    if (kLogger.traceEnabled()) {
+        kLogger.trace()
+                << "Requesting read of chunk"
+                << request.chunk;
+    }
+    if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+        kLogger.warning()
+                << "Failed to submit read request for chunk"
+                << pChunk->getIndex();
+        // Revoke the chunk from the worker and free it
+        pChunk->takeFromWorker();
+        freeChunk(pChunk);
+        return false;
+    }
+    ++m_numReadPendingChunks;
+    return true;
+}
+
+void CachingReader::adoptChunkPool(CachingReaderChunkPool* pChunkPool) {
+    DEBUG_ASSERT(pChunkPool);
+    DEBUG_ASSERT(!m_mruCachingReaderChunk);
+    DEBUG_ASSERT(!m_lruCachingReaderChunk);
+    if (m_numReadPendingChunks > 0) {
+        // Chunks of the current pool that are still pending would become
+        // dangling. The worker already reads the new track with the new
+        // pool in mind, so it must not be discarded. It is adopted after
+        // the worker has returned all pending chunks.
+        if (m_pPendingChunkPool) {
+            // Superseded before it has ever been used
+            retireChunkPool(m_pPendingChunkPool);
+        }
+        m_pPendingChunkPool = pChunkPool;
+        return;
+    }
+    retireChunkPool(m_pChunkPool);
+    m_pChunkPool = pChunkPool;
+}
+
+void CachingReader::retireChunkPool(CachingReaderChunkPool* pChunkPool) {
+    // Pools are never deleted on the engine thread
+    VERIFY_OR_DEBUG_ASSERT(m_retiredChunkPoolFIFO.write(&pChunkPool, 1) == 1) {
+        // Should never happen, because the worker deletes retired pools
+        // before loading the next track. Leak the pool rather than
+        // freeing memory on the engine thread.
+        kLogger.critical()
+                << "Failed to retire chunk pool"
+                << pChunkPool;
+    }
+}
+
+bool CachingReader::prefetchResidentChunks() {
+    if (!m_pChunkPool->isResident() || m_readableFrameIndexRange.empty()) {
+        return false;
+    }
+    const SINT lastChunkIndex =
+            CachingReaderChunk::indexForFrame(m_readableFrameIndexRange.end() - 1);
+    bool requested = false;
+    while (m_nextPrefetchChunkIndex <= lastChunkIndex &&
+            m_numReadPendingChunks < kMaxPendingPrefetchChunks) {
+        const SINT chunkIndex = m_nextPrefetchChunkIndex++;
+        if (lookupChunk(chunkIndex)) {
+            // Already cached or pending
+            continue;
+        }
+        // A resident track never needs to evict any chunks
+        CachingReaderChunkForOwner* pChunk = allocateChunk(chunkIndex);
+        VERIFY_OR_DEBUG_ASSERT(pChunk) {
+            kLogger.warning()
+                    << "Failed to allocate chunk"
+                    << chunkIndex
+                    << "for prefetching";
+            return requested;
+        }
+        if (!submitReadRequest(pChunk, CachingReaderChunk::ReadPriority::Prefetch)) {
+            // Retry with the next callback
+            --m_nextPrefetchChunkIndex;
+            return requested;
+        }
+        requested = true;
+    }
+    return requested;
+}
+
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    auto* pChunk = m_pChunkPool->lookupAllocatedChunk(chunkIndex);
     DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
     return pChunk;
 }
@@ -229,6 +364,8 @@ void CachingReader::process() {
     while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
         auto* pChunk = update.takeFromWorker();
         if (pChunk) {
+            DEBUG_ASSERT(m_numReadPendingChunks > 0);
+            --m_numReadPendingChunks;
             // Result of a read request (with a chunk)
             DEBUG_ASSERT(atomicLoadRelaxed(m_state) != STATE_IDLE);
             DEBUG_ASSERT(
@@ -236,6 +373,16 @@ void CachingReader::process() {
                     update.status == CHUNK_READ_EOF ||
                     update.status == CHUNK_READ_INVALID ||
                     update.status == CHUNK_READ_DISCARDED);
+            if (m_pPendingChunkPool) {
+                // The chunk belongs to the pool that is about to be replaced
+                freeChunk(pChunk);
+                if (m_numReadPendingChunks == 0) {
+                    CachingReaderChunkPool* pChunkPool = m_pPendingChunkPool;
+                    m_pPendingChunkPool = nullptr;
+                    adoptChunkPool(pChunkPool);
+                }
+                continue;
+            }
             if (m_state.loadAcquire() == STATE_TRACK_LOADING) {
                 // Discard all results from pending read requests for the
                 // previous track before the next track has been loaded.
@@ -274,8 +421,15 @@ void CachingReader::process() {
                     DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING);
                     freeAllChunks();
                 }
+                auto* pChunkPool = update.takeChunkPool();
+                if (pChunkPool) {
+                    adoptChunkPool(pChunkPool);
+                }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_nextPrefetchChunkIndex = CachingReaderChunk::indexForFrame(
+                        m_readableFrameIndexRange.start());
+                m_playPositionChunkIndex = kInvalidPlayPositionChunkIndex;
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
@@ -329,6 +483,10 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return ReadResult::UNAVAILABLE;
     }
+    // The chunks of the current pool might not be suitable for the track
+    if (m_pPendingChunkPool) {
+        return ReadResult::UNAVAILABLE;
+    }
 
     // If asked to read 0 samples, don't do anything. (this is a perfectly
     // reasonable request that happens sometimes.
@@ -461,7 +619,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    m_pCacheMissCount->forceSet(m_pCacheMissCount->get() + 1);
+                    m_cacheMissCounter.increment();
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -477,9 +636,16 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                         // We have not read a single frame caused by a cache miss of
                         // the first required chunk. Inform the calling code that no
                         // data has been written into the buffer and to handle this
-                        // situation appropriately.
+                        // situation appropriately. The caller will fill the buffer
+                        // with silence.
+                        reportSilenceFrames(CachingReaderChunk::samples2frames(
+                                numSamples, channelCount));
                         return ReadResult::UNAVAILABLE;
                     }
+                    // Count the missing frames that will be filled with
+                    // silence below
+                    reportSilenceFrames(CachingReaderChunk::samples2frames(
+                            samplesRemaining, channelCount));
                     // No more readable data available. Exit the loop and
                     // finally fill the remaining buffer with silence.
                     break;
@@ -496,6 +662,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                             << "frames of silence for unreadable audio data";
                     SINT paddingSamples = CachingReaderChunk::frames2samples(
                             paddingFrameIndexRange.length(), channelCount);
+                    reportSilenceFrames(paddingFrameIndexRange.length());
                     DEBUG_ASSERT(samplesRemaining >= paddingSamples);
                     if (reverse) {
                         SampleUtil::clear(&buffer[samplesRemaining - paddingSamples], paddingSamples);
@@ -533,12 +700,38 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return;
     }
+    // Wait until the chunk pool for the track has been adopted
+    if (m_pPendingChunkPool) {
+        return;
+    }
 
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
 
+    // Start a new epoch when the playhead jumps. Chunks for the previous
+    // play position that are still pending and not hinted again will be
+    // discarded by the worker instead of delaying the chunks that are
+    // needed now.
+    int playPositionEpoch = m_playPositionEpoch;
+    for (const auto& hint : hintList) {
+        if (hint.type != Hint::Type::CurrentPosition) {
+            continue;
+        }
+        const SINT chunkIndex = CachingReaderChunk::indexForFrame(
+                math_max(hint.frame, SINT(0)));
+        if (m_playPositionChunkIndex != kInvalidPlayPositionChunkIndex &&
+                std::abs(chunkIndex - m_playPositionChunkIndex) >
+                        kMaxPlayPositionChunkIndexDelta) {
+            ++playPositionEpoch;
+        }
+        m_playPositionChunkIndex = chunkIndex;
+        break;
+    }
+    m_playPositionEpoch = playPositionEpoch;
+
     for (const auto& hint: hintList) {
+        const auto priority = readPriorityForHint(hint.type);
         SINT hintFrame = hint.frame;
         SINT hintFrameCount = hint.frameCount;
 
@@ -583,31 +776,28 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                             << "for read request";
                     continue;
                 }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                if (kLogger.traceEnabled()) {
-                    kLogger.trace()
-                            << "Requesting read of chunk"
-                            << request.chunk;
-                }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning()
-                            << "Failed to submit read request for chunk"
-                            << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
-                }
+                submitReadRequest(pChunk, priority);
             } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
                 // This will cause the chunk to be 'freshened' in the cache. The
                 // chunk will be moved to the end of the LRU list.
                 freshenChunk(pChunk);
+            } else {
+                // The chunk is still needed and must not become stale.
+                pChunk->raiseReadPriority(priority, m_playPositionEpoch);
             }
         }
     }
 
+    // Use the remaining capacity for reading a resident track in the
+    // background after all hints have been served.
+    if (prefetchResidentChunks()) {
+        shouldWake = true;
+    }
+
+    // Publish the epoch after all pending chunks that are still needed
+    // have been renewed.
+    m_worker.setPlayPositionEpoch(m_playPositionEpoch);
+
     // If there are chunks to be read, wake up.
     if (shouldWake) {
         m_worker.workReady();
@@ -5,30 +5,35 @@
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
-#include <list>
+#include <memory>
 
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
+#include "util/counter.h"
 #include "util/fifo.h"
 #include "util/types.h"
 
+class ControlObject;
+
 // A Hint is an indication to the CachingReader that a certain section of a
 // SoundSource will be used 'soon' and so it should be brought into memory by
 // the reader work thread.
 typedef struct Hint {
+    // The type determines the priority for reading missing chunks
+    // (see CachingReaderChunk::ReadPriority)
     enum class Type {
-        SlipPosition,     // prio 1 (so far unused Mixxx 2.3 priority for reference)
-        CurrentPosition,  // prio 1
-        LoopStartEnabled, // prio 2
-        MainCue,          // prio 10
-        HotCue,           // prio 10
-        LoopEndEnabled,   // prio 10
-        LoopStart,        // prio 10
-        FirstSound,
-        IntroStart,
-        IntroEnd,
-        OutroStart
+        SlipPosition,     // PlayPosition
+        CurrentPosition,  // PlayPosition
+        LoopStartEnabled, // ActiveLoop
+        MainCue,          // Cue
+        HotCue,           // Cue
+        LoopEndEnabled,   // ActiveLoop
+        LoopStart,        // Cue
+        FirstSound,       // Marker
+        IntroStart,       // Marker
+        IntroEnd,         // Marker
+        OutroStart        // Marker
     };
 
     // The frame to ensure is present in memory.
@@ -36,8 +41,7 @@ typedef struct Hint {
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others.
+    // Used to prioritize certain hints over others.
     Type type;
 
     // for the default frame count in forward direction
@@ -68,7 +72,9 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // indicating which chunks should be kept fresh in the cache (see
 // hintAndMaybeWake). For example, the chunks around the playhead, the hotcue
 // positions, and loop points are all portions of the track that the user is
-// likely to dynamically jump to so we should keep them ready.
+// likely to dynamically jump to so we should keep them ready. Missing chunks
+// are read in the order of the hint priorities and pending reads for the
+// previous play position are cancelled when the playhead jumps.
 //
 // The least recently used policy is implemented by keeping a linked list of the
 // least recently used chunks. When a chunk is "freshened" (i.e. accessed via
@@ -76,6 +82,11 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// The number of cached chunks is configurable. Optionally the cache is
+// enlarged when loading a track to keep the whole track resident in memory.
+// In this case the chunks of the track are prefetched in the background
+// and the cache never needs to evict any of them.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -138,6 +149,8 @@ class CachingReader : public QObject {
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    // Chunk pools that are returned to the worker for deletion
+    FIFO<CachingReaderChunkPool*> m_retiredChunkPoolFIFO;
 
     // Looks for the provided chunk number in the index of in-memory chunks and
     // returns it if it is present. If not, returns nullptr. If it is present then
@@ -158,12 +171,32 @@ class CachingReader : public QObject {
     // Returns all allocated chunks to the free list
     void freeAllChunks();
 
+    // Accounts frames that have been filled with silence, because audio
+    // data was not available.
+    void reportSilenceFrames(SINT frames);
+
     // Gets a chunk from the free list. Returns nullptr if none available.
     CachingReaderChunkForOwner* allocateChunk(SINT chunkIndex);
 
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Hands a chunk over to the worker for reading. Returns false if
+    // the request could not be submitted.
+    bool submitReadRequest(CachingReaderChunkForOwner* pChunk,
+            CachingReaderChunk::ReadPriority priority);
+
+    // Replaces the current chunk pool after all chunks have been freed.
+    // While chunks are still pending the new pool is adopted after the
+    // worker has returned all of them.
+    void adoptChunkPool(CachingReaderChunkPool* pChunkPool);
+    // Hands a chunk pool back to the worker for deletion.
+    void retireChunkPool(CachingReaderChunkPool* pChunkPool);
+
+    // Requests chunks of a resident track that have not been read yet.
+    // Returns true if any chunks have been requested.
+    bool prefetchResidentChunks();
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -172,26 +205,40 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
-    // Keeps track of all CachingReaderChunks we've allocated.
-    QVector<CachingReaderChunkForOwner*> m_chunks;
+    // All CachingReaderChunks including the list of free chunks and the
+    // index of allocated chunks by their chunk number.
+    CachingReaderChunkPool* m_pChunkPool;
+    // The pool for the loaded track that replaces m_pChunkPool as soon as
+    // no chunks of m_pChunkPool are pending anymore. Nothing is read or
+    // requested until then.
+    CachingReaderChunkPool* m_pPendingChunkPool;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
-
-    // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
-    // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    // The number of chunks that are currently owned by the worker.
+    SINT m_numReadPendingChunks;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
-
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The next chunk that might need to be prefetched for a resident track.
+    SINT m_nextPrefetchChunkIndex;
+
+    // The chunk at the current play position of the previous callback
+    // and the epoch that is incremented whenever the playhead jumps.
+    static constexpr SINT kInvalidPlayPositionChunkIndex = -1;
+    SINT m_playPositionChunkIndex;
+    int m_playPositionEpoch;
+
+    // Per-deck telemetry, both as controls and for StatsManager
+    std::unique_ptr<ControlObject> m_pCacheMissCount;
+    std::unique_ptr<ControlObject> m_pCacheSilenceFrames;
+    Counter m_cacheMissCounter;
+    Counter m_cacheSilenceFramesCounter;
+
     CachingReaderWorker m_worker;
+
+    friend class CachingReaderTest;
 };
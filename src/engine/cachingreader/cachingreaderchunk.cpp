@@ -19,6 +19,8 @@ constexpr SINT kInvalidChunkIndex = -1;
 CachingReaderChunk::CachingReaderChunk(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : m_index(kInvalidChunkIndex),
+          m_readPriority(ReadPriority::Prefetch),
+          m_readEpoch(0),
           m_sampleBuffer(std::move(sampleBuffer)) {
 }
 
@@ -49,9 +51,8 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
     DEBUG_ASSERT(m_index != kInvalidChunkIndex);
     const auto sourceFrameIndexRange = frameIndexRange(pAudioSource);
 
-    if (pAudioSource->getSignalInfo().getChannelCount() %
-                    mixxx::audio::ChannelCount::stereo() !=
-            0) {
+    if (bufferedChannelCount(pAudioSource->getSignalInfo().getChannelCount()) !=
+            pAudioSource->getSignalInfo().getChannelCount()) {
         // This happens if the audio source only contain a mono channel, or an
         // odd number of channel
         mixxx::AudioSourceStereoProxy audioSourceProxy(
@@ -77,6 +78,26 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
     return m_bufferedSampleFrames.frameIndexRange();
 }
 
+mixxx::IndexRange CachingReaderChunk::bufferDecodedSampleFrames(
+        const mixxx::AudioSourcePointer& pAudioSource,
+        const CSAMPLE* pDecodedSamples) {
+    DEBUG_ASSERT(m_index != kInvalidChunkIndex);
+    DEBUG_ASSERT(pDecodedSamples);
+    const auto sourceFrameIndexRange = frameIndexRange(pAudioSource);
+    const SINT sampleCount = frames2samples(
+            sourceFrameIndexRange.length(),
+            bufferedChannelCount(pAudioSource->getSignalInfo().getChannelCount()));
+    VERIFY_OR_DEBUG_ASSERT(sampleCount <= m_sampleBuffer.length()) {
+        m_bufferedSampleFrames = mixxx::ReadableSampleFrames();
+        return mixxx::IndexRange();
+    }
+    SampleUtil::copy(m_sampleBuffer.data(), pDecodedSamples, sampleCount);
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames(
+            sourceFrameIndexRange,
+            mixxx::SampleBuffer::ReadableSlice(m_sampleBuffer.data(), sampleCount));
+    return sourceFrameIndexRange;
+}
+
 mixxx::IndexRange CachingReaderChunk::readBufferedSampleFrames(
         CSAMPLE* sampleBuffer,
         mixxx::audio::ChannelCount channelCount,
@@ -157,6 +178,23 @@ void CachingReaderChunkForOwner::free() {
     m_state = FREE;
 }
 
+void CachingReaderChunkForOwner::initReadPriority(ReadPriority priority, int epoch) {
+    DEBUG_ASSERT(m_state == READY);
+    m_readPriority.store(priority, std::memory_order_relaxed);
+    m_readEpoch.store(epoch, std::memory_order_relaxed);
+}
+
+void CachingReaderChunkForOwner::raiseReadPriority(ReadPriority priority, int epoch) {
+    DEBUG_ASSERT(m_state == READ_PENDING);
+    // The worker might observe the epoch and the priority in any order.
+    // Worst case a request is discarded unnecessarily and will be
+    // submitted again with the next callback.
+    m_readEpoch.store(epoch, std::memory_order_relaxed);
+    if (priority < getReadPriority()) {
+        m_readPriority.store(priority, std::memory_order_relaxed);
+    }
+}
+
 void CachingReaderChunkForOwner::insertIntoListBefore(
         CachingReaderChunkForOwner** ppHead,
         CachingReaderChunkForOwner** ppTail,
@@ -256,3 +294,65 @@ void CachingReaderChunkForOwner::removeFromList(
         }
     }
 }
+
+CachingReaderChunkPool::CachingReaderChunkPool(
+        SINT numChunks,
+        mixxx::audio::ChannelCount channelCount,
+        bool resident)
+        : m_channelCount(channelCount),
+          m_resident(resident),
+          m_sampleBuffer(CachingReaderChunk::kFrames * channelCount * numChunks) {
+    DEBUG_ASSERT(numChunks > 0);
+    m_chunks.reserve(numChunks);
+    m_freeChunks.reserve(numChunks);
+    m_allocatedChunks.reserve(numChunks);
+    // Divide up the allocated raw memory buffer into numChunks
+    // chunks. Initialize each chunk to hold nothing and add it to
+    // the free list.
+    for (SINT i = 0; i < numChunks; ++i) {
+        auto* pChunk = new CachingReaderChunkForOwner(
+                mixxx::SampleBuffer::WritableSlice(
+                        m_sampleBuffer,
+                        CachingReaderChunk::kFrames * channelCount * i,
+                        CachingReaderChunk::kFrames * channelCount));
+        m_chunks.push_back(pChunk);
+    }
+    // Push in reverse order to hand out the chunks in ascending
+    // memory order
+    for (SINT i = numChunks - 1; i >= 0; --i) {
+        m_freeChunks.push_back(m_chunks[i]);
+    }
+}
+
+CachingReaderChunkPool::~CachingReaderChunkPool() {
+    qDeleteAll(m_chunks);
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkPool::takeFreeChunk() {
+    if (m_freeChunks.isEmpty()) {
+        return nullptr;
+    }
+    return m_freeChunks.takeLast();
+}
+
+void CachingReaderChunkPool::putFreeChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    DEBUG_ASSERT(m_freeChunks.size() < m_chunks.size());
+    m_freeChunks.push_back(pChunk);
+}
+
+void CachingReaderChunkPool::insertAllocatedChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    m_allocatedChunks.insert(pChunk->getIndex(), pChunk);
+}
+
+int CachingReaderChunkPool::removeAllocatedChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    const auto it = m_allocatedChunks.find(pChunk->getIndex());
+    if (it == m_allocatedChunks.end() || it.value() != pChunk) {
+        return 0;
+    }
+    m_allocatedChunks.erase(it);
+    return 1;
+}
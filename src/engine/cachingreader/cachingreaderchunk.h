@@ -1,5 +1,9 @@
 #pragma once
 
+#include <QHash>
+#include <QVector>
+#include <atomic>
+
 #include "sources/audiosource.h"
 
 // A Chunk is a memory-resident section of audio that has been cached.
@@ -9,7 +13,8 @@
 // The class is not thread-safe although it is shared between CachingReader
 // and CachingReaderWorker! A lock-free FIFO ensures that only a single
 // thread has exclusive access on each chunk. This abstract base class
-// is available for both the worker thread and the cache.
+// is available for both the worker thread and the cache. The only exception
+// is the priority of a pending read request that is updated atomically.
 //
 // This is the common (abstract) base class for both the cache (as the owner)
 // and the worker.
@@ -36,6 +41,16 @@ public:
       return samples / channelCount;
   }
 
+    // The number of channels of the sample data that is buffered in
+    // a chunk. Odd channel counts are converted into stereo.
+    static mixxx::audio::ChannelCount bufferedChannelCount(
+            mixxx::audio::ChannelCount sourceChannelCount) {
+        if (sourceChannelCount % mixxx::audio::ChannelCount::stereo() != 0) {
+            return mixxx::audio::ChannelCount::stereo();
+        }
+        return sourceChannelCount;
+    }
+
     // Returns the corresponding chunk index for a frame index
     static SINT indexForFrame(
             /*const mixxx::AudioSourcePointer& pAudioSource,*/
@@ -45,6 +60,16 @@ public:
         return frameIndexOffset / kFrames;
     }
 
+    // The order in which pending chunks are read by the worker, from
+    // highest to lowest priority.
+    enum class ReadPriority : int {
+        PlayPosition, // current and slip position
+        ActiveLoop,   // boundaries of the enabled loop
+        Cue,          // main cue, hotcues and loop start
+        Marker,       // intro/outro and first sound markers
+        Prefetch,     // background reading of resident tracks
+    };
+
     // Disable copy and move constructors
     CachingReaderChunk(const CachingReaderChunk&) = delete;
     CachingReaderChunk(CachingReaderChunk&&) = delete;
@@ -53,6 +78,18 @@ public:
         return m_index;
     }
 
+    ReadPriority getReadPriority() const {
+        return m_readPriority.load(std::memory_order_relaxed);
+    }
+
+    // Read requests for the play position are issued with the current
+    // play position epoch. Those requests become stale when the playhead
+    // jumps and the epoch is incremented, unless the chunk is requested
+    // again with the new epoch.
+    int getReadEpoch() const {
+        return m_readEpoch.load(std::memory_order_relaxed);
+    }
+
     // Frame index range of this chunk for the given audio source.
     mixxx::IndexRange frameIndexRange(
             const mixxx::AudioSourcePointer& pAudioSource) const;
@@ -63,6 +100,12 @@ public:
             const mixxx::AudioSourcePointer& pAudioSource,
             mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
 
+    // Copy sample frames that have been decoded before instead of reading
+    // them from the audio source and return the range of frames.
+    mixxx::IndexRange bufferDecodedSampleFrames(
+            const mixxx::AudioSourcePointer& pAudioSource,
+            const CSAMPLE* pDecodedSamples);
+
     mixxx::IndexRange readBufferedSampleFrames(CSAMPLE* sampleBuffer,
             mixxx::audio::ChannelCount channelCount,
             const mixxx::IndexRange& frameIndexRange) const;
@@ -85,6 +128,10 @@ public:
 
     SINT m_index;
 
+    // Might be modified by the cache while the chunk is pending
+    std::atomic<ReadPriority> m_readPriority;
+    std::atomic<int> m_readEpoch;
+
     // The worker thread will fill the sample buffer and
     // set the corresponding frame index range.
     mixxx::SampleBuffer::WritableSlice m_sampleBuffer;
@@ -103,6 +150,11 @@ public:
   void init(SINT index);
   void free();
 
+  // Sets the priority before handing the chunk over to the worker.
+  void initReadPriority(ReadPriority priority, int epoch);
+  // Raises the priority of a pending chunk and renews its epoch.
+  void raiseReadPriority(ReadPriority priority, int epoch);
+
   enum State {
       FREE,
       READY,
@@ -149,3 +201,72 @@ private:
   CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
   CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
 };
+
+// The memory of all chunks that are owned by a CachingReader. A pool holds
+// a fixed number of chunks that share a single sample buffer.
+//
+// Pools are allocated and deleted by the worker thread. The cache only
+// takes and returns chunks which never allocates any memory. If a track
+// requires a differently sized pool the worker allocates a new one and
+// hands it over to the cache together with the TRACK_LOADED status update.
+// The cache then returns the previous pool back to the worker for deletion.
+class CachingReaderChunkPool {
+  public:
+    // A resident pool is large enough to hold all chunks of the loaded
+    // track at once. The chunks only provide storage for channelCount
+    // channels that must match the sample data of the track.
+    CachingReaderChunkPool(
+            SINT numChunks,
+            mixxx::audio::ChannelCount channelCount,
+            bool resident);
+    ~CachingReaderChunkPool();
+
+    // Disable copy and move constructors
+    CachingReaderChunkPool(const CachingReaderChunkPool&) = delete;
+    CachingReaderChunkPool(CachingReaderChunkPool&&) = delete;
+
+    SINT size() const {
+        return m_chunks.size();
+    }
+
+    mixxx::audio::ChannelCount channelCount() const {
+        return m_channelCount;
+    }
+
+    bool isResident() const {
+        return m_resident;
+    }
+
+    const QVector<CachingReaderChunkForOwner*>& chunks() const {
+        return m_chunks;
+    }
+
+    // Gets a chunk from the free list. Returns nullptr if none available.
+    CachingReaderChunkForOwner* takeFreeChunk();
+    // Returns a chunk that has already been freed to the free list.
+    void putFreeChunk(CachingReaderChunkForOwner* pChunk);
+
+    // Index of all allocated chunks by their chunk index. The capacity
+    // is reserved upfront and never needs to grow.
+    CachingReaderChunkForOwner* lookupAllocatedChunk(SINT chunkIndex) const {
+        // Defaults to nullptr if it's not in the hash.
+        return m_allocatedChunks.value(chunkIndex, nullptr);
+    }
+    void insertAllocatedChunk(CachingReaderChunkForOwner* pChunk);
+    int removeAllocatedChunk(CachingReaderChunkForOwner* pChunk);
+
+  private:
+    const mixxx::audio::ChannelCount m_channelCount;
+    const bool m_resident;
+
+    // The raw memory buffer which is divided up into chunks.
+    mixxx::SampleBuffer m_sampleBuffer;
+
+    QVector<CachingReaderChunkForOwner*> m_chunks;
+
+    // Stack of free chunks. The capacity is reserved for all chunks
+    // so that pushing and popping never (re-)allocates memory.
+    QVector<CachingReaderChunkForOwner*> m_freeChunks;
+
+    QHash<int, CachingReaderChunkForOwner*> m_allocatedChunks;
+};
@@ -0,0 +1,291 @@
+#include "engine/cachingreader/cachingreaderdiskcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <atomic>
+#include <cstring>
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#include <fcntl.h>
+#endif
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderDiskCache");
+
+const QString kFileSuffix = QStringLiteral(".pcm");
+
+constexpr char kMagic[8] = {'M', 'I', 'X', 'X', 'X', 'P', 'C', 'M'};
+
+// Increment when changing the file layout
+// Version 2: Files are fully allocated when created
+constexpr quint32 kVersion = 2;
+
+// The sample data starts at a page boundary
+constexpr qint64 kDataAlignment = 4096;
+
+struct FileHeader {
+    char magic[sizeof(kMagic)];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 chunkFrames;
+    qint64 numChunks;
+};
+
+constexpr qint64 dataOffset(SINT numChunks) {
+    // Header followed by one flag byte per chunk
+    return ((static_cast<qint64>(sizeof(FileHeader)) + numChunks + kDataAlignment - 1) /
+                   kDataAlignment) *
+            kDataAlignment;
+}
+
+qint64 chunkSampleCount(mixxx::audio::ChannelCount channelCount) {
+    return CachingReaderChunk::frames2samples(CachingReaderChunk::kFrames, channelCount);
+}
+
+qint64 fileSize(mixxx::audio::ChannelCount channelCount, SINT numChunks) {
+    return dataOffset(numChunks) +
+            numChunks * chunkSampleCount(channelCount) *
+            static_cast<qint64>(sizeof(CSAMPLE));
+}
+
+FileHeader fileHeader(
+        mixxx::audio::ChannelCount channelCount,
+        mixxx::audio::SampleRate sampleRate,
+        SINT numChunks) {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.channelCount = channelCount.value();
+    header.sampleRate = sampleRate.value();
+    header.chunkFrames = CachingReaderChunk::kFrames;
+    header.numChunks = numChunks;
+    return header;
+}
+
+// Writes a new cache file without any cached chunks under a temporary
+// name and then replaces the file at filePath. Decks that still have the
+// previous file mapped keep their own copy. All blocks of the file are
+// allocated upfront, because writing to a hole of a memory-mapped file
+// raises SIGBUS if the disk is full.
+bool createFile(const QString& filePath, const FileHeader& header, qint64 size) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to create cache file"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    // Header followed by the cleared chunk flags
+    QByteArray headerBlock(static_cast<int>(dataOffset(header.numChunks)), '\0');
+    std::memcpy(headerBlock.data(), &header, sizeof(header));
+    bool allocated = file.write(headerBlock) == headerBlock.size();
+#ifdef Q_OS_LINUX
+    allocated = allocated && file.flush() &&
+            posix_fallocate(file.handle(), 0, size) == 0;
+#else
+#ifdef Q_OS_MACOS
+    // Reserve the remaining blocks beyond the header
+    fstore_t store;
+    std::memset(&store, 0, sizeof(store));
+    store.fst_flags = F_ALLOCATEALL;
+    store.fst_posmode = F_PEOFPOSMODE;
+    store.fst_length = size - headerBlock.size();
+    allocated = allocated && file.flush() &&
+            fcntl(file.handle(), F_PREALLOCATE, &store) != -1;
+#endif
+    // Extend the file without writing the zeros ourselves. On Windows
+    // the blocks of a non-sparse file are allocated by the file system.
+    allocated = allocated && file.resize(size);
+#endif
+    if (!allocated) {
+        kLogger.warning()
+                << "Failed to allocate cache file"
+                << filePath
+                << size
+                << "bytes";
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        kLogger.warning()
+                << "Failed to replace cache file"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+CachingReaderDiskCache::CachingReaderDiskCache(
+        const QString& filePath,
+        mixxx::audio::ChannelCount channelCount,
+        mixxx::audio::SampleRate sampleRate,
+        SINT numChunks)
+        : m_file(filePath),
+          m_channelCount(channelCount),
+          m_sampleRate(sampleRate),
+          m_numChunks(numChunks),
+          m_pMappedData(nullptr),
+          m_pChunkFlags(nullptr),
+          m_pSamples(nullptr) {
+}
+
+CachingReaderDiskCache::~CachingReaderDiskCache() {
+    if (m_pMappedData) {
+        m_file.unmap(m_pMappedData);
+    }
+}
+
+// static
+QString CachingReaderDiskCache::cacheKeyForFile(const mixxx::FileInfo& fileInfo) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.location().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.sizeInBytes()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+// static
+std::unique_ptr<CachingReaderDiskCache> CachingReaderDiskCache::open(
+        const QString& cacheDirPath,
+        const QString& cacheKey,
+        mixxx::audio::ChannelCount channelCount,
+        mixxx::audio::SampleRate sampleRate,
+        const mixxx::IndexRange& frameIndexRange) {
+    VERIFY_OR_DEBUG_ASSERT(channelCount.isValid() && sampleRate.isValid() &&
+            !frameIndexRange.empty() && frameIndexRange.start() >= 0) {
+        return nullptr;
+    }
+    if (!QDir().mkpath(cacheDirPath)) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << cacheDirPath;
+        return nullptr;
+    }
+    const SINT numChunks =
+            CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1) + 1;
+    auto pCache = std::unique_ptr<CachingReaderDiskCache>(
+            new CachingReaderDiskCache(
+                    QDir(cacheDirPath).filePath(cacheKey + kFileSuffix),
+                    channelCount,
+                    sampleRate,
+                    numChunks));
+    if (!pCache->map()) {
+        // Missing or incompatible file, start from scratch. The file is
+        // never truncated in place, because another deck might have it
+        // mapped.
+        if (!createFile(pCache->m_file.fileName(),
+                    fileHeader(channelCount, sampleRate, numChunks),
+                    fileSize(channelCount, numChunks)) ||
+                !pCache->map()) {
+            return nullptr;
+        }
+    }
+    // The modification time determines the order of eviction
+    pCache->m_file.setFileTime(
+            QDateTime::currentDateTimeUtc(),
+            QFileDevice::FileModificationTime);
+    return pCache;
+}
+
+bool CachingReaderDiskCache::map() {
+    DEBUG_ASSERT(!m_pMappedData);
+    const qint64 size = fileSize(m_channelCount, m_numChunks);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly)) {
+        return false;
+    }
+    if (m_file.size() != size) {
+        m_file.close();
+        return false;
+    }
+    m_pMappedData = m_file.map(0, size);
+    if (!m_pMappedData) {
+        kLogger.warning()
+                << "Failed to map cache file"
+                << m_file.fileName()
+                << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    const FileHeader expectedHeader = fileHeader(m_channelCount, m_sampleRate, m_numChunks);
+    if (std::memcmp(m_pMappedData, &expectedHeader, sizeof(expectedHeader)) != 0) {
+        m_file.unmap(m_pMappedData);
+        m_pMappedData = nullptr;
+        m_file.close();
+        return false;
+    }
+    m_pChunkFlags = m_pMappedData + sizeof(FileHeader);
+    m_pSamples = reinterpret_cast<CSAMPLE*>(m_pMappedData + dataOffset(m_numChunks));
+    return true;
+}
+
+bool CachingReaderDiskCache::isChunkCached(SINT chunkIndex) const {
+    VERIFY_OR_DEBUG_ASSERT(chunkIndex >= 0 && chunkIndex < m_numChunks) {
+        return false;
+    }
+    // Pairs with the release store in markChunkCached(), which might have
+    // been done by another deck that has mapped the same file
+    return std::atomic_ref<uchar>(m_pChunkFlags[chunkIndex]).load(std::memory_order_acquire) != 0;
+}
+
+const CSAMPLE* CachingReaderDiskCache::chunkSamples(SINT chunkIndex) const {
+    DEBUG_ASSERT(isChunkCached(chunkIndex));
+    return m_pSamples + chunkIndex * chunkSampleCount(m_channelCount);
+}
+
+CSAMPLE* CachingReaderDiskCache::writableChunkSamples(SINT chunkIndex) {
+    DEBUG_ASSERT(chunkIndex >= 0 && chunkIndex < m_numChunks);
+    return m_pSamples + chunkIndex * chunkSampleCount(m_channelCount);
+}
+
+void CachingReaderDiskCache::markChunkCached(SINT chunkIndex) {
+    VERIFY_OR_DEBUG_ASSERT(chunkIndex >= 0 && chunkIndex < m_numChunks) {
+        return;
+    }
+    // The flag is published after the sample data. Decks that load the
+    // same track concurrently would only write identical data.
+    std::atomic_ref<uchar>(m_pChunkFlags[chunkIndex]).store(1, std::memory_order_release);
+}
+
+// static
+void CachingReaderDiskCache::evictLeastRecentlyUsed(
+        const QString& cacheDirPath,
+        qint64 maxBytes,
+        const QString& keepFilePath) {
+    const QDir cacheDir(cacheDirPath);
+    // Sorted from oldest to newest
+    const QFileInfoList fileInfos = cacheDir.entryInfoList(
+            QStringList{QStringLiteral("*") + kFileSuffix},
+            QDir::Files,
+            QDir::Time | QDir::Reversed);
+    qint64 totalBytes = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalBytes += fileInfo.size();
+    }
+    for (const auto& fileInfo : fileInfos) {
+        if (totalBytes <= maxBytes) {
+            break;
+        }
+        if (fileInfo.absoluteFilePath() == QFileInfo(keepFilePath).absoluteFilePath()) {
+            continue;
+        }
+        if (QFile::remove(fileInfo.absoluteFilePath())) {
+            totalBytes -= fileInfo.size();
+        } else {
+            kLogger.warning()
+                    << "Failed to delete cache file"
+                    << fileInfo.absoluteFilePath();
+        }
+    }
+}
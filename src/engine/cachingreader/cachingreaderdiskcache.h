@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <memory>
+
+#include "audio/types.h"
+#include "util/fileinfo.h"
+#include "util/indexrange.h"
+#include "util/types.h"
+
+// An optional on-disk cache with the decoded sample data of a track.
+//
+// Each track is stored in a separate file that is memory-mapped by the
+// CachingReaderWorker. Files are fully allocated and written under a
+// temporary name before they become visible, so a mapped file is never
+// resized. The file stores the samples of all chunks as
+// 32-bit floats in the same layout as CachingReaderChunk together with
+// a flag for each chunk that indicates if the chunk has already been
+// decoded. Chunks that have been decoded once don't need to be decoded
+// again when the track is reloaded or when the same position is read
+// again after the chunk has been evicted from the in-memory cache.
+//
+// The class is not thread-safe and must only be used by the worker
+// thread of a single CachingReader.
+class CachingReaderDiskCache {
+  public:
+    // Opens or creates the cache file for a track. Returns nullptr if
+    // the file could not be created or mapped into memory.
+    static std::unique_ptr<CachingReaderDiskCache> open(
+            const QString& cacheDirPath,
+            const QString& cacheKey,
+            mixxx::audio::ChannelCount channelCount,
+            mixxx::audio::SampleRate sampleRate,
+            const mixxx::IndexRange& frameIndexRange);
+    ~CachingReaderDiskCache();
+
+    // Disable copy and move constructors
+    CachingReaderDiskCache(const CachingReaderDiskCache&) = delete;
+    CachingReaderDiskCache(CachingReaderDiskCache&&) = delete;
+
+    // Identifies the decoded audio data of a file. The key changes
+    // whenever the file is modified.
+    static QString cacheKeyForFile(const mixxx::FileInfo& fileInfo);
+
+    // Deletes the least recently used cache files in the directory until
+    // the total size doesn't exceed maxBytes. The file at keepFilePath is
+    // never deleted.
+    static void evictLeastRecentlyUsed(
+            const QString& cacheDirPath,
+            qint64 maxBytes,
+            const QString& keepFilePath = QString());
+
+    QString filePath() const {
+        return m_file.fileName();
+    }
+
+    mixxx::audio::ChannelCount channelCount() const {
+        return m_channelCount;
+    }
+
+    SINT numChunks() const {
+        return m_numChunks;
+    }
+
+    bool isChunkCached(SINT chunkIndex) const;
+
+    // Sample data of a cached chunk with CachingReaderChunk::kFrames
+    // frames, starting at the first frame of the chunk.
+    const CSAMPLE* chunkSamples(SINT chunkIndex) const;
+
+    // Storage for the samples of a chunk that needs to be filled before
+    // invoking markChunkCached().
+    CSAMPLE* writableChunkSamples(SINT chunkIndex);
+    void markChunkCached(SINT chunkIndex);
+
+  private:
+    CachingReaderDiskCache(
+            const QString& filePath,
+            mixxx::audio::ChannelCount channelCount,
+            mixxx::audio::SampleRate sampleRate,
+            SINT numChunks);
+
+    // Maps an existing file if it is compatible
+    bool map();
+
+    QFile m_file;
+    const mixxx::audio::ChannelCount m_channelCount;
+    const mixxx::audio::SampleRate m_sampleRate;
+    const SINT m_numChunks;
+
+    uchar* m_pMappedData;
+    uchar* m_pChunkFlags;
+    CSAMPLE* m_pSamples;
+};
@@ -1,9 +1,13 @@
 #include "engine/cachingreader/cachingreaderworker.h"
 
 #include <QAtomicInt>
+#include <QDir>
 #include <QtDebug>
+#include <cmath>
 
 #include "analyzer/analyzersilence.h"
+#include "control/controlobject.h"
+#include "engine/cachingreader/cachingreaderdiskcache.h"
 #include "moc_cachingreaderworker.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -11,7 +15,10 @@
 #include "util/event.h"
 #include "util/fifo.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
 #include "util/span.h"
+#include "util/stat.h"
 
 namespace {
 
@@ -20,18 +27,168 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// With CachingReaderChunk::kFrames = 8192 each chunk consumes
+// 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB for stereo frame.
+//
+//     80 chunks ->  5120 KB =  5 MB
+//
+// Each deck (including sample decks) will use their own CachingReader.
+// Consequently the total memory required for all allocated chunks depends
+// on the number of decks. The amount of memory reserved for a single
+// CachingReader must be multiplied by the number of decks to calculate
+// the total amount!
+//
+// NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
+// ([App],caching_reader_chunks = 1, 2, 3, ...) for testing purposes
+// to verify that the MRU/LRU cache works as expected. Even though
+// massive drop outs are expected to occur Mixxx should run reliably!
+const ConfigKey kNumCachedChunksConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("caching_reader_chunks"));
+constexpr SINT kNumCachedChunksMin = 1;
+constexpr SINT kNumCachedChunksMax = 4096;
+
+// Keep the decoded audio data of the whole track in memory, e.g. for
+// samplers with short one-shots or when the disk is too slow for
+// seeking while playing. Tracks that exceed the memory limit fall back
+// to the regular LRU cache.
+const ConfigKey kResidentTracksConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("caching_reader_resident_tracks"));
+const ConfigKey kResidentTrackMaxMemoryConfigKey =
+        ConfigKey(QStringLiteral("[App]"),
+                QStringLiteral("caching_reader_resident_track_max_mb"));
+constexpr int kResidentTrackMaxMemoryMBDefault = 1024;
+
+// Weight of a new sample for the moving average of the decoding time
+constexpr double kChunkDecodeTimeSmoothing = 0.1;
+
+// Store the decoded audio data of compressed files in memory-mapped files
+// to avoid decoding the same chunks again
+const ConfigKey kDiskCacheConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("caching_reader_disk_cache"));
+const ConfigKey kDiskCacheMaxSizeConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("caching_reader_disk_cache_max_mb"));
+constexpr int kDiskCacheMaxSizeMBDefault = 8192;
+
+const QString kDiskCacheDirName = QStringLiteral("decoded_audio_cache");
+
+// Decoding is cheap compared to reading uncompressed files from disk
+bool isUncompressedFileType(const QString& fileType) {
+    return fileType.compare(QStringLiteral("wav"), Qt::CaseInsensitive) == 0 ||
+            fileType.compare(QStringLiteral("aif"), Qt::CaseInsensitive) == 0 ||
+            fileType.compare(QStringLiteral("aiff"), Qt::CaseInsensitive) == 0;
+}
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         const QString& group,
+        UserSettingsPointer pConfig,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
         FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+        FIFO<CachingReaderChunkPool*>* pRetiredChunkPoolFIFO,
         mixxx::audio::ChannelCount maxSupportedChannel)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
+          m_pConfig(std::move(pConfig)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
-          m_maxSupportedChannel(maxSupportedChannel) {
+          m_pRetiredChunkPoolFIFO(pRetiredChunkPoolFIFO),
+          // The request FIFO is still empty
+          m_maxQueuedReadRequests(pChunkReadRequestFIFO->writeAvailable()),
+          m_readQueueDepthStatKey(
+                  QStringLiteral("CachingReader %1 read queue depth").arg(m_group)),
+          m_playPositionEpoch(0),
+          m_maxSupportedChannel(maxSupportedChannel),
+          m_chunkPoolSize(0),
+          m_chunkPoolResident(false) {
+    m_queuedReadRequests.reserve(m_maxQueuedReadRequests);
+    // Average time in milliseconds for decoding a single chunk
+    // of the current track
+    m_pChunkDecodeTime = std::make_unique<ControlObject>(
+            ConfigKey(m_group, QStringLiteral("cache_chunk_decode_time")));
+    m_pChunkDecodeTime->setReadOnly();
+    // Number of chunk read requests waiting for the worker
+    m_pReadQueueDepth = std::make_unique<ControlObject>(
+            ConfigKey(m_group, QStringLiteral("cache_read_queue_depth")));
+    m_pReadQueueDepth->setReadOnly();
+}
+
+CachingReaderWorker::~CachingReaderWorker() = default;
+
+CachingReaderChunkPool* CachingReaderWorker::createInitialChunkPool() {
+    DEBUG_ASSERT(m_chunkPoolSize == 0);
+    return createChunkPoolForTrack(mixxx::IndexRange(), m_maxSupportedChannel);
+}
+
+CachingReaderChunkPool* CachingReaderWorker::createChunkPoolForTrack(
+        const mixxx::IndexRange& frameIndexRange,
+        mixxx::audio::ChannelCount channelCount) {
+    SINT numChunks = CachingReaderWorker::kDefaultNumCachedChunks;
+    bool resident = false;
+    if (m_pConfig) {
+        numChunks = math_clamp<SINT>(
+                m_pConfig->getValue<int>(kNumCachedChunksConfigKey,
+                        static_cast<int>(numChunks)),
+                kNumCachedChunksMin,
+                kNumCachedChunksMax);
+        resident = m_pConfig->getValue<bool>(kResidentTracksConfigKey, false);
+    }
+    // Regular pools might be reused for any track and must be able to
+    // hold the maximum number of channels
+    auto poolChannelCount = m_maxSupportedChannel;
+    if (resident && !frameIndexRange.empty()) {
+        channelCount = CachingReaderChunk::bufferedChannelCount(channelCount);
+        const SINT numTrackChunks =
+                CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1) + 1;
+        const qint64 maxMemoryBytes =
+                qint64(m_pConfig->getValue<int>(kResidentTrackMaxMemoryConfigKey,
+                        kResidentTrackMaxMemoryMBDefault)) *
+                1024 * 1024;
+        const qint64 trackMemoryBytes = qint64(numTrackChunks) *
+                CachingReaderChunk::frames2samples(
+                        CachingReaderChunk::kFrames, channelCount) *
+                sizeof(CSAMPLE);
+        if (trackMemoryBytes <= maxMemoryBytes) {
+            numChunks = math_max(numChunks, numTrackChunks);
+            poolChannelCount = channelCount;
+        } else {
+            kLogger.info()
+                    << m_group
+                    << "Track is too large to be kept in memory:"
+                    << trackMemoryBytes / (1024 * 1024)
+                    << "MB";
+            resident = false;
+        }
+    } else {
+        resident = false;
+    }
+    if (numChunks == m_chunkPoolSize &&
+            poolChannelCount == m_chunkPoolChannelCount &&
+            resident == m_chunkPoolResident) {
+        // The current pool is still suitable
+        return nullptr;
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << m_group
+                << "Allocating chunk pool:"
+                << numChunks
+                << "chunks with"
+                << poolChannelCount
+                << "channels"
+                << (resident ? "(resident)" : "");
+    }
+    m_chunkPoolSize = numChunks;
+    m_chunkPoolChannelCount = poolChannelCount;
+    m_chunkPoolResident = resident;
+    return new CachingReaderChunkPool(numChunks, poolChannelCount, resident);
+}
+
+void CachingReaderWorker::deleteRetiredChunkPools() {
+    CachingReaderChunkPool* pChunkPool;
+    while (m_pRetiredChunkPoolFIFO->read(&pChunkPool, 1) == 1) {
+        delete pChunkPool;
+    }
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -51,10 +208,22 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         return result;
     }
 
-    // Try to read the data required for the chunk from the audio source
-    const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
-            m_pAudioSource,
-            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    // Try to read the data required for the chunk from the disk cache
+    // or otherwise from the audio source
+    mixxx::IndexRange bufferedFrameIndexRange;
+    const bool diskCached = m_pDiskCache && m_pDiskCache->isChunkCached(pChunk->getIndex());
+    if (diskCached) {
+        bufferedFrameIndexRange = pChunk->bufferDecodedSampleFrames(
+                m_pAudioSource,
+                m_pDiskCache->chunkSamples(pChunk->getIndex()));
+    } else {
+        PerformanceTimer decodeTimer;
+        decodeTimer.start();
+        bufferedFrameIndexRange = pChunk->bufferSampleFrames(
+                m_pAudioSource,
+                mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+        reportChunkDecodeTime(decodeTimer.elapsed());
+    }
     DEBUG_ASSERT(!m_pAudioSource ||
             bufferedFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
     // The readable frame range might have changed
@@ -72,6 +241,13 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         if (bufferedFrameIndexRange.empty()) {
             status = CHUNK_READ_INVALID; // overwrite EOF (see above)
         }
+    } else if (m_pDiskCache && !diskCached) {
+        // Only store complete chunks
+        pChunk->readBufferedSampleFrames(
+                m_pDiskCache->writableChunkSamples(pChunk->getIndex()),
+                m_pDiskCache->channelCount(),
+                bufferedFrameIndexRange);
+        m_pDiskCache->markChunkCached(pChunk->getIndex());
     }
 
     // This call here assumes that the caching reader will read the first sound cue at
@@ -110,6 +286,7 @@ void CachingReaderWorker::run() {
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
+        deleteRetiredChunkPools();
         // Request is initialized by reading from FIFO
         CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
@@ -127,7 +304,7 @@ void CachingReaderWorker::run() {
                 // here, the engine is already stopped
                 unloadTrack();
             }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        } else if (takeNextReadRequest(&request)) {
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
@@ -139,11 +316,95 @@ void CachingReaderWorker::run() {
     }
 }
 
+bool CachingReaderWorker::takeNextReadRequest(CachingReaderChunkReadRequest* pRequest) {
+    // Only fetch as many requests as fit into the FIFO. Otherwise the
+    // number of pending chunks would be unbounded.
+    CachingReaderChunkReadRequest request;
+    while (m_queuedReadRequests.size() < m_maxQueuedReadRequests &&
+            m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        m_queuedReadRequests.append(request);
+    }
+
+    // Sampled whenever the worker looks for the next request
+    const int readQueueDepth = static_cast<int>(m_queuedReadRequests.size()) +
+            m_pChunkReadRequestFIFO->readAvailable();
+    if (m_pReadQueueDepth->get() != readQueueDepth) {
+        m_pReadQueueDepth->forceSet(readQueueDepth);
+    }
+    Stat::track(m_readQueueDepthStatKey,
+            Stat::UNSPECIFIED,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MAX |
+                    Stat::HISTOGRAM),
+            readQueueDepth);
+
+    const int playPositionEpoch = m_playPositionEpoch.loadAcquire();
+    int nextIndex = -1;
+    auto nextPriority = CachingReaderChunk::ReadPriority::Prefetch;
+    int i = 0;
+    while (i < m_queuedReadRequests.size()) {
+        const CachingReaderChunk* pChunk = m_queuedReadRequests[i].chunk;
+        const auto priority = pChunk->getReadPriority();
+        if (priority == CachingReaderChunk::ReadPriority::PlayPosition &&
+                pChunk->getReadEpoch() != playPositionEpoch) {
+            // The playhead has jumped away since this request
+            // has been issued
+            if (kLogger.traceEnabled()) {
+                kLogger.trace()
+                        << m_group
+                        << "Discarding stale read request for chunk"
+                        << pChunk->getIndex();
+            }
+            discardReadRequest(m_queuedReadRequests[i]);
+            m_queuedReadRequests.remove(i);
+            continue;
+        }
+        // Requests with equal priority are served in order of arrival
+        if (nextIndex < 0 || priority < nextPriority) {
+            nextIndex = i;
+            nextPriority = priority;
+        }
+        ++i;
+    }
+    if (nextIndex < 0) {
+        return false;
+    }
+    *pRequest = m_queuedReadRequests[nextIndex];
+    m_queuedReadRequests.remove(nextIndex);
+    return true;
+}
+
+void CachingReaderWorker::reportChunkDecodeTime(mixxx::Duration decodeTime) {
+    const double decodeTimeMillis = decodeTime.toDoubleMillis();
+    const double oldAverage = m_pChunkDecodeTime->get();
+    m_pChunkDecodeTime->forceSet(oldAverage > 0
+                    ? oldAverage + kChunkDecodeTimeSmoothing * (decodeTimeMillis - oldAverage)
+                    : decodeTimeMillis);
+    Stat::track(m_decodeTimeStatKey,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
+                    Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
+            decodeTime.toIntegerNanos());
+    // Bucketed by whole milliseconds to keep the number of distinct
+    // values small
+    Stat::track(m_decodeTimeHistogramStatKey,
+            Stat::DURATION_MSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::HISTOGRAM),
+            std::ceil(decodeTimeMillis));
+}
+
+void CachingReaderWorker::discardReadRequest(const CachingReaderChunkReadRequest& request) {
+    const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+}
+
 void CachingReaderWorker::discardAllPendingRequests() {
+    for (const auto& request : std::as_const(m_queuedReadRequests)) {
+        discardReadRequest(request);
+    }
+    m_queuedReadRequests.clear();
     CachingReaderChunkReadRequest request;
     while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
-        const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        discardReadRequest(request);
     }
 }
 
@@ -155,6 +416,7 @@ void CachingReaderWorker::closeAudioSource() {
         m_pAudioSource->close();
         m_pAudioSource.reset();
     }
+    m_pDiskCache.reset();
 
     // This function has to be called with the engine stopped only
     // to avoid collecting new requests for the old track
@@ -190,7 +452,8 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
     mixxx::AudioSource::OpenParams config;
     config.setChannelCount(m_maxSupportedChannel);
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    SoundSourceProxy soundSourceProxy(pTrack);
+    m_pAudioSource = soundSourceProxy.openAudioSource(config);
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
@@ -240,6 +503,19 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
+    // The decoding time is reported separately for each SoundSource
+    const QString soundSourceName = soundSourceProxy.getProvider()
+            ? soundSourceProxy.getProvider()->getDisplayName()
+            : QStringLiteral("unknown");
+    m_decodeTimeStatKey =
+            QStringLiteral("CachingReaderWorker decode chunk %1").arg(soundSourceName);
+    m_decodeTimeHistogramStatKey =
+            QStringLiteral("CachingReaderWorker decode chunk histogram %1")
+                    .arg(soundSourceName);
+    m_pChunkDecodeTime->forceSet(0);
+
+    openDiskCache(pTrack);
+
     // Adjust the internal buffer
     const SINT tempReadBufferSize =
             m_pAudioSource->getSignalInfo().frames2samples(
@@ -248,9 +524,16 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
+    // Replace the chunk pool of the cache if needed. The cache
+    // returns the previous pool after receiving the new one.
+    CachingReaderChunkPool* pChunkPool = createChunkPoolForTrack(
+            m_pAudioSource->frameIndexRange(),
+            m_pAudioSource->getSignalInfo().getChannelCount());
+
     const auto update =
             ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
+                    m_pAudioSource->frameIndexRange(),
+                    pChunkPool);
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 
     // Emit that the track is loaded.
@@ -274,6 +557,32 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             mixxx::audio::FramePos(m_pAudioSource->frameLength()));
 }
 
+void CachingReaderWorker::openDiskCache(const TrackPointer& pTrack) {
+    DEBUG_ASSERT(!m_pDiskCache);
+    if (!m_pConfig ||
+            !m_pConfig->getValue<bool>(kDiskCacheConfigKey, false) ||
+            isUncompressedFileType(pTrack->getType())) {
+        return;
+    }
+    const QString cacheDirPath =
+            QDir(m_pConfig->getSettingsPath()).filePath(kDiskCacheDirName);
+    m_pDiskCache = CachingReaderDiskCache::open(
+            cacheDirPath,
+            CachingReaderDiskCache::cacheKeyForFile(pTrack->getFileInfo()),
+            CachingReaderChunk::bufferedChannelCount(
+                    m_pAudioSource->getSignalInfo().getChannelCount()),
+            m_pAudioSource->getSignalInfo().getSampleRate(),
+            m_pAudioSource->frameIndexRange());
+    if (!m_pDiskCache) {
+        return;
+    }
+    const qint64 maxBytes = qint64(m_pConfig->getValue<int>(
+                                    kDiskCacheMaxSizeConfigKey, kDiskCacheMaxSizeMBDefault)) *
+            1024 * 1024;
+    CachingReaderDiskCache::evictLeastRecentlyUsed(
+            cacheDirPath, maxBytes, m_pDiskCache->filePath());
+}
+
 void CachingReaderWorker::quitWait() {
     m_stop = 1;
     m_semaRun.release();
@@ -2,13 +2,20 @@
 
 #include <QMutex>
 #include <QString>
+#include <QVector>
+#include <memory>
 
 #include "audio/frame.h"
 #include "audio/types.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
 #include "engine/engineworker.h"
+#include "preferences/usersettings.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
+#include "util/duration.h"
+
+class CachingReaderDiskCache;
+class ControlObject;
 
 template<class DataType>
 class FIFO;
@@ -37,6 +44,8 @@ enum ReaderStatus {
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    // Only set for TRACK_LOADED if the track requires a new chunk pool
+    CachingReaderChunkPool* chunkPool;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -49,6 +58,7 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        chunkPool = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -61,10 +71,12 @@ typedef struct ReaderStatusUpdate {
     }
 
     static ReaderStatusUpdate trackLoaded(
-            const mixxx::IndexRange& readableFrameIndexRange) {
+            const mixxx::IndexRange& readableFrameIndexRange,
+            CachingReaderChunkPool* pChunkPool = nullptr) {
         DEBUG_ASSERT(!readableFrameIndexRange.empty());
         ReaderStatusUpdate update;
         update.init(TRACK_LOADED, nullptr, readableFrameIndexRange);
+        update.chunkPool = pChunkPool;
         return update;
     }
 
@@ -85,6 +97,13 @@ typedef struct ReaderStatusUpdate {
         return pChunk;
     }
 
+    // Transfers the ownership of a new chunk pool (if any)
+    CachingReaderChunkPool* takeChunkPool() {
+        CachingReaderChunkPool* pChunkPool = chunkPool;
+        chunkPool = nullptr;
+        return pChunkPool;
+    }
+
     mixxx::IndexRange readableFrameIndexRange() const {
         return mixxx::IndexRange::between(
                 readableFrameIndexRangeStart,
@@ -96,12 +115,31 @@ class CachingReaderWorker : public EngineWorker {
     Q_OBJECT
 
   public:
+    // The default number of chunks that are cached in memory. This
+    // also determines the capacity of the FIFOs.
+    static constexpr SINT kDefaultNumCachedChunks = 80;
+
     // Construct a CachingReader with the given group.
     CachingReaderWorker(const QString& group,
+            UserSettingsPointer pConfig,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
             FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+            FIFO<CachingReaderChunkPool*>* pRetiredChunkPoolFIFO,
             mixxx::audio::ChannelCount maxSupportedChannel);
-    ~CachingReaderWorker() override = default;
+    ~CachingReaderWorker() override;
+
+    // Allocates the initial chunk pool for the cache. Must be invoked
+    // once before the worker thread is started.
+    CachingReaderChunkPool* createInitialChunkPool();
+
+    // Deletes all pools that have been returned by the cache.
+    void deleteRetiredChunkPools();
+
+    // Pending read requests for the play position with an older epoch
+    // are discarded. Invoked by the cache when the playhead jumps.
+    void setPlayPositionEpoch(int epoch) {
+        m_playPositionEpoch.storeRelease(epoch);
+    }
 
     // Request to load a new track. wake() must be called afterwards.
     void newTrack(TrackPointer pTrack);
@@ -125,10 +163,25 @@ class CachingReaderWorker : public EngineWorker {
     const QString m_group;
     QString m_tag;
 
+    const UserSettingsPointer m_pConfig;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
+    FIFO<CachingReaderChunkPool*>* m_pRetiredChunkPoolFIFO;
+
+    // Requests that have been received but not yet been processed in
+    // order of arrival. Limited to the capacity of the request FIFO.
+    QVector<CachingReaderChunkReadRequest> m_queuedReadRequests;
+    int m_maxQueuedReadRequests;
+
+    // Number of read requests that have not been served yet, reported
+    // by the worker to keep the engine thread free from StatsManager calls.
+    const QString m_readQueueDepthStatKey;
+    std::unique_ptr<ControlObject> m_pReadQueueDepth;
+
+    QAtomicInt m_playPositionEpoch;
 
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
     // lock to touch.
@@ -138,6 +191,14 @@ class CachingReaderWorker : public EngineWorker {
 
     void discardAllPendingRequests();
 
+    // Moves requests from the FIFO into the queue and takes the request
+    // with the highest priority. Stale requests are discarded. Returns
+    // false if no request is available.
+    bool takeNextReadRequest(CachingReaderChunkReadRequest* pRequest);
+    void discardReadRequest(const CachingReaderChunkReadRequest& request);
+
+    void reportChunkDecodeTime(mixxx::Duration decodeTime);
+
     /// call to be prepare for new tracks
     /// Make sure engine has been stopped before
     void closeAudioSource();
@@ -149,15 +210,34 @@ class CachingReaderWorker : public EngineWorker {
     /// Internal method to load a track. Emits trackLoaded when finished.
     void loadTrack(const TrackPointer& pTrack);
 
+    /// Open the decoded audio data of the loaded track if enabled.
+    void openDiskCache(const TrackPointer& pTrack);
+
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    // Returns a new chunk pool if the track with the given frame index
+    // range and channel count requires a different pool than the one
+    // that has been handed over most recently, otherwise nullptr.
+    CachingReaderChunkPool* createChunkPoolForTrack(
+            const mixxx::IndexRange& frameIndexRange,
+            mixxx::audio::ChannelCount channelCount);
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
+    // Decoded audio data of the current track (optional)
+    std::unique_ptr<CachingReaderDiskCache> m_pDiskCache;
+
+    // Decoding time per chunk for the SoundSource of the current track,
+    // reported to StatsManager and as a moving average in a control.
+    QString m_decodeTimeStatKey;
+    QString m_decodeTimeHistogramStatKey;
+    std::unique_ptr<ControlObject> m_pChunkDecodeTime;
+
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
     // Temporary buffer for reading samples from all channels
@@ -167,5 +247,11 @@ class CachingReaderWorker : public EngineWorker {
     // The maximum number of channel that this reader can support
     mixxx::audio::ChannelCount m_maxSupportedChannel;
 
+    // Properties of the chunk pool that has been handed over
+    // to the cache most recently
+    SINT m_chunkPoolSize;
+    mixxx::audio::ChannelCount m_chunkPoolChannelCount;
+    bool m_chunkPoolResident;
+
     QAtomicInt m_stop;
 };
@@ -5,25 +5,12 @@
 #include "util/timer.h"
 
 // static
-void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator& gainCalculator,
+void ChannelMixer::collectPostFaderChannels(
+        const EngineMixer::GainCalculator& gainCalculator,
         const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>& activeChannels,
         QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>* channelGainCache,
-        CSAMPLE* pOutput,
-        const ChannelHandle& outputHandle,
-        unsigned int iBufferSize,
-        mixxx::audio::SampleRate sampleRate,
-        EngineEffectsManager* pEngineEffectsManager) {
-    // Signal flow overview:
-    // 1. Clear pOutput buffer
-    // 2. Calculate gains for each channel
-    // 3. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
-    //     A) Copies each channel input buffer to a temporary buffer
-    //     B) Applies gain to the temporary buffer
-    //     C) Processes effects on the temporary buffer
-    //     D) Mixes the temporary buffer into pOutput
-    // The original channel input buffers are not modified.
-    SampleUtil::clear(pOutput, iBufferSize);
-    ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsAndMixChannels"));
+        QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels>*
+                pChannels) {
     for (auto* pChannelInfo : activeChannels) {
         EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -38,19 +25,47 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
-                outputHandle,
+        pChannels->append({pChannelInfo->m_handle,
                 pChannelInfo->m_pBuffer.data(),
-                pOutput,
-                iBufferSize,
-                sampleRate,
-                pChannelInfo->m_features,
+                &pChannelInfo->m_features,
                 oldGain,
                 newGain,
-                fadeout);
+                fadeout});
     }
 }
 
+// static
+void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator& gainCalculator,
+        const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>& activeChannels,
+        QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>* channelGainCache,
+        CSAMPLE* pOutput,
+        const ChannelHandle& outputHandle,
+        unsigned int iBufferSize,
+        mixxx::audio::SampleRate sampleRate,
+        EngineEffectsManager* pEngineEffectsManager) {
+    // Signal flow overview:
+    // 1. Clear pOutput buffer
+    // 2. Calculate gains for each channel
+    // 3. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
+    //     A) Copies each channel input buffer to a temporary buffer
+    //     B) Applies gain to the temporary buffer
+    //     C) Processes effects on the temporary buffer
+    //     D) Mixes the temporary buffer into pOutput
+    // The original channel input buffers are not modified.
+    SampleUtil::clear(pOutput, iBufferSize);
+    ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsAndMixChannels"));
+    QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels> channels;
+    collectPostFaderChannels(gainCalculator, activeChannels, channelGainCache, &channels);
+    // The channels might be processed concurrently
+    pEngineEffectsManager->processPostFaderAndMixChannels(channels.constData(),
+            static_cast<int>(channels.size()),
+            outputHandle,
+            pOutput,
+            iBufferSize,
+            sampleRate,
+            false);
+}
+
 void ChannelMixer::applyEffectsInPlaceAndMixChannels(
         const EngineMixer::GainCalculator& gainCalculator,
         const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>&
@@ -70,29 +85,14 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
     // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsInPlaceAndMixChannels"));
     SampleUtil::clear(pOutput, iBufferSize);
-    for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
-        CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
-                outputHandle,
-                pChannelInfo->m_pBuffer.data(),
-                iBufferSize,
-                sampleRate,
-                pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
-        SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), iBufferSize);
-    }
+    QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels> channels;
+    collectPostFaderChannels(gainCalculator, activeChannels, channelGainCache, &channels);
+    // The channels might be processed concurrently
+    pEngineEffectsManager->processPostFaderAndMixChannels(channels.constData(),
+            static_cast<int>(channels.size()),
+            outputHandle,
+            pOutput,
+            iBufferSize,
+            sampleRate,
+            true);
 }
@@ -3,6 +3,7 @@
 #include <QVarLengthArray>
 
 #include "audio/types.h"
+#include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginemixer.h"
 #include "util/types.h"
 
@@ -34,4 +35,15 @@ class ChannelMixer {
             unsigned int iBufferSize,
             mixxx::audio::SampleRate sampleRate,
             EngineEffectsManager* pEngineEffectsManager);
+
+  private:
+    // Calculates the gains of the channels and updates the gain cache
+    static void collectPostFaderChannels(
+            const EngineMixer::GainCalculator& gainCalculator,
+            const QVarLengthArray<EngineMixer::ChannelInfo*,
+                    kPreallocatedChannels>& activeChannels,
+            QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>*
+                    channelGainCache,
+            QVarLengthArray<EngineEffectsManager::PostFaderChannel,
+                    kPreallocatedChannels>* pChannels);
 };
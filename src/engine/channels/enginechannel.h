@@ -63,6 +63,19 @@ class EngineChannel : public EngineObject {
         m_channelIndex = channelIndex;
     }
 
+    /// Called on the engine thread before process(). Everything that touches
+    /// state shared with other channels, e.g. sync, must be done here or in
+    /// finishProcess(), because process() may run concurrently with the
+    /// process() of other channels on a worker thread.
+    virtual void prepareProcess(const int iBufferSize) {
+        Q_UNUSED(iBufferSize)
+    }
+
+    /// Called on the engine thread after process() has returned.
+    virtual void finishProcess(const int iBufferSize) {
+        Q_UNUSED(iBufferSize)
+    }
+
     virtual void postProcessLocalBpm() {
     }
 
@@ -35,7 +35,10 @@ EngineDeck::EngineDeck(
                   primaryDeck),
           m_pConfig(pConfig),
           m_pInputConfigured(new ControlObject(ConfigKey(getGroup(), "input_configured"))),
-          m_pPassing(new ControlPushButton(ConfigKey(getGroup(), "passthrough"))) {
+          m_pPassing(new ControlPushButton(ConfigKey(getGroup(), "passthrough"))),
+          m_processInput(ProcessInput::Silence),
+          m_pPassthroughBuffer(nullptr),
+          m_engineBufferSize(0) {
     m_pInputConfigured->setReadOnly();
     // Set up passthrough utilities and fields
     m_pPassing->setButtonMode(ControlPushButton::POWERWINDOW);
@@ -119,12 +122,11 @@ EngineDeck::~EngineDeck() {
 
 #ifdef __STEM__
 void EngineDeck::processStem(CSAMPLE* pOut, const int iBufferSize) {
-    int stemCount = m_pBuffer->getChannelCount() / mixxx::kEngineChannelOutputCount;
-    auto allChannelBufferSize = iBufferSize * stemCount;
-    if (m_stemBuffer.size() < allChannelBufferSize) {
-        m_stemBuffer = mixxx::SampleBuffer(allChannelBufferSize);
-    }
-    m_pBuffer->process(m_stemBuffer.data(), allChannelBufferSize);
+    // The stem count is fixed in prepareProcess()
+    const int stemCount = m_engineBufferSize / iBufferSize;
+    const int allChannelBufferSize = m_engineBufferSize;
+    DEBUG_ASSERT(m_stemBuffer.size() >= allChannelBufferSize);
+    m_pBuffer->processAudio(m_stemBuffer.data(), allChannelBufferSize);
 
     // TODO(XXX): process effects per stems
     SampleUtil::clear(pOut, iBufferSize);
@@ -157,36 +159,63 @@ void EngineDeck::cloneStemState(const EngineDeck* deckToClone) {
 }
 #endif
 
-void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
+void EngineDeck::prepareProcess(const int iBufferSize) {
     // Feed the incoming audio through if passthrough is active
     const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
     if (isPassthroughActive() && sampleBuffer) {
-        SampleUtil::copy(pOut, sampleBuffer, iBufferSize);
+        m_processInput = ProcessInput::Passthrough;
+        m_pPassthroughBuffer = sampleBuffer;
         m_bPassthroughWasActive = true;
         m_sampleBuffer = nullptr;
         m_pPregain->setSpeedAndScratching(1, false);
-    } else {
-        // If passthrough is no longer enabled, zero out the buffer
-        if (m_bPassthroughWasActive) {
-            SampleUtil::clear(pOut, iBufferSize);
-            m_bPassthroughWasActive = false;
-            return;
+        return;
+    }
+    m_pPassthroughBuffer = nullptr;
+    // If passthrough is no longer enabled, zero out the buffer
+    if (m_bPassthroughWasActive) {
+        m_processInput = ProcessInput::Silence;
+        m_bPassthroughWasActive = false;
+        return;
+    }
+
+    m_processInput = ProcessInput::Buffer;
+    m_engineBufferSize = iBufferSize;
+#ifdef __STEM__
+    if (m_pBuffer->getChannelCount() > mixxx::kEngineChannelOutputCount) {
+        // Multiple stereo channels (stems) are processed and mixed together
+        const int stemCount = m_pBuffer->getChannelCount() / mixxx::kEngineChannelOutputCount;
+        m_engineBufferSize = iBufferSize * stemCount;
+        if (m_stemBuffer.size() < m_engineBufferSize) {
+            m_stemBuffer = mixxx::SampleBuffer(m_engineBufferSize);
         }
+    }
+#endif
+    m_pBuffer->prepareProcess(m_engineBufferSize);
+    m_pPregain->setSpeedAndScratching(m_pBuffer->getSpeed(), m_pBuffer->isScratchingInProcess());
+}
 
+void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
+    switch (m_processInput) {
+    case ProcessInput::Passthrough:
+        SampleUtil::copy(pOut, m_pPassthroughBuffer, iBufferSize);
+        break;
+    case ProcessInput::Silence:
+        SampleUtil::clear(pOut, iBufferSize);
+        return;
+    case ProcessInput::Buffer:
 #ifdef __STEM__
         // Process the raw audio
-        if (m_pBuffer->getChannelCount() <= mixxx::kEngineChannelOutputCount) {
+        if (m_engineBufferSize == iBufferSize) {
             // Process a single mono or stereo channel
 #endif
-            m_pBuffer->process(pOut, iBufferSize);
+            m_pBuffer->processAudio(pOut, iBufferSize);
 #ifdef __STEM__
         } else {
             // Process multiple stereo channels (stems) and mix them together
             processStem(pOut, iBufferSize);
         }
 #endif
-        m_pPregain->setSpeedAndScratching(m_pBuffer->getSpeed(), m_pBuffer->getScratching());
-        m_bPassthroughWasActive = false;
+        break;
     }
 
     // Apply pregain
@@ -205,6 +234,13 @@ void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
     m_vuMeter.process(pOut, iBufferSize);
 }
 
+void EngineDeck::finishProcess(const int iBufferSize) {
+    Q_UNUSED(iBufferSize)
+    if (m_processInput == ProcessInput::Buffer) {
+        m_pBuffer->finishProcess(m_engineBufferSize);
+    }
+}
+
 void EngineDeck::collectFeatures(GroupFeatureState* pGroupFeatures) const {
     m_pBuffer->collectFeatures(pGroupFeatures);
     m_vuMeter.collectFeatures(pGroupFeatures);
@@ -26,7 +26,9 @@ class EngineDeck : public EngineChannel, public AudioDestination {
             bool primaryDeck);
     ~EngineDeck() override;
 
+    void prepareProcess(const int iBufferSize) override;
     void process(CSAMPLE* pOutput, const int iBufferSize) override;
+    void finishProcess(const int iBufferSize) override;
     void collectFeatures(GroupFeatureState* pGroupFeatures) const override;
 
     // postProcessLocalBpm() is called on all decks to update the localBpm after
@@ -83,6 +85,13 @@ class EngineDeck : public EngineChannel, public AudioDestination {
 #endif
 
   private:
+    // The source of the audio of the current callback, decided in prepareProcess()
+    enum class ProcessInput {
+        Buffer,
+        Passthrough,
+        Silence,
+    };
+
 #ifdef __STEM__
     // Process multiple channels and mix them together into the passed buffer
     void processStem(CSAMPLE* pOutput, const int iBufferSize);
@@ -105,4 +114,10 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     ControlPushButton* m_pPassing;
     bool m_bPassthroughIsActive;
     bool m_bPassthroughWasActive;
+
+    ProcessInput m_processInput;
+    const CSAMPLE* m_pPassthroughBuffer;
+    // The buffer size passed to the EngineBuffer, which is larger than the
+    // deck buffer size for stems.
+    int m_engineBufferSize;
 };
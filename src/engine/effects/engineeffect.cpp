@@ -1,9 +1,13 @@
 #include "engine/effects/engineeffect.h"
 
+#include <cmath>
+
+#include "control/controlobject.h"
 #include "effects/backends/effectsbackendmanager.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/engine.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 
 namespace {
@@ -11,16 +15,32 @@ namespace {
 // Used during initialization where the SoundSevice is not set up
 constexpr auto kInitalSampleRate = mixxx::audio::SampleRate(96000);
 
+// Smoothing factor of the published CPU usage. The governor uses the
+// unsmoothed value of the previous callback to react immediately.
+constexpr double kCpuUsageSmoothing = 0.1;
+// Avoid updating the controls in every callback for insignificant changes
+constexpr double kCpuUsagePublishThreshold = 0.001;
+
 } // namespace
 
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         EffectsBackendManagerPointer pBackendManager,
         const QSet<ChannelHandleAndGroup>& activeInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
-        const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
+        const QSet<ChannelHandleAndGroup>& registeredOutputChannels,
+        QSharedPointer<ControlObject> pCpuUsage,
+        QSharedPointer<ControlObject> pCpuBypassed)
         : m_pManifest(pManifest),
           m_pProcessor(pBackendManager->createProcessor(pManifest)),
-          m_parameters(pManifest->parameters().size()) {
+          m_parameters(pManifest->parameters().size()),
+          m_pCpuUsage(std::move(pCpuUsage)),
+          m_pCpuBypassed(std::move(pCpuBypassed)),
+          m_processingNanos(0),
+          m_bufferDurationNanos(0),
+          m_cpuUsage(0),
+          m_cpuUsageBeforeBypass(0),
+          m_smoothedCpuUsage(0),
+          m_governorState(GovernorState::Active) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
         EffectManifestParameterPointer param = parameters.at(i);
@@ -68,6 +88,48 @@ void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
     m_pProcessor->initializeInputChannel(inputChannel, engineParameters);
 }
 
+void EngineEffect::onCallbackStart() {
+    m_cpuUsage = m_bufferDurationNanos > 0
+            ? m_processingNanos / m_bufferDurationNanos
+            : 0;
+    m_processingNanos = 0;
+
+    const double smoothedCpuUsage = m_smoothedCpuUsage +
+            kCpuUsageSmoothing * (m_cpuUsage - m_smoothedCpuUsage);
+    if (m_pCpuUsage &&
+            std::abs(smoothedCpuUsage - m_pCpuUsage->get()) >= kCpuUsagePublishThreshold) {
+        m_pCpuUsage->forceSet(smoothedCpuUsage);
+    }
+    m_smoothedCpuUsage = smoothedCpuUsage;
+
+    // All channels have been processed with the intermediate state during
+    // the previous callback.
+    if (m_governorState == GovernorState::Bypassing) {
+        m_governorState = GovernorState::Bypassed;
+    } else if (m_governorState == GovernorState::Resuming) {
+        m_governorState = GovernorState::Active;
+    }
+}
+
+void EngineEffect::setBypassedByGovernor(bool bypassed) {
+    if (bypassed == isBypassedByGovernor()) {
+        return;
+    }
+    if (bypassed) {
+        m_cpuUsageBeforeBypass = m_cpuUsage;
+        m_governorState = m_governorState == GovernorState::Resuming
+                ? GovernorState::Bypassed
+                : GovernorState::Bypassing;
+    } else {
+        m_governorState = m_governorState == GovernorState::Bypassing
+                ? GovernorState::Active
+                : GovernorState::Resuming;
+    }
+    if (m_pCpuBypassed) {
+        m_pCpuBypassed->forceSet(bypassed ? 1.0 : 0.0);
+    }
+}
+
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                                          EffectsResponsePipe* pResponsePipe) {
     EngineEffectParameterPointer pParameter;
@@ -176,6 +238,26 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
         }
     }
 
+    // The CPU governor fades the effect out and in like the effect's
+    // enable switch, without touching the enable state of the channels.
+    switch (m_governorState) {
+    case GovernorState::Active:
+        break;
+    case GovernorState::Bypassing:
+        if (effectiveEffectEnableState != EffectEnableState::Disabled) {
+            effectiveEffectEnableState = EffectEnableState::Disabling;
+        }
+        break;
+    case GovernorState::Bypassed:
+        effectiveEffectEnableState = EffectEnableState::Disabled;
+        break;
+    case GovernorState::Resuming:
+        if (effectiveEffectEnableState == EffectEnableState::Enabled) {
+            effectiveEffectEnableState = EffectEnableState::Enabling;
+        }
+        break;
+    }
+
     bool processingOccured = false;
 
     if (effectiveEffectEnableState != EffectEnableState::Disabled) {
@@ -184,6 +266,8 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                 sampleRate,
                 numSamples / mixxx::kEngineChannelOutputCount);
 
+        PerformanceTimer timer;
+        timer.start();
         m_pProcessor->process(inputHandle,
                 outputHandle,
                 pInput,
@@ -191,6 +275,9 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                 engineParameters,
                 effectiveEffectEnableState,
                 groupFeatures);
+        m_processingNanos += timer.elapsed().toIntegerNanos();
+        m_bufferDurationNanos = 1e9 * engineParameters.framesPerBuffer() /
+                engineParameters.sampleRate();
 
         processingOccured = true;
 
@@ -2,6 +2,7 @@
 
 #include <QMap>
 #include <QSet>
+#include <QSharedPointer>
 #include <QString>
 #include <QVector>
 #include <memory>
@@ -13,6 +14,8 @@
 #include "engine/effects/message.h"
 #include "util/types.h"
 
+class ControlObject;
+
 /// EngineEffect is a generic wrapper around an EffectProcessor which intermediates
 /// between an EffectSlot and the EffectProcessor. It implements the logic to handle
 /// changes of state (enable switch, chain routing switches, parameters' state) so
@@ -24,7 +27,9 @@ class EngineEffect final : public EffectsRequestHandler {
             EffectsBackendManagerPointer pBackendManager,
             const QSet<ChannelHandleAndGroup>& activeInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredInputChannels,
-            const QSet<ChannelHandleAndGroup>& registeredOutputChannels);
+            const QSet<ChannelHandleAndGroup>& registeredOutputChannels,
+            QSharedPointer<ControlObject> pCpuUsage = nullptr,
+            QSharedPointer<ControlObject> pCpuBypassed = nullptr);
     /// Called in main thread by EffectSlot
     ~EngineEffect();
 
@@ -58,7 +63,48 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pProcessor->getGroupDelayFrames();
     }
 
+    /// Called in audio thread at the start of each callback. Publishes the
+    /// processing time of the previous callback and completes the transitions
+    /// of the CPU governor.
+    void onCallbackStart();
+
+    /// Called in audio thread
+    /// The time spent in process() for all channels during the previous
+    /// callback, relative to the buffer duration.
+    double cpuUsage() const {
+        return m_cpuUsage;
+    }
+
+    /// Called in audio thread
+    /// The CPU usage before the effect has been bypassed by the governor.
+    double cpuUsageBeforeBypass() const {
+        return m_cpuUsageBeforeBypass;
+    }
+
+    /// Called in audio thread by the CPU governor of EngineEffectsManager.
+    /// The effect is faded out and then skipped until it is resumed.
+    void setBypassedByGovernor(bool bypassed);
+
+    bool isBypassedByGovernor() const {
+        return m_governorState == GovernorState::Bypassing ||
+                m_governorState == GovernorState::Bypassed;
+    }
+
+    /// Replaces the processing time of the current callback, which is
+    /// reported by cpuUsage() after the next onCallbackStart().
+    void setCpuUsageForTest(double cpuUsage) {
+        m_bufferDurationNanos = 1e9;
+        m_processingNanos = static_cast<qint64>(cpuUsage * m_bufferDurationNanos);
+    }
+
   private:
+    enum class GovernorState {
+        Active,
+        Bypassing,
+        Bypassed,
+        Resuming,
+    };
+
     QString debugString() const {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
     }
@@ -71,5 +117,16 @@ class EngineEffect final : public EffectsRequestHandler {
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
 
+    // Shared with the EffectSlot, because the EngineEffect is deleted
+    // asynchronously after the effect has been unloaded.
+    const QSharedPointer<ControlObject> m_pCpuUsage;
+    const QSharedPointer<ControlObject> m_pCpuBypassed;
+    qint64 m_processingNanos;
+    double m_bufferDurationNanos;
+    double m_cpuUsage;
+    double m_cpuUsageBeforeBypass;
+    double m_smoothedCpuUsage;
+    GovernorState m_governorState;
+
     DISALLOW_COPY_AND_ASSIGN(EngineEffect);
 };
@@ -171,6 +171,29 @@ bool EngineEffectChain::disableForInputChannel(ChannelHandle inputHandle) {
     return true;
 }
 
+void EngineEffectChain::onCallbackStart() {
+    // All channels have been processed with the intermediate enabling
+    // or disabling state during the previous callback.
+    if (m_enableState == EffectEnableState::Disabling) {
+        m_enableState = EffectEnableState::Disabled;
+    } else if (m_enableState == EffectEnableState::Enabling) {
+        m_enableState = EffectEnableState::Enabled;
+    }
+    for (EngineEffect* pEffect : std::as_const(m_effects)) {
+        if (pEffect) {
+            pEffect->onCallbackStart();
+        }
+    }
+}
+
+bool EngineEffectChain::isActiveForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    // Must match the effective enable state in process()
+    return m_enableState != EffectEnableState::Disabled &&
+            m_chainStatusForChannelMatrix[inputHandle][outputHandle].enableState !=
+            EffectEnableState::Disabled;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -320,11 +343,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         channelStatus.enableState = EffectEnableState::Enabling;
     }
 
-    if (m_enableState == EffectEnableState::Disabling) {
-        m_enableState = EffectEnableState::Disabled;
-    } else if (m_enableState == EffectEnableState::Enabling) {
-        m_enableState = EffectEnableState::Enabled;
-    }
+    // The intermediate state of the chain itself is resolved in
+    // onCallbackStart(), after all channels have received it.
 
     return processingOccured;
 }
@@ -35,6 +35,23 @@ class EngineEffectChain final : public EffectsRequestHandler {
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
+    /// called from audio thread at the start of each callback, before
+    /// any requests are processed
+    void onCallbackStart();
+
+    /// called from audio thread
+    /// The effect slots of the chain. Empty slots are nullptr.
+    const QList<EngineEffect*>& effects() const {
+        return m_effects;
+    }
+
+    /// called from audio thread
+    /// Returns false if process() would leave the effects of the chain
+    /// untouched for this combination of channels. Only then process() may
+    /// run concurrently with process() for other input channels.
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
     /// called from audio thread
     bool process(const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -1,20 +1,60 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <thread>
+
 #include "audio/types.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// A bypassed effect is only resumed if the total CPU usage including the
+// effect stays below this fraction of the budget. This avoids toggling
+// effects in every callback.
+constexpr double kCpuBudgetHysteresis = 0.8;
+
+} // namespace
+
 EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe)
         : m_pResponsePipe(std::move(pResponsePipe)),
           m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_buffer2(kMaxEngineSamples),
+          m_pWorkerPool(nullptr),
+          m_cpuBudget(0) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
 
+void EngineEffectsManager::setRealtimeWorkerPool(RealtimeWorkerPool* pPool) {
+    m_pWorkerPool = pPool;
+    m_channelChainsTasks.clear();
+    if (!m_pWorkerPool || !m_pWorkerPool->isEnabled()) {
+        return;
+    }
+    m_channelChainsTasks.reserve(kMaxConcurrentChannels);
+    for (int i = 0; i < kMaxConcurrentChannels; ++i) {
+        m_channelChainsTasks.push_back(std::make_unique<ChannelChainsTask>());
+    }
+}
+
+void EngineEffectsManager::setCpuBudget(double cpuBudget) {
+    m_cpuBudget = cpuBudget;
+}
+
 void EngineEffectsManager::onCallbackStart() {
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (EngineEffectChain* pChain : chains) {
+            if (pChain) {
+                pChain->onCallbackStart();
+            }
+        }
+    }
+    if (m_cpuBudget > 0) {
+        applyCpuBudget();
+    }
+
     EffectsRequest* request = nullptr;
     while (m_pResponsePipe->readMessage(&request)) {
         EffectsResponse response(*request);
@@ -157,6 +197,219 @@ void EngineEffectsManager::processPostFaderAndMix(
             fadeout);
 }
 
+void EngineEffectsManager::applyCpuBudget() {
+    // Only postfader effects are bypassed. Removing the equalizers of a deck
+    // would be more disruptive than an occasional buffer underflow.
+    const QList<EngineEffectChain*>& chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+    double totalCpuUsage = 0;
+    EngineEffect* pCostliestEffect = nullptr;
+    EngineEffect* pCheapestBypassedEffect = nullptr;
+    for (EngineEffectChain* pChain : chains) {
+        if (!pChain) {
+            continue;
+        }
+        for (EngineEffect* pEffect : pChain->effects()) {
+            if (!pEffect) {
+                continue;
+            }
+            if (pEffect->isBypassedByGovernor()) {
+                if (!pCheapestBypassedEffect ||
+                        pEffect->cpuUsageBeforeBypass() <
+                                pCheapestBypassedEffect->cpuUsageBeforeBypass()) {
+                    pCheapestBypassedEffect = pEffect;
+                }
+                continue;
+            }
+            totalCpuUsage += pEffect->cpuUsage();
+            if (!pCostliestEffect || pEffect->cpuUsage() > pCostliestEffect->cpuUsage()) {
+                pCostliestEffect = pEffect;
+            }
+        }
+    }
+
+    // Change at most one effect per callback and wait for the next
+    // measurement before changing another one.
+    if (totalCpuUsage > m_cpuBudget) {
+        if (pCostliestEffect && pCostliestEffect->cpuUsage() > 0) {
+            pCostliestEffect->setBypassedByGovernor(true);
+        }
+    } else if (pCheapestBypassedEffect &&
+            totalCpuUsage + pCheapestBypassedEffect->cpuUsageBeforeBypass() <
+                    m_cpuBudget * kCpuBudgetHysteresis) {
+        pCheapestBypassedEffect->setBypassedByGovernor(false);
+    }
+}
+
+void EngineEffectsManager::processPostFaderAndMixChannels(
+        const PostFaderChannel* pChannels,
+        int numChannels,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pOut,
+        unsigned int numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        bool inPlace) {
+    const QList<EngineEffectChain*>& chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+
+    if (numChannels < 2 ||
+            numChannels > static_cast<int>(m_channelChainsTasks.size()) ||
+            chains.isEmpty() ||
+            chains.size() > kMaxConcurrentChains) {
+        for (int i = 0; i < numChannels; ++i) {
+            const PostFaderChannel& channel = pChannels[i];
+            processInner(SignalProcessingStage::Postfader,
+                    channel.inputHandle,
+                    outputHandle,
+                    channel.pBuffer,
+                    inPlace ? channel.pBuffer : pOut,
+                    numSamples,
+                    sampleRate,
+                    *channel.pGroupFeatures,
+                    channel.oldGain,
+                    channel.newGain,
+                    channel.fadeout);
+            if (inPlace) {
+                SampleUtil::add(pOut, channel.pBuffer, numSamples);
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < numChannels; ++i) {
+        m_channelChainsTasks[i]->prepare(pChannels[i],
+                outputHandle,
+                &chains,
+                numSamples,
+                sampleRate,
+                inPlace);
+    }
+    // A chain that is active for multiple channels shares its intermediate
+    // buffers and the state of its effects between them, so it must be
+    // processed for one channel after the other and in the same order as
+    // without concurrency. Chains that are inactive for a channel leave
+    // everything but the state of the channel untouched.
+    for (int k = 0; k < chains.size(); ++k) {
+        EngineEffectChain* pChain = chains.at(k);
+        const ChannelChainsTask* pPredecessor = nullptr;
+        for (int i = 0; i < numChannels; ++i) {
+            ChannelChainsTask* pTask = m_channelChainsTasks[i].get();
+            if (pChain && pChain->isActiveForChannel(pChannels[i].inputHandle, outputHandle)) {
+                pTask->setPredecessor(k, pPredecessor);
+                pPredecessor = pTask;
+            } else {
+                pTask->setPredecessor(k, nullptr);
+            }
+        }
+    }
+
+    // Tasks only wait for tasks that have been submitted before, which are
+    // either running on a worker or have already been run inline. The
+    // engine thread processes the last channel itself.
+    const int lastIndex = numChannels - 1;
+    for (int i = 0; i <= lastIndex; ++i) {
+        m_channelChainsTasks[i]->submit(i < lastIndex ? m_pWorkerPool : nullptr);
+    }
+    // Join before mixing, in the order of the channels
+    for (int i = 0; i <= lastIndex; ++i) {
+        ChannelChainsTask* pTask = m_channelChainsTasks[i].get();
+        pTask->waitReady();
+        SampleUtil::add(pOut, pTask->output(), numSamples);
+    }
+}
+
+EngineEffectsManager::ChannelChainsTask::ChannelChainsTask()
+        : m_channel{},
+          m_pChains(nullptr),
+          m_numSamples(0),
+          m_inPlace(false),
+          m_pOutput(nullptr),
+          m_processedChains(0),
+          m_buffer1(kMaxEngineSamples),
+          m_buffer2(kMaxEngineSamples) {
+    m_predecessors.fill(nullptr);
+}
+
+void EngineEffectsManager::ChannelChainsTask::prepare(
+        const PostFaderChannel& channel,
+        const ChannelHandle& outputHandle,
+        const QList<EngineEffectChain*>* pChains,
+        unsigned int numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        bool inPlace) {
+    DEBUG_ASSERT(pChains && pChains->size() <= kMaxConcurrentChains);
+    m_channel = channel;
+    m_outputHandle = outputHandle;
+    m_pChains = pChains;
+    m_numSamples = numSamples;
+    m_sampleRate = sampleRate;
+    m_inPlace = inPlace;
+    m_pOutput = nullptr;
+    m_processedChains.store(0, std::memory_order_relaxed);
+}
+
+void EngineEffectsManager::ChannelChainsTask::waitForPredecessor(int chainIndex) const {
+    const ChannelChainsTask* pPredecessor = m_predecessors[chainIndex];
+    if (!pPredecessor) {
+        return;
+    }
+    // The predecessor is already running and only waits for channels
+    // before itself, so this spins only for the duration of the chains.
+    while (pPredecessor->m_processedChains.load(std::memory_order_acquire) <= chainIndex) {
+        std::this_thread::yield();
+    }
+}
+
+void EngineEffectsManager::ChannelChainsTask::process() {
+    // Same as processInner(), but the output is not mixed
+    CSAMPLE* pIn = m_channel.pBuffer;
+    CSAMPLE* pIntermediateInput = pIn;
+    if (m_inPlace) {
+        SampleUtil::applyRampingGain(pIn, m_channel.oldGain, m_channel.newGain, m_numSamples);
+    } else if (m_channel.oldGain != CSAMPLE_GAIN_ONE ||
+            m_channel.newGain != CSAMPLE_GAIN_ONE) {
+        pIntermediateInput = m_buffer1.data();
+        SampleUtil::copyWithRampingGain(pIntermediateInput,
+                pIn,
+                m_channel.oldGain,
+                m_channel.newGain,
+                m_numSamples);
+    }
+
+    for (int k = 0; k < m_pChains->size(); ++k) {
+        EngineEffectChain* pChain = m_pChains->at(k);
+        if (pChain) {
+            waitForPredecessor(k);
+            if (m_inPlace) {
+                pChain->process(m_channel.inputHandle,
+                        m_outputHandle,
+                        pIn,
+                        pIn,
+                        m_numSamples,
+                        m_sampleRate,
+                        *m_channel.pGroupFeatures,
+                        m_channel.fadeout);
+            } else {
+                CSAMPLE* pIntermediateOutput = pIntermediateInput == m_buffer1.data()
+                        ? m_buffer2.data()
+                        : m_buffer1.data();
+                if (pChain->process(m_channel.inputHandle,
+                            m_outputHandle,
+                            pIntermediateInput,
+                            pIntermediateOutput,
+                            m_numSamples,
+                            m_sampleRate,
+                            *m_channel.pGroupFeatures,
+                            m_channel.fadeout)) {
+                    pIntermediateInput = pIntermediateOutput;
+                }
+            }
+        }
+        m_processedChains.store(k + 1, std::memory_order_release);
+    }
+    m_pOutput = pIntermediateInput;
+}
+
 void EngineEffectsManager::processInner(
         const SignalProcessingStage stage,
         const ChannelHandle& inputHandle,
@@ -188,6 +441,9 @@ void EngineEffectsManager::processInner(
                 }
             }
         }
+    } else if (chains.isEmpty()) {
+        // Without any chains, gain and mixing can be done in a single pass
+        SampleUtil::addWithRampingGain(pOut, pIn, oldGain, newGain, numSamples);
     } else {
         // Do not modify the input buffer.
         // 1. Copy input buffer to a temporary buffer
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
+#include "engine/realtimeworkerpool.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
@@ -25,6 +31,28 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     void onCallbackStart();
 
+    /// Process the postfader EngineEffectChains of independent input channels
+    /// concurrently on the pool instead of serially on the engine thread.
+    /// Called from the main thread before the engine is started.
+    void setRealtimeWorkerPool(RealtimeWorkerPool* pPool);
+
+    /// Bypass the postfader effects that take the most time while the effects
+    /// took longer than cpuBudget times the buffer duration during the previous
+    /// callback. Bypassed effects are resumed one by one when the remaining
+    /// effects leave enough headroom. A budget <= 0 disables the governor.
+    /// Called from the main thread before the engine is started.
+    void setCpuBudget(double cpuBudget);
+
+    /// An input channel for processPostFaderAndMixChannels()
+    struct PostFaderChannel {
+        ChannelHandle inputHandle;
+        CSAMPLE* pBuffer;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+    };
+
     /// Process the prefader EngineEffectChains on the pInOut buffer, modifying
     /// the contents of the input buffer.
     void processPreFaderInPlace(
@@ -64,11 +92,76 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Process the postfader EngineEffectChains of all channels and mix them
+    /// into pOut, which is not cleared. The result is the same as calling
+    /// processPostFaderInPlace() (if inPlace is set) or processPostFaderAndMix()
+    /// for each channel in order. With a RealtimeWorkerPool the channels are
+    /// processed concurrently. Each chain is still processed for one channel
+    /// at a time and in the order of the channels, unless it is inactive for
+    /// the channel.
+    void processPostFaderAndMixChannels(
+            const PostFaderChannel* pChannels,
+            int numChannels,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pOut,
+            unsigned int numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            bool inPlace);
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
   private:
+    static constexpr int kMaxConcurrentChannels = 16;
+    static constexpr int kMaxConcurrentChains = 32;
+
+    // Processes the postfader chains of a single channel, either on the
+    // engine thread or on a RealtimeWorkerPool worker.
+    class ChannelChainsTask final : public RealtimeTask {
+      public:
+        ChannelChainsTask();
+
+        void prepare(const PostFaderChannel& channel,
+                const ChannelHandle& outputHandle,
+                const QList<EngineEffectChain*>* pChains,
+                unsigned int numSamples,
+                mixxx::audio::SampleRate sampleRate,
+                bool inPlace);
+
+        /// The chain must have been processed by the predecessor before
+        /// it is processed by this task.
+        void setPredecessor(int chainIndex, const ChannelChainsTask* pPredecessor) {
+            m_predecessors[chainIndex] = pPredecessor;
+        }
+
+        /// The processed samples after the task is ready
+        const CSAMPLE* output() const {
+            return m_pOutput;
+        }
+
+      protected:
+        void process() override;
+
+      private:
+        void waitForPredecessor(int chainIndex) const;
+
+        PostFaderChannel m_channel;
+        ChannelHandle m_outputHandle;
+        const QList<EngineEffectChain*>* m_pChains;
+        unsigned int m_numSamples;
+        mixxx::audio::SampleRate m_sampleRate;
+        bool m_inPlace;
+        const CSAMPLE* m_pOutput;
+
+        std::array<const ChannelChainsTask*, kMaxConcurrentChains> m_predecessors;
+        // The number of chains that have been processed
+        std::atomic<int> m_processedChains;
+
+        mixxx::SampleBuffer m_buffer1;
+        mixxx::SampleBuffer m_buffer2;
+    };
+
     QString debugString() const {
         return QString("EngineEffectsManager");
     }
@@ -76,6 +169,8 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     bool addEffectChain(EngineEffectChain* pChain, SignalProcessingStage stage);
     bool removeEffectChain(EngineEffectChain* pChain, SignalProcessingStage stage);
 
+    void applyCpuBudget();
+
     // Take a buffer of numSamples samples of audio from a channel, provided as
     // pInput, and apply each EngineEffectChain enabled for this channel to it,
     // putting the resulting output in pOutput. If pInput is equal to pOutput,
@@ -101,4 +196,9 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    RealtimeWorkerPool* m_pWorkerPool;
+    std::vector<std::unique_ptr<ChannelChainsTask>> m_channelChainsTasks;
+
+    double m_cpuBudget;
 };
@@ -6,6 +6,7 @@
 #include "control/controlpotmeter.h"
 #include "control/controlproxy.h"
 #include "control/controlpushbutton.h"
+#include "control/controlvaluearena.h"
 #include "engine/bufferscalers/enginebufferscalelinear.h"
 #include "engine/bufferscalers/enginebufferscalest.h"
 #include "engine/cachingreader/cachingreader.h"
@@ -95,6 +96,11 @@ EngineBuffer::EngineBuffer(const QString& group,
                   kMaxEngineFrames * mixxx::kMaxEngineChannelInputCount)),
           m_bCrossfadeReady(false),
           m_iLastBufferSize(0) {
+    // Store the values of all controls of this deck that are created below,
+    // including those of the EngineControls, next to each other. They are
+    // read in every callback.
+    const ControlValueArena::Scope arenaScope(group);
+
     // This should be a static assertion, but isValid() is not constexpr.
     DEBUG_ASSERT(kInitialPlayPosition.isValid());
 
@@ -862,8 +868,8 @@ void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
     }
 }
 
-void EngineBuffer::processTrackLocked(
-        CSAMPLE* pOutput, const int iBufferSize, mixxx::audio::SampleRate sampleRate) {
+void EngineBuffer::prepareTrackLocked(
+        const int iBufferSize, mixxx::audio::SampleRate sampleRate) {
     ScopedTimer t(QStringLiteral("EngineBuffer::process_pauselock"));
 
     m_trackSampleRateOld = mixxx::audio::SampleRate::fromDouble(m_pTrackSampleRate->get());
@@ -1091,8 +1097,17 @@ void EngineBuffer::processTrackLocked(
 
     m_rate_old = rate;
 
+    m_processState.scratching = is_scratching;
+    m_processState.paused = bCurBufferPaused;
+    m_processState.backwards = backwards;
+    m_processState.atEnd = atEnd;
+    m_processState.playPosOld = playpos_old;
+    m_processState.trackEndPosition = trackEndPosition;
+}
+
+void EngineBuffer::processTrackLocked(CSAMPLE* pOutput, const int iBufferSize) {
     // If the buffer is not paused, then scale the audio.
-    if (!bCurBufferPaused) {
+    if (!m_processState.paused) {
         // Perform scaling of Reader buffer into buffer.
         const double framesRead = m_pScale->scaleBuffer(pOutput, iBufferSize);
 
@@ -1138,13 +1153,17 @@ void EngineBuffer::processTrackLocked(
             SampleUtil::clear(pOutput, iBufferSize);
         }
     }
+}
 
+void EngineBuffer::finishTrackLocked(const int iBufferSize) {
+    const double rate = m_rate_old;
+    const bool backwards = m_processState.backwards;
     for (const auto& pControl : std::as_const(m_engineControls)) {
-        pControl->setFrameInfo(m_playPos, trackEndPosition, m_trackSampleRateOld);
+        pControl->setFrameInfo(m_playPos, m_processState.trackEndPosition, m_trackSampleRateOld);
         pControl->process(rate, m_playPos, iBufferSize);
     }
 
-    m_scratching_old = is_scratching;
+    m_scratching_old = m_processState.scratching;
 
     // If we're repeating and crossed the track boundary, ReadAheadManager already
     // wrapped around the playposition.
@@ -1155,13 +1174,13 @@ void EngineBuffer::processTrackLocked(
     // to set the sync'ed playposition right away and fill the wrap-around buffer
     // with correct samples from the sync'ed loop in / track start position?
     if (m_pRepeat->toBool() && m_pQuantize->toBool() &&
-            (m_playPos > playpos_old) == backwards) {
+            (m_playPos > m_processState.playPosOld) == backwards) {
         // TODO() The resulting seek is processed in the following callback
         // That is to late
         requestSyncPhase();
     }
 
-    bool end_of_track = atEnd && !backwards;
+    bool end_of_track = m_processState.atEnd && !backwards;
 
     // If playbutton is pressed and we're at the end of track release play button
     if (m_playButton->toBool() && end_of_track) {
@@ -1178,6 +1197,13 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     VERIFY_OR_DEBUG_ASSERT((iBufferSize % m_channelCount) == 0) {
         return;
     }
+    prepareProcess(iBufferSize);
+    processAudio(pOutput, iBufferSize);
+    finishProcess(iBufferSize);
+}
+
+void EngineBuffer::prepareProcess(const int iBufferSize) {
+    DEBUG_ASSERT(!m_processState.trackLocked);
     m_pReader->process();
     // Steps:
     // - Lookup new reader information
@@ -1202,9 +1228,9 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
 
     bool hasStableTrack = m_pTrackLoaded->toBool() && m_iTrackLoading.loadAcquire() == 0;
     if (hasStableTrack && m_pause.tryLock()) {
-        processTrackLocked(pOutput, iBufferSize, m_sampleRate);
-        // release the pauselock
-        m_pause.unlock();
+        // The pause lock is released in finishProcess()
+        m_processState.trackLocked = true;
+        prepareTrackLocked(iBufferSize, m_sampleRate);
     } else {
         // We are loading a new Track
 
@@ -1222,11 +1248,19 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
         // is handled. For now we apply a rectangular Gain change here which
         // may click.
 
-        SampleUtil::clear(pOutput, iBufferSize);
-
         m_rate_old = 0;
         m_speed_old = 0;
         m_scratching_old = false;
+        m_processState.scratching = false;
+    }
+}
+
+void EngineBuffer::processAudio(CSAMPLE* pOutput, const int iBufferSize) {
+    if (m_processState.trackLocked) {
+        processTrackLocked(pOutput, iBufferSize);
+    } else {
+        // Silence while a new track is loaded, see prepareProcess()
+        SampleUtil::clear(pOutput, iBufferSize);
     }
 
 #ifdef __SCALER_DEBUG__
@@ -1234,6 +1268,15 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
         writer << pOutput[i] << "\n";
     }
 #endif
+}
+
+void EngineBuffer::finishProcess(const int iBufferSize) {
+    if (m_processState.trackLocked) {
+        finishTrackLocked(iBufferSize);
+        // release the pauselock
+        m_processState.trackLocked = false;
+        m_pause.unlock();
+    }
 
     m_pSyncControl->updateAudible();
 
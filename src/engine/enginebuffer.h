@@ -115,6 +115,11 @@ class EngineBuffer : public EngineObject {
         return m_channelCount;
     }
     bool getScratching() const;
+    /// Returns whether the current callback is scratching. Only valid between
+    /// prepareProcess() and finishProcess().
+    bool isScratchingInProcess() const {
+        return m_processState.scratching;
+    }
     bool isReverse() const;
     /// Returns current bpm value (not thread-safe)
     mixxx::Bpm getBpm() const;
@@ -137,6 +142,17 @@ class EngineBuffer : public EngineObject {
 
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const int iBufferSize) override;
+    /// First stage of process(). Handles seeks, sync requests and the rate
+    /// calculation, which touch state shared with the other decks, so it must
+    /// run on the engine thread.
+    void prepareProcess(const int iBufferSize);
+    /// Second stage of process(). Renders the audio of this deck only and is
+    /// the only stage that may run on a worker thread concurrently with the
+    /// other decks.
+    void processAudio(CSAMPLE* pOut, const int iBufferSize);
+    /// Last stage of process(). Updates the engine controls with the new play
+    /// position and releases the pause lock. Runs on the engine thread.
+    void finishProcess(const int iBufferSize);
     void processSlip(int iBufferSize);
     void postProcessLocalBpm();
     void postProcess(const int iBufferSize);
@@ -291,9 +307,9 @@ class EngineBuffer : public EngineObject {
     bool updateIndicatorsAndModifyPlay(bool newPlay, bool oldPlay);
     void verifyPlay();
     void notifyTrackLoaded(TrackPointer pNewTrack, TrackPointer pOldTrack);
-    void processTrackLocked(CSAMPLE* pOutput,
-            const int iBufferSize,
-            mixxx::audio::SampleRate sampleRate);
+    void prepareTrackLocked(const int iBufferSize, mixxx::audio::SampleRate sampleRate);
+    void processTrackLocked(CSAMPLE* pOutput, const int iBufferSize);
+    void finishTrackLocked(const int iBufferSize);
 
     // Holds the name of the control group
     const QString m_group;
@@ -373,6 +389,19 @@ class EngineBuffer : public EngineObject {
     // Mutex controlling whether the process function is in pause mode. This happens
     // during seek and loading of a new track
     QMutex m_pause;
+
+    // State handed from prepareProcess() over processAudio() to finishProcess()
+    struct ProcessState {
+        // True if m_pause is held by the current callback
+        bool trackLocked = false;
+        bool paused = false;
+        bool scratching = false;
+        bool backwards = false;
+        bool atEnd = false;
+        mixxx::audio::FramePos playPosOld;
+        mixxx::audio::FramePos trackEndPosition;
+    };
+    ProcessState m_processState;
     // Used in update of playpos slider
     int m_iSamplesSinceLastIndicatorUpdate;
 
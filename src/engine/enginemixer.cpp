@@ -8,6 +8,7 @@
 #include "engine/channelmixer.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/engineeffectsmanager.h"
+#include "engine/engine.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginedelay.h"
 #include "engine/enginetalkoverducking.h"
@@ -66,6 +67,22 @@ EngineMixer::EngineMixer(
     m_bExternalRecordBroadcastInputConnected = false;
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
+    m_pRealtimeWorkerPool = new RealtimeWorkerPool(pConfig);
+    if (m_pEngineEffectsManager && pConfig &&
+            pConfig->getValue(ConfigKey(kAppGroup,
+                                      QStringLiteral("effects_multithreading")),
+                    false)) {
+        // Effect chains of different channels share the same workers as
+        // the channels, which are processed before.
+        m_pEngineEffectsManager->setRealtimeWorkerPool(m_pRealtimeWorkerPool);
+    }
+    if (m_pEngineEffectsManager && pConfig) {
+        // Fraction of the buffer duration that the postfader effects may
+        // use before the costliest ones are bypassed. Disabled by default.
+        m_pEngineEffectsManager->setCpuBudget(pConfig->getValue(
+                ConfigKey(kAppGroup, QStringLiteral("effects_cpu_budget")),
+                0.0));
+    }
 
     // Main sample rate
     m_pSampleRate = new ControlObject(
@@ -90,6 +107,15 @@ EngineMixer::EngineMixer(
             ConfigKey(kAppGroup, QStringLiteral("audio_latency_overload")));
     m_pAudioLatencyOverload->addAlias(
             ConfigKey(kLegacyGroup, QStringLiteral("audio_latency_overload")));
+    // Time spent processing the channels relative to the buffer duration
+    m_pChannelProcessingUsage = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("channel_processing_usage")));
+    m_pChannelProcessingUsage->setReadOnly();
+    // Number of callbacks in which processing the channels alone took longer
+    // than the buffer duration
+    m_pChannelProcessingOverloadCount = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("channel_processing_overload_count")));
+    m_pChannelProcessingOverloadCount->setReadOnly();
 
     // Sync controller
     m_pEngineSync = new EngineSync(pConfig);
@@ -236,6 +262,8 @@ EngineMixer::~EngineMixer() {
     delete m_pAudioLatencyOverloadCount;
     delete m_pAudioLatencyUsage;
     delete m_pAudioLatencyOverload;
+    delete m_pChannelProcessingUsage;
+    delete m_pChannelProcessingOverloadCount;
 
     delete m_pMainEnabled;
     delete m_pBoothEnabled;
@@ -244,6 +272,7 @@ EngineMixer::~EngineMixer() {
     delete m_pHeadphoneEnabled;
 
     delete m_pWorkerScheduler;
+    delete m_pRealtimeWorkerPool;
 
     for (int i = 0; i < m_channels.size(); ++i) {
         ChannelInfo* pChannelInfo = m_channels[i];
@@ -270,7 +299,27 @@ const CSAMPLE* EngineMixer::getSidechainBuffer() const {
     return m_sidechainMix.data();
 }
 
+void EngineMixer::ChannelProcessTask::process() {
+    EngineChannel* pChannel = m_pChannelInfo->m_pChannel;
+    DEBUG_ASSERT(m_pChannelInfo->m_pBuffer.size() >= m_iBufferSize);
+    pChannel->process(m_pChannelInfo->m_pBuffer.data(), m_iBufferSize);
+}
+
+void EngineMixer::finishChannelProcess(ChannelInfo* pChannelInfo, int iBufferSize) {
+    EngineChannel* pChannel = pChannelInfo->m_pChannel;
+    pChannel->finishProcess(iBufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
 void EngineMixer::processChannels(int iBufferSize) {
+    m_channelProcessingTimer.start();
+
     // Update internal sync lock rate.
     m_pEngineSync->onCallbackStart(m_sampleRate, iBufferSize);
 
@@ -359,19 +408,43 @@ void EngineMixer::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
-        pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
+    // The sync leader is processed on its own first, because the followers
+    // depend on its updated state.
+    int followersStartIndex = activeChannelsStartIndex;
+    if (activeChannelsStartIndex == 0) {
+        ChannelInfo* pLeaderInfo = m_activeChannels[0];
+        pLeaderInfo->m_pChannel->prepareProcess(iBufferSize);
+        ChannelProcessTask* pTask = pLeaderInfo->m_pProcessTask.get();
+        pTask->setBufferSize(iBufferSize);
+        pTask->submit(nullptr);
+        pTask->waitReady();
+        finishChannelProcess(pLeaderInfo, iBufferSize);
+        followersStartIndex = 1;
+    }
 
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
-        }
+    // The followers are processed in three stages. Seeks and sync requests
+    // touch the state of other decks and EngineSync, so preparing and
+    // finishing are done serially on the engine thread. Only rendering the
+    // audio in between is distributed across the idle workers of the
+    // RealtimeWorkerPool. The engine thread always renders the last channel
+    // itself instead of waiting idle. The stages are the same without
+    // workers, so the result does not depend on the pool.
+    const int lastIndex = m_activeChannels.size() - 1;
+    for (int i = followersStartIndex; i <= lastIndex; ++i) {
+        m_activeChannels[i]->m_pChannel->prepareProcess(iBufferSize);
+    }
+    for (int i = followersStartIndex; i <= lastIndex; ++i) {
+        ChannelProcessTask* pTask = m_activeChannels[i]->m_pProcessTask.get();
+        pTask->setBufferSize(iBufferSize);
+        pTask->submit(i < lastIndex ? m_pRealtimeWorkerPool : nullptr);
+    }
+    // Join before any of the channel buffers are mixed. This also resets the
+    // tasks that were run inline.
+    for (int i = followersStartIndex; i <= lastIndex; ++i) {
+        m_activeChannels[i]->m_pProcessTask->waitReady();
+    }
+    for (int i = followersStartIndex; i <= lastIndex; ++i) {
+        finishChannelProcess(m_activeChannels[i], iBufferSize);
     }
 
     // Do internal sync lock post-processing before the other
@@ -397,6 +470,23 @@ void EngineMixer::processChannels(int iBufferSize) {
             i < m_activeChannels.size(); ++i) {
         m_activeChannels[i]->m_pChannel->postProcess(iBufferSize);
     }
+
+    updateChannelProcessingUsage(iBufferSize);
+}
+
+void EngineMixer::updateChannelProcessingUsage(int iBufferSize) {
+    const double bufferDurationSecs = static_cast<double>(iBufferSize) /
+            mixxx::kEngineChannelOutputCount / m_sampleRate.toDouble();
+    VERIFY_OR_DEBUG_ASSERT(bufferDurationSecs > 0) {
+        return;
+    }
+    const double usage =
+            m_channelProcessingTimer.elapsed().toDoubleSeconds() / bufferDurationSecs;
+    m_pChannelProcessingUsage->forceSet(usage);
+    if (usage > 1.0) {
+        m_pChannelProcessingOverloadCount->forceSet(
+                m_pChannelProcessingOverloadCount->get() + 1);
+    }
 }
 
 void EngineMixer::process(const int iBufferSize) {
@@ -890,6 +980,7 @@ void EngineMixer::addChannel(EngineChannel* pChannel) {
     pChannelInfo->m_pMuteControl->setButtonMode(ControlPushButton::POWERWINDOW);
     pChannelInfo->m_pBuffer = mixxx::SampleBuffer(kMaxEngineSamples);
     pChannelInfo->m_pBuffer.clear();
+    pChannelInfo->m_pProcessTask = std::make_unique<ChannelProcessTask>(pChannelInfo);
     m_channels.append(pChannelInfo);
     constexpr GainCache gainCacheDefault = {0, false};
     m_channelHeadphoneGainCache.append(gainCacheDefault);
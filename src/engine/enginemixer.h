@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QVarLengthArray>
 #include <atomic>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/controlobject.h"
@@ -11,10 +12,12 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/engineobject.h"
+#include "engine/realtimeworkerpool.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/performancetimer.h"
 #include "util/samplebuffer.h"
 
 class EngineWorkerScheduler;
@@ -105,6 +108,30 @@ class EngineMixer : public QObject, public AudioSource {
 
     CSAMPLE_GAIN getMainGain(int channelIndex) const;
 
+    struct ChannelInfo;
+
+    // Runs EngineChannel::process() of a single channel, either on the engine
+    // thread or on a RealtimeWorkerPool worker. The surrounding
+    // prepareProcess() and finishProcess() always run on the engine thread.
+    class ChannelProcessTask final : public RealtimeTask {
+      public:
+        ChannelProcessTask(ChannelInfo* pChannelInfo)
+                : m_pChannelInfo(pChannelInfo),
+                  m_iBufferSize(0) {
+        }
+
+        void setBufferSize(int iBufferSize) {
+            m_iBufferSize = iBufferSize;
+        }
+
+      protected:
+        void process() override;
+
+      private:
+        ChannelInfo* const m_pChannelInfo;
+        int m_iBufferSize;
+    };
+
     struct ChannelInfo {
         ChannelInfo(int index)
                 : m_pChannel(NULL),
@@ -118,6 +145,7 @@ class EngineMixer : public QObject, public AudioSource {
         ControlObject* m_pVolumeControl;
         ControlPushButton* m_pMuteControl;
         GroupFeatureState m_features;
+        std::unique_ptr<ChannelProcessTask> m_pProcessTask;
         int m_index;
     };
 
@@ -252,11 +280,18 @@ class EngineMixer : public QObject, public AudioSource {
 
   private:
     // Processes active channels. The sync lock channel (if any) is processed
-    // first and all others are processed after. Populates m_activeChannels,
+    // first and all others are processed after, rendering their audio
+    // concurrently if the RealtimeWorkerPool is enabled. Populates m_activeChannels,
     // m_activeBusChannels, m_activeHeadphoneChannels, and
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(int iBufferSize);
+    // Publishes the time spent in processChannels() relative to the duration
+    // of the buffer.
+    void updateChannelProcessingUsage(int iBufferSize);
+    // Runs the serial EngineChannel::finishProcess() stage of a channel and
+    // collects its features for the effects.
+    void finishChannelProcess(ChannelInfo* pChannelInfo, int iBufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(int bufferSize);
@@ -293,6 +328,7 @@ class EngineMixer : public QObject, public AudioSource {
     mixxx::SampleBuffer m_sidechainMix;
 
     EngineWorkerScheduler* m_pWorkerScheduler;
+    RealtimeWorkerPool* m_pRealtimeWorkerPool;
     EngineSync* m_pEngineSync;
 
     ControlObject* m_pMainGain;
@@ -303,6 +339,9 @@ class EngineMixer : public QObject, public AudioSource {
     ControlObject* m_pAudioLatencyOverloadCount;
     ControlObject* m_pAudioLatencyUsage;
     ControlObject* m_pAudioLatencyOverload;
+    ControlObject* m_pChannelProcessingUsage;
+    ControlObject* m_pChannelProcessingOverloadCount;
+    PerformanceTimer m_channelProcessingTimer;
     EngineTalkoverDucking* m_pTalkoverDucking;
     EngineDelay* m_pMainDelay;
     EngineDelay* m_pHeadDelay;
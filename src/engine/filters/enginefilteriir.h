@@ -3,6 +3,11 @@
 #include <cstdio>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IIR_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 #define MIXXX
 #include <fidlib.h>
 
@@ -27,6 +32,104 @@ enum IIRPass {
 };
 
 
+/// The samples of both channels of a stereo frame in double precision.
+///
+/// With SSE2 the channels are processed in the two lanes of one register,
+/// halving the number of instructions of the recursive filter loops. Each
+/// operation is applied to both lanes like the corresponding operation on
+/// a single double, so the output is the same as when processing the
+/// channels one after the other.
+class IIRStereoSample {
+  public:
+    IIRStereoSample() = default;
+
+    static IIRStereoSample fromFrame(const CSAMPLE* pFrame) {
+#ifdef IIR_SIMD_SSE2
+        return IIRStereoSample(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+#else
+        return IIRStereoSample(pFrame[0], pFrame[1]);
+#endif
+    }
+
+    /// Stores both samples into pFrame after rounding them to CSAMPLE
+    void toFrame(CSAMPLE* pFrame) const {
+#ifdef IIR_SIMD_SSE2
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_value)));
+#else
+        pFrame[0] = static_cast<CSAMPLE>(m_left);
+        pFrame[1] = static_cast<CSAMPLE>(m_right);
+#endif
+    }
+
+    /// Rounds both samples to CSAMPLE precision
+    IIRStereoSample toSamplePrecision() const {
+#ifdef IIR_SIMD_SSE2
+        return IIRStereoSample(_mm_cvtps_pd(_mm_cvtpd_ps(m_value)));
+#else
+        return IIRStereoSample(static_cast<CSAMPLE>(m_left),
+                static_cast<CSAMPLE>(m_right));
+#endif
+    }
+
+#ifdef IIR_SIMD_SSE2
+    friend IIRStereoSample operator+(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(_mm_add_pd(a.m_value, b.m_value));
+    }
+    friend IIRStereoSample operator-(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(_mm_sub_pd(a.m_value, b.m_value));
+    }
+    friend IIRStereoSample operator*(IIRStereoSample a, double b) {
+        return IIRStereoSample(_mm_mul_pd(a.m_value, _mm_set1_pd(b)));
+    }
+    friend IIRStereoSample operator*(double a, IIRStereoSample b) {
+        return IIRStereoSample(_mm_mul_pd(_mm_set1_pd(a), b.m_value));
+    }
+    IIRStereoSample operator-() const {
+        // Flip the sign bit like the negation of a double
+        return IIRStereoSample(_mm_xor_pd(m_value, _mm_set1_pd(-0.0)));
+    }
+#else
+    friend IIRStereoSample operator+(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(a.m_left + b.m_left, a.m_right + b.m_right);
+    }
+    friend IIRStereoSample operator-(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(a.m_left - b.m_left, a.m_right - b.m_right);
+    }
+    friend IIRStereoSample operator*(IIRStereoSample a, double b) {
+        return IIRStereoSample(a.m_left * b, a.m_right * b);
+    }
+    friend IIRStereoSample operator*(double a, IIRStereoSample b) {
+        return IIRStereoSample(a * b.m_left, a * b.m_right);
+    }
+    IIRStereoSample operator-() const {
+        return IIRStereoSample(-m_left, -m_right);
+    }
+#endif
+    IIRStereoSample& operator+=(IIRStereoSample other) {
+        return *this = *this + other;
+    }
+    IIRStereoSample& operator-=(IIRStereoSample other) {
+        return *this = *this - other;
+    }
+
+  private:
+#ifdef IIR_SIMD_SSE2
+    explicit IIRStereoSample(__m128d value)
+            : m_value(value) {
+    }
+    __m128d m_value;
+#else
+    IIRStereoSample(double left, double right)
+            : m_left(left),
+              m_right(right) {
+    }
+    double m_left;
+    double m_right;
+#endif
+};
+
 class EngineFilterIIRBase : public EngineObjectConstIn {
   public:
     virtual void assumeSettled() = 0;
@@ -85,11 +188,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
     }
 
@@ -236,8 +337,8 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                          const int iBufferSize) {
         if (!m_doRamping) {
             for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                processSample(m_coef, m_buf, IIRStereoSample::fromFrame(&pIn[i]))
+                        .toFrame(&pOutput[i]);
             }
         } else {
             double cross_mix = 0.0;
@@ -254,31 +355,26 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
-                double old1;
-                double old2;
+                const IIRStereoSample in = IIRStereoSample::fromFrame(&pIn[i]);
+                IIRStereoSample old;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    old = processSample(m_oldCoef, m_oldBuf, in).toSamplePrecision();
                 } else {
                     if (m_startFromDry) {
-                        old1 = pIn[i];
-                        old2 = pIn[i + 1];
+                        old = in;
                     } else {
-                        old1 = 0;
-                        old2 = 0;
+                        // Zero-initialized
+                        old = IIRStereoSample();
                     }
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const IIRStereoSample newSample =
+                        processSample(m_coef, m_buf, in).toSamplePrecision();
 
                 if (i < iBufferSize / 2) {
-                    pOutput[i] = static_cast<CSAMPLE>(old1);
-                    pOutput[i + 1] = static_cast<CSAMPLE>(old2);
+                    old.toFrame(&pOutput[i]);
                 } else {
-                    pOutput[i] = static_cast<CSAMPLE>(new1 * cross_mix + old1 * (1.0 - cross_mix));
-                    pOutput[i + 1] = static_cast<CSAMPLE>(
-                            new2 * cross_mix + old2 * (1.0 - cross_mix));
+                    (newSample * cross_mix + old * (1.0 - cross_mix)).toFrame(&pOutput[i]);
                     cross_mix += cross_inc;
                 }
             }
@@ -288,11 +384,13 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    /// Processes a single sample, which is either a double or an
+    /// IIRStereoSample holding the samples of both channels.
+    template<typename T>
+    inline T processSample(double* coef, T* buf, T val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
         m_doStart = true;
     }
@@ -301,15 +399,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
-
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // State of both channels
+    IIRStereoSample m_buf[SIZE];
+    // Old buffer needed for ramping
+    IIRStereoSample m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -320,10 +413,11 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -334,10 +428,11 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -348,10 +443,11 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -362,10 +458,11 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -381,10 +478,11 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -411,10 +509,11 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -430,10 +529,11 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -460,10 +560,11 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -512,10 +613,11 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -543,10 +645,11 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -557,10 +660,11 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
+        T* buf,
+        T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -583,10 +687,11 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
+        T* buf,
+        T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -608,10 +713,11 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -629,10 +735,11 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
@@ -0,0 +1,85 @@
+#include "engine/realtimeworkerpool.h"
+
+#include <QThread>
+#include <QtDebug>
+#include <memory>
+
+#include "util/assert.h"
+
+namespace {
+
+const ConfigKey kEngineMultiThreadingConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("engine_multithreading"));
+
+} // namespace
+
+RealtimeTask::RealtimeTask()
+        : QRunnable(),
+          m_completedSema(0) {
+    // Tasks are owned by their creator and reused for every callback
+    setAutoDelete(false);
+}
+
+void RealtimeTask::submit(RealtimeWorkerPool* pPool) {
+    DEBUG_ASSERT(m_completedSema.available() == 0);
+    // Only hand the task over if a worker is idle right now. Otherwise the
+    // engine thread is better off doing the work instead of waiting for it.
+    if (!pPool || !pPool->isEnabled() || !pPool->tryStart(this)) {
+        run();
+    }
+}
+
+void RealtimeTask::waitReady() {
+    m_completedSema.acquire();
+}
+
+void RealtimeTask::run() {
+    process();
+    m_completedSema.release();
+}
+
+RealtimeWorkerPool::RealtimeWorkerPool(UserSettingsPointer pConfig)
+        : QThreadPool() {
+    const bool multiThreaded = pConfig &&
+            pConfig->getValue(kEngineMultiThreadingConfigKey, false);
+    // The engine thread is one of the processing threads
+    const int numWorkers = multiThreaded
+            ? qMax(0, QThread::idealThreadCount() - 1)
+            : 0;
+
+    qDebug() << "RealtimeWorkerPool will use" << numWorkers
+             << "worker thread(s) besides the engine thread";
+
+    setThreadPriority(QThread::TimeCriticalPriority);
+    // Never let idle workers expire. Restarting a thread would allocate in
+    // the audio callback.
+    setExpiryTimeout(-1);
+    setMaxThreadCount(numWorkers);
+
+    startWorkers(numWorkers);
+}
+
+void RealtimeWorkerPool::startWorkers(int numWorkers) {
+    if (numWorkers <= 0) {
+        return;
+    }
+    // QThreadPool creates its threads lazily when a runnable is started. Keep
+    // that out of the audio callback by occupying every worker once with a
+    // blocking job, which forces the pool to create all threads now. The
+    // semaphores are shared with the jobs, because they may still be leaving
+    // acquire() when this function returns.
+    auto pStarted = std::make_shared<QSemaphore>(0);
+    auto pRelease = std::make_shared<QSemaphore>(0);
+    for (int i = 0; i < numWorkers; ++i) {
+        start([pStarted, pRelease]() {
+            pStarted->release();
+            pRelease->acquire();
+        });
+    }
+    pStarted->acquire(numWorkers);
+    pRelease->release(numWorkers);
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool() {
+    waitForDone();
+}
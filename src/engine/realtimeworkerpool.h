@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include "preferences/usersettings.h"
+
+class RealtimeWorkerPool;
+
+/// RealtimeTask is a reusable job that the engine thread can hand over to a
+/// RealtimeWorkerPool during the audio callback. Tasks are created once off
+/// the engine thread and are never deleted by the pool, so submitting them
+/// does not allocate.
+class RealtimeTask : public QRunnable {
+  public:
+    RealtimeTask();
+    ~RealtimeTask() override = default;
+
+    /// Run the task on an idle worker of the pool or, if there is none (or
+    /// no pool at all), directly on the calling thread. Every call must be
+    /// followed by a call to waitReady().
+    void submit(RealtimeWorkerPool* pPool);
+
+    /// Wait for the previously submitted task to complete.
+    void waitReady();
+
+    void run() override;
+
+  protected:
+    /// The actual work, executed either by a worker or by the engine thread.
+    virtual void process() = 0;
+
+  private:
+    // Released once process() has returned
+    QSemaphore m_completedSema;
+};
+
+/// RealtimeWorkerPool is a pool of high priority threads used to process
+/// independent parts of the audio callback concurrently, e.g. the channels
+/// in EngineMixer. The engine thread always processes one of the tasks itself
+/// instead of waiting idle, so the pool holds one thread less than the number
+/// of tasks that can run in parallel.
+///
+/// The pool is opt-in. With [App],engine_multithreading disabled it has no
+/// worker threads and all tasks are run inline by the engine thread. Otherwise
+/// all worker threads are started by the constructor, before the engine runs,
+/// and are kept alive until the pool is destroyed.
+class RealtimeWorkerPool : public QThreadPool {
+  public:
+    explicit RealtimeWorkerPool(UserSettingsPointer pConfig = nullptr);
+    ~RealtimeWorkerPool() override;
+
+    bool isEnabled() const {
+        return maxThreadCount() > 0;
+    }
+
+  private:
+    void startWorkers(int numWorkers);
+};
@@ -31,7 +31,14 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
                   pTrackCollection, std::move(searchColumns))),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_columnIndex(m_trackInfo),
           m_database(pTrackCollection->database()) {
+    QVector<TrackColumnIndex::ColumnType> columnTypes;
+    columnTypes.reserve(m_columnCount);
+    for (int i = 0; i < m_columnCount; ++i) {
+        columnTypes.append(columnType(i));
+    }
+    m_columnIndex.setColumnTypes(std::move(columnTypes));
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -79,6 +86,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     }
     for (const auto& trackId : std::as_const(trackIds)) {
         m_trackInfo.remove(trackId);
+        m_columnIndex.removeRow(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -120,7 +128,7 @@ const TrackPointer& BaseTrackCache::getRecentTrack(TrackId trackId) const {
     if (m_recentTrackId != trackId) {
         if (trackId.isValid()) {
             TrackPointer trackPtr =
-                    GlobalTrackCacheLocker().lookupTrackById(trackId);
+                    GlobalTrackCacheLocker(trackId).lookupTrackById(trackId);
             replaceRecentTrack(
                     std::move(trackId),
                     std::move(trackPtr));
@@ -209,6 +217,7 @@ bool BaseTrackCache::updateTrackInIndex(
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        m_columnIndex.updateRow(trackId);
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), pTrack);
         }
@@ -264,6 +273,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        m_columnIndex.updateRow(trackId);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -286,6 +296,7 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_columnIndex.clear();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -479,46 +490,87 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
                     searchQuery,
                     queryFragments.join(" AND "));
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
+    // The tracks are sorted with the columnar index instead of the
+    // database unless the order is random.
+    const bool sortInMemory = !orderByClause.isEmpty() &&
+            !orderByClause.contains(QStringLiteral("RANDOM()"), Qt::CaseInsensitive);
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    // Searches that don't need any columns except the cached ones are
+    // evaluated by the columnar index.
+    CompiledQuery compiledQuery;
+    const bool filterInMemory = extraFilter.isEmpty() &&
+            (sortInMemory || orderByClause.isEmpty()) &&
+            (searchQuery.isEmpty() || compileSearchQuery(searchQuery, &compiledQuery));
 
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
+    m_trackOrder.resize(0); // keeps allocated memory
+    trackToIndex->clear();
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
+    if (filterInMemory) {
+        m_trackOrder.reserve(trackIds.size());
+        for (const auto& trackId : trackIds) {
+            if (m_trackInfo.contains(trackId)) {
+                m_trackOrder.append(trackId);
+            }
+        }
+        if (!searchQuery.isEmpty()) {
+            PerformanceTimer timer;
+            timer.start();
+            m_columnIndex.filter(&m_trackOrder, compiledQuery);
+            if (sDebug) {
+                qDebug() << this << "filterAndSort matched" << m_trackOrder.size()
+                         << "tracks in memory in"
+                         << timer.elapsed().debugMillisWithUnit();
+            }
+        }
+    } else {
+        QString filter = pQuery->toSql();
+        if (!filter.isEmpty()) {
+            filter.prepend("WHERE ");
+        }
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
+        QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+                                      .arg(m_idColumn,
+                                              m_tableName,
+                                              filter,
+                                              sortInMemory ? QString() : orderByClause);
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+        if (sDebug) {
+            qDebug() << this << "select() executing:" << queryString;
+        }
 
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+        QSqlQuery query(m_database);
+        // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+        // won't allocate a giant in-memory table that we won't use at all.
+        query.setForwardOnly(true);
+        query.prepare(queryString);
+
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
+
+        int idColumn = query.record().indexOf(m_idColumn);
+        int rows = query.size();
+
+        if (sDebug) {
+            qDebug() << "Rows returned:" << rows;
+        }
+
+        if (rows > 0) {
+            m_trackOrder.reserve(rows);
+        }
+
+        while (query.next()) {
+            m_trackOrder.append(TrackId(query.value(idColumn)));
+        }
     }
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
+    if (sortInMemory) {
+        sortTracksInMemory(sortColumns, columnOffset);
     }
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -661,24 +713,87 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
     return min;
 }
 
+void BaseTrackCache::sortTracksInMemory(
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset) {
+    PerformanceTimer timer;
+    timer.start();
+
+    QVector<TrackColumnIndex::ColumnOrder> columnOrders;
+    for (const auto& sc : sortColumns) {
+        // The id column is sorted by the id column of the index. All
+        // other columns up to the offset are table columns that are
+        // skipped like by BaseSqlTableModel::setSort().
+        int column = 0;
+        if (sc.m_column != 0) {
+            if (sc.m_column <= columnOffset) {
+                continue;
+            }
+            column = sc.m_column - columnOffset;
+        }
+        if (column < m_columnCount) {
+            columnOrders.append({column, sc.m_order});
+        }
+    }
+    m_columnIndex.sort(&m_trackOrder, columnOrders, m_collator, m_columnCache.keyNotation());
+
+    if (sDebug) {
+        qDebug() << this << "sortTracksInMemory sorted" << m_trackOrder.size()
+                 << "tracks in" << timer.elapsed().debugMillisWithUnit();
+    }
+}
+
+bool BaseTrackCache::compileSearchQuery(const QString& searchQuery,
+        CompiledQuery* pCompiledQuery) const {
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(searchQuery, QString());
+    if (!pQuery->compile(pCompiledQuery)) {
+        return false;
+    }
+    for (auto& instruction : pCompiledQuery->instructions()) {
+        for (const auto& sqlColumn : std::as_const(instruction.sqlColumns)) {
+            const int column = fieldIndex(sqlColumn);
+            // The cached time stamps are not formatted like in the database
+            if (column < 0 || column >= m_columnCount ||
+                    m_columnIndex.columnType(column) ==
+                            TrackColumnIndex::ColumnType::Numeric ||
+                    column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DATETIMEADDED)) {
+                return false;
+            }
+            instruction.columns.append(column);
+        }
+    }
+    return true;
+}
+
+TrackColumnIndex::ColumnType BaseTrackCache::columnType(int column) const {
+    if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DURATION) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BITRATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BPM) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_RATING) ||
+            column == fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION)) {
+        return TrackColumnIndex::ColumnType::Numeric;
+    } else if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+        return TrackColumnIndex::ColumnType::Key;
+    } else {
+        return TrackColumnIndex::ColumnType::Text;
+    }
+}
+
 int BaseTrackCache::compareColumnValues(int sortColumn,
         Qt::SortOrder sortOrder,
         const QVariant& val1,
         const QVariant& val2) const {
     int result = 0;
 
-    if (sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DURATION) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BITRATE) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BPM) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_RATING) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION)
-    ) {
+    const TrackColumnIndex::ColumnType type = columnType(sortColumn);
+    if (type == TrackColumnIndex::ColumnType::Numeric) {
         // Sort as floats.
         double delta = val1.toDouble() - val2.toDouble();
 
@@ -689,7 +804,7 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
         } else {
             result = -1;
         }
-    } else if (sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+    } else if (type == TrackColumnIndex::ColumnType::Key) {
         KeyUtils::KeyNotation keyNotation = m_columnCache.keyNotation();
 
         int key1 = KeyUtils::keyToCircleOfFifthsOrder(
@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "library/columncache.h"
+#include "library/trackcolumnindex.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
@@ -103,6 +104,11 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                const QVector<TrackId>& trackIds) const;
+    void sortTracksInMemory(const QList<SortColumn>& sortColumns,
+            const int columnOffset);
+    bool compileSearchQuery(const QString& searchQuery,
+            CompiledQuery* pCompiledQuery) const;
+    TrackColumnIndex::ColumnType columnType(int column) const;
     int compareColumnValues(int sortColumn,
             Qt::SortOrder sortOrder,
             const QVariant& val1,
@@ -145,6 +151,8 @@ class BaseTrackCache : public QObject {
     bool m_bIndexBuilt;
     bool m_bIsCaching;
     QHash<TrackId, QVector<QVariant>> m_trackInfo;
+    // Columnar copy of m_trackInfo for sorting
+    TrackColumnIndex m_columnIndex;
     QSqlDatabase m_database;
 
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
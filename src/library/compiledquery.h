@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+/// A search query that has been flattened into postfix order for
+/// evaluating it on the cached values of many tracks at once instead of
+/// building an SQL query, see QueryNode::compile().
+///
+/// Only the subset of nodes that can be evaluated exactly like their SQL
+/// counterpart are compiled. All other queries are executed by SQL.
+class CompiledQuery final {
+  public:
+    enum class Op {
+        // Push the tracks whose text in any of the columns matches
+        // the argument
+        MatchText,
+        // Pop the given number of operands and push their intersection
+        And,
+        // Pop the given number of operands and push their union
+        Or,
+        // Replace the topmost operand by its complement
+        Not,
+    };
+
+    struct Instruction {
+        Op op;
+        // MatchText
+        QStringList sqlColumns;
+        // The indices of the sqlColumns, resolved by the track cache
+        QVector<int> columns;
+        // Converted with DbConnection::makeStringLatinLow()
+        QString argument;
+        bool exactMatch = false;
+        // And, Or
+        int operandCount = 0;
+    };
+
+    void matchText(const QStringList& sqlColumns,
+            const QString& argument,
+            bool exactMatch) {
+        Instruction instruction{Op::MatchText};
+        instruction.sqlColumns = sqlColumns;
+        instruction.argument = argument;
+        instruction.exactMatch = exactMatch;
+        m_instructions.push_back(std::move(instruction));
+    }
+
+    void combine(Op op, int operandCount) {
+        Instruction instruction{op};
+        instruction.operandCount = operandCount;
+        m_instructions.push_back(std::move(instruction));
+    }
+
+    std::vector<Instruction>& instructions() {
+        return m_instructions;
+    }
+    const std::vector<Instruction>& instructions() const {
+        return m_instructions;
+    }
+
+  private:
+    std::vector<Instruction> m_instructions;
+};
@@ -5,6 +5,7 @@
 #include <QtConcurrent>
 #include <QtDebug>
 
+#include "library/coverartthumbnailstore.h"
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
 #include "util/logger.h"
@@ -29,7 +30,11 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
 
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+CoverArtCache::CoverArtCache(const QString& thumbnailDirectoryPath)
+        : m_pThumbnailStore(thumbnailDirectoryPath.isEmpty()
+                          ? nullptr
+                          : std::make_shared<const CoverArtThumbnailStore>(
+                                    thumbnailDirectoryPath)) {
 }
 
 //static
@@ -174,7 +179,8 @@ void CoverArtCache::tryLoadCover(
             &CoverArtCache::loadCover,
             pTrack,
             coverInfo,
-            desiredWidth);
+            desiredWidth,
+            m_pThumbnailStore);
     connect(watcher,
             &QFutureWatcher<FutureResult>::finished,
             this,
@@ -187,7 +193,8 @@ void CoverArtCache::tryLoadCover(
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        std::shared_ptr<const CoverArtThumbnailStore> pThumbnailStore) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -200,15 +207,40 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     auto res = FutureResult(
             coverInfo.cacheKey());
 
+    if (pThumbnailStore) {
+        CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+        loadedImage.image = pThumbnailStore->loadImage(
+                coverInfo.imageDigest(),
+                desiredWidth,
+                &loadedImage.location);
+        if (!loadedImage.image.isNull()) {
+            if (kLogger.traceEnabled()) {
+                kLogger.trace()
+                        << "loadCover thumbnail hit"
+                        << loadedImage.location;
+            }
+            if (desiredWidth > 0 && loadedImage.image.width() != desiredWidth) {
+                loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            }
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
     if (!loadedImage.image.isNull()) {
-        if (coverInfo.imageDigest().isEmpty()) {
+        QByteArray imageDigest = coverInfo.imageDigest();
+        if (imageDigest.isEmpty()) {
             // This happens if we have loaded the cover art via the legacy hash
             // and during tests.
             // Refresh hash before resizing the original image!
             if (pTrack) {
                 CoverInfo updatedCoverInfo = coverInfo;
                 updatedCoverInfo.setImageDigest(loadedImage.image);
+                imageDigest = updatedCoverInfo.imageDigest();
                 kLogger.info()
                         << "Updating cover info of track"
                         << coverInfo.trackLocation;
@@ -216,6 +248,12 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             }
         }
 
+        if (pThumbnailStore) {
+            pThumbnailStore->storeImage(
+                    imageDigest,
+                    loadedImage.image);
+        }
+
         // Resize image to requested size
         if (desiredWidth > 0) {
             // Adjust the cover size according to the request
@@ -5,11 +5,14 @@
 #include <QPixmap>
 #include <QSet>
 #include <QtDebug>
+#include <memory>
 
 #include "library/coverart.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
+class CoverArtThumbnailStore;
+
 class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     Q_OBJECT
   public:
@@ -51,10 +54,13 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     };
     // Load cover from path indicated in coverInfo. WARNING: This is run in a
     // worker thread.
+    // Pre-scaled images are loaded from and stored in the optional
+    // thumbnail store.
     static FutureResult loadCover(
             TrackPointer pTrack,
             CoverInfo coverInfo,
-            int desiredWidth);
+            int desiredWidth,
+            std::shared_ptr<const CoverArtThumbnailStore> pThumbnailStore = nullptr);
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -67,7 +73,9 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const QPixmap& pixmap);
 
   protected:
-    CoverArtCache();
+    /// Pre-scaled images are stored in thumbnailDirectoryPath
+    /// if not empty.
+    explicit CoverArtCache(const QString& thumbnailDirectoryPath = QString());
     ~CoverArtCache() override = default;
     friend class Singleton<CoverArtCache>;
 
@@ -89,4 +97,8 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         int desiredWidth;
     };
     QMultiHash<mixxx::cache_key_t, RequestData> m_runningRequests;
+
+    // Shared with the worker threads that might still be running
+    // after the cache has been destroyed
+    const std::shared_ptr<const CoverArtThumbnailStore> m_pThumbnailStore;
 };
@@ -0,0 +1,225 @@
+#include "library/coverartthumbnailstore.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtThumbnailStore");
+
+constexpr int kMipmapWidths[] = {
+        CoverArtThumbnailStore::kTableRowWidth,
+        CoverArtThumbnailStore::kDeckWidth,
+};
+
+// Quality of the lossy compressed mipmaps. Images with an alpha channel
+// are stored lossless as PNG.
+constexpr int kJpegQuality = 90;
+
+// The size of the store is checked after this fraction of the limit
+// has been written
+constexpr qint64 kEvictionIntervalDivisor = 16;
+
+// The modification time of an entry is the time of its last use. It is
+// only updated once per day to avoid writing on every read.
+constexpr qint64 kTouchIntervalSecs = 24 * 60 * 60;
+
+void touchFile(const QString& filePath) {
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    if (QFileInfo(filePath).lastModified().secsTo(now) < kTouchIntervalSecs) {
+        return;
+    }
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly)) {
+        file.setFileTime(now, QFileDevice::FileModificationTime);
+    }
+}
+
+// Mipmaps are only stored if they are smaller than the original image.
+// Small images are stored unscaled as the smallest mipmap, otherwise
+// loading them for table rows would require to parse the audio file.
+bool isMipmapStored(const QImage& image, int width) {
+    return image.width() > width || width == kMipmapWidths[0];
+}
+
+} // anonymous namespace
+
+CoverArtThumbnailStore::CoverArtThumbnailStore(
+        QString directoryPath,
+        qint64 maxBytes)
+        : m_directoryPath(std::move(directoryPath)),
+          m_maxBytes(maxBytes),
+          m_bytesWrittenSinceEviction(maxBytes) {
+    DEBUG_ASSERT(!m_directoryPath.isEmpty());
+}
+
+QString CoverArtThumbnailStore::filePath(
+        const QByteArray& imageDigest,
+        int width) const {
+    DEBUG_ASSERT(!imageDigest.isEmpty());
+    DEBUG_ASSERT(width > 0);
+    const QString digestHex = QString::fromLatin1(imageDigest.toHex());
+    // Distribute the files among subdirectories to keep the
+    // directories small.
+    return m_directoryPath +
+            QChar('/') +
+            digestHex.left(2) +
+            QChar('/') +
+            digestHex +
+            QChar('_') +
+            QString::number(width);
+}
+
+QImage CoverArtThumbnailStore::loadImage(
+        const QByteArray& imageDigest,
+        int desiredWidth,
+        QString* pFilePath) const {
+    if (imageDigest.isEmpty() || desiredWidth <= 0) {
+        return QImage();
+    }
+    QImage image;
+    for (const int width : kMipmapWidths) {
+        if (width < desiredWidth) {
+            continue;
+        }
+        // Not all mipmaps are stored for small images. Loading
+        // fails fast if the file does not exist.
+        const QString path = filePath(imageDigest, width);
+        if (image.load(path)) {
+            touchFile(path);
+            if (pFilePath) {
+                *pFilePath = path;
+            }
+            return image;
+        }
+    }
+    return QImage();
+}
+
+void CoverArtThumbnailStore::storeImage(
+        const QByteArray& imageDigest,
+        const QImage& image) const {
+    if (imageDigest.isEmpty() || image.isNull()) {
+        return;
+    }
+    // Entries never change for the same digest. Check this before
+    // scaling, which is much more expensive.
+    bool missing = false;
+    for (const int width : kMipmapWidths) {
+        if (isMipmapStored(image, width) && !QFileInfo::exists(filePath(imageDigest, width))) {
+            missing = true;
+            break;
+        }
+    }
+    if (!missing) {
+        return;
+    }
+    const QString dirPath = QFileInfo(filePath(imageDigest, kMipmapWidths[0])).absolutePath();
+    if (!QDir().mkpath(dirPath)) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << dirPath;
+        return;
+    }
+    // Scale each mipmap from the next larger one, starting with the
+    // largest. This is faster than scaling all of them from the original
+    // image and the quality is still sufficient.
+    QImage mipmap = image;
+    qint64 bytesWritten = 0;
+    for (auto i = std::size(kMipmapWidths); i-- > 0;) {
+        const int width = kMipmapWidths[i];
+        if (!isMipmapStored(image, width)) {
+            continue;
+        }
+        const QString path = filePath(imageDigest, width);
+        if (QFileInfo::exists(path)) {
+            continue;
+        }
+        if (mipmap.width() > width) {
+            mipmap = mipmap.scaledToWidth(width, Qt::SmoothTransformation);
+        }
+        bytesWritten += writeImage(path, mipmap, mipmap.hasAlphaChannel());
+    }
+
+    if (m_bytesWrittenSinceEviction.fetch_add(bytesWritten) + bytesWritten >=
+            m_maxBytes / kEvictionIntervalDivisor) {
+        evictLeastRecentlyUsed();
+    }
+}
+
+qint64 CoverArtThumbnailStore::writeImage(
+        const QString& filePath,
+        const QImage& image,
+        bool lossless) const {
+    // Readers in other threads must never see a partially written file
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open file"
+                << filePath
+                << file.errorString();
+        return 0;
+    }
+    const bool saved = lossless
+            ? image.save(&file, "PNG")
+            : image.save(&file, "JPG", kJpegQuality);
+    const qint64 size = file.size();
+    if (!saved || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write image"
+                << filePath;
+        return 0;
+    }
+    return size;
+}
+
+void CoverArtThumbnailStore::evictLeastRecentlyUsed() const {
+    // Another thread is already evicting
+    if (!m_evictionMutex.tryLock()) {
+        return;
+    }
+    m_bytesWrittenSinceEviction = 0;
+
+    struct Entry {
+        QDateTime lastModified;
+        qint64 size;
+        QString filePath;
+    };
+    std::vector<Entry> entries;
+    qint64 totalBytes = 0;
+    QDirIterator it(m_directoryPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        entries.push_back({fileInfo.lastModified(), fileInfo.size(), fileInfo.filePath()});
+        totalBytes += fileInfo.size();
+    }
+    if (totalBytes > m_maxBytes) {
+        std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+            return lhs.lastModified < rhs.lastModified;
+        });
+        for (const auto& entry : entries) {
+            if (totalBytes <= m_maxBytes) {
+                break;
+            }
+            if (QFile::remove(entry.filePath)) {
+                totalBytes -= entry.size;
+            } else {
+                kLogger.warning()
+                        << "Failed to delete file"
+                        << entry.filePath;
+            }
+        }
+    }
+    m_evictionMutex.unlock();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+/// Persistent store of pre-scaled cover art images (mipmaps) on disk.
+///
+/// Loading a cover art image requires decoding the original image, either
+/// from an image file or from the metadata of an audio file, and scaling
+/// it down to the requested size. The store keeps downscaled copies of each
+/// image for table rows and decks that can be decoded much faster.
+/// Full-size images are not stored.
+///
+/// Entries are keyed by the digest of the original image and never
+/// become stale. The total size of the store is limited, the least
+/// recently used entries are deleted first. This also removes entries
+/// of images that are no longer referenced by any track.
+///
+/// All functions are thread-safe and are supposed to be invoked from the
+/// worker threads of the CoverArtCache.
+class CoverArtThumbnailStore final {
+  public:
+    static constexpr qint64 kDefaultMaxBytes = 512 * 1024 * 1024;
+
+    explicit CoverArtThumbnailStore(
+            QString directoryPath,
+            qint64 maxBytes = kDefaultMaxBytes);
+
+    const QString& directoryPath() const {
+        return m_directoryPath;
+    }
+
+    /// Returns the smallest stored image that is at least as wide as
+    /// desiredWidth or a null image if none is available. The image
+    /// might be wider than requested or, if the original image is
+    /// smaller than kTableRowWidth, narrower and needs to be scaled by
+    /// the caller. A desiredWidth <= 0 never matches.
+    QImage loadImage(
+            const QByteArray& imageDigest,
+            int desiredWidth,
+            QString* pFilePath = nullptr) const;
+
+    /// Stores all mipmaps that are smaller than the original image and
+    /// have not been stored before. Images that are not wider than
+    /// kTableRowWidth are stored unscaled.
+    void storeImage(
+            const QByteArray& imageDigest,
+            const QImage& image) const;
+
+    /// Deletes the least recently used images until the total size
+    /// doesn't exceed the limit.
+    void evictLeastRecentlyUsed() const;
+
+    /// The widths of the pre-scaled images in ascending order
+    static constexpr int kTableRowWidth = 128;
+    static constexpr int kDeckWidth = 512;
+
+  private:
+    QString filePath(const QByteArray& imageDigest, int width) const;
+
+    qint64 writeImage(
+            const QString& filePath,
+            const QImage& image,
+            bool lossless) const;
+
+    const QString m_directoryPath;
+    const qint64 m_maxBytes;
+
+    // Bytes written since the last eviction. Starts at the limit to check
+    // the size of the existing entries once.
+    mutable std::atomic<qint64> m_bytesWrittenSinceEviction;
+    mutable QMutex m_evictionMutex;
+};
@@ -339,7 +339,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    analysis.data = pWaveform->toCompactByteArray();
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -354,7 +354,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
+    analysis.data = pWaveSummary->toCompactByteArray();
 
     success = saveAnalysis(&analysis);
     if (success) {
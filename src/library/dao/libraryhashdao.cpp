@@ -16,6 +16,13 @@ inline constexpr mixxx::cache_key_signed_t dbHash(mixxx::cache_key_t hash) {
     return mixxx::signedCacheKey(hash);
 }
 
+inline QVariant dbModifiedAt(const QDateTime& modifiedAt) {
+    if (!modifiedAt.isValid()) {
+        return QVariant();
+    }
+    return modifiedAt.toMSecsSinceEpoch();
+}
+
 } // anonymous namespace
 
 QHash<QString, mixxx::cache_key_t> LibraryHashDAO::getDirectoryHashes() {
@@ -59,14 +66,19 @@ mixxx::cache_key_t LibraryHashDAO::getDirectoryHash(const QString& dirPath) {
     return hash;
 }
 
-void LibraryHashDAO::saveDirectoryHash(const QString& dirPath, mixxx::cache_key_t hash) {
+void LibraryHashDAO::saveDirectoryHash(const QString& dirPath,
+        mixxx::cache_key_t hash,
+        const QDateTime& modifiedAt) {
     //qDebug() << "LibraryHashDAO::saveDirectoryHash" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(m_database);
-    query.prepare("INSERT INTO LibraryHashes (directory_path, hash, directory_deleted) "
-                    "VALUES (:directory_path, :hash, :directory_deleted)");
+    query.prepare("INSERT INTO LibraryHashes (directory_path, hash, directory_deleted, "
+                  "directory_modified_ms) "
+                  "VALUES (:directory_path, :hash, :directory_deleted, "
+                  ":directory_modified_ms)");
     query.bindValue(":directory_path", dirPath);
     query.bindValue(":hash", dbHash(hash));
     query.bindValue(":directory_deleted", 0);
+    query.bindValue(":directory_modified_ms", dbModifiedAt(modifiedAt));
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query) << "Creating new dirhash failed.";
@@ -76,17 +88,19 @@ void LibraryHashDAO::saveDirectoryHash(const QString& dirPath, mixxx::cache_key_
 
 void LibraryHashDAO::updateDirectoryHash(const QString& dirPath,
                                          mixxx::cache_key_t newHash,
-                                         int dir_deleted) {
+                                         int dir_deleted,
+                                         const QDateTime& modifiedAt) {
     //qDebug() << "LibraryHashDAO::updateDirectoryHash" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(m_database);
     // By definition if we have calculated a new hash for a directory then it
     // exists and no longer needs verification.
     query.prepare("UPDATE LibraryHashes "
             "SET hash=:hash, directory_deleted=:directory_deleted, "
-            "needs_verification=0 "
+            "needs_verification=0, directory_modified_ms=:directory_modified_ms "
             "WHERE directory_path=:directory_path");
     query.bindValue(":hash", dbHash(newHash));
     query.bindValue(":directory_deleted", dir_deleted);
+    query.bindValue(":directory_modified_ms", dbModifiedAt(modifiedAt));
     query.bindValue(":directory_path", dirPath);
 
     if (!query.exec()) {
@@ -182,3 +196,34 @@ QStringList LibraryHashDAO::getDeletedDirectories() {
     }
     return result;
 }
+
+QHash<QString, QDateTime> LibraryHashDAO::getDirectoryModificationTimes() {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT directory_path, directory_modified_ms FROM LibraryHashes "
+                  "WHERE directory_modified_ms IS NOT NULL");
+    QHash<QString, QDateTime> modificationTimes;
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    const int directoryPathColumn = query.record().indexOf("directory_path");
+    const int modifiedColumn = query.record().indexOf("directory_modified_ms");
+    while (query.next()) {
+        modificationTimes.insert(query.value(directoryPathColumn).toString(),
+                QDateTime::fromMSecsSinceEpoch(
+                        query.value(modifiedColumn).toLongLong(), Qt::UTC));
+    }
+    return modificationTimes;
+}
+
+void LibraryHashDAO::updateDirectoryModificationTime(const QString& dirPath,
+        const QDateTime& modifiedAt) {
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE LibraryHashes "
+                  "SET directory_modified_ms=:directory_modified_ms "
+                  "WHERE directory_path=:directory_path");
+    query.bindValue(":directory_modified_ms", dbModifiedAt(modifiedAt));
+    query.bindValue(":directory_path", dirPath);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+}
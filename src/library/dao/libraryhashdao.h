@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDateTime>
 #include <QObject>
 #include <QHash>
 #include <QString>
@@ -13,9 +14,12 @@ class LibraryHashDAO : public DAO {
 
     QHash<QString, mixxx::cache_key_t> getDirectoryHashes();
     mixxx::cache_key_t getDirectoryHash(const QString& dirPath);
-    void saveDirectoryHash(const QString& dirPath, mixxx::cache_key_t hash);
+    void saveDirectoryHash(const QString& dirPath,
+            mixxx::cache_key_t hash,
+            const QDateTime& modifiedAt = QDateTime());
     void updateDirectoryHash(const QString& dirPath, mixxx::cache_key_t newHash,
-                             int dir_deleted);
+                             int dir_deleted,
+                             const QDateTime& modifiedAt = QDateTime());
     void markAsExisting(const QString& dirPath);
     void invalidateAllDirectories();
     void markUnverifiedDirectoriesAsDeleted();
@@ -23,4 +27,11 @@ class LibraryHashDAO : public DAO {
     void updateDirectoryStatuses(const QStringList& dirPaths,
                                  const bool deleted, const bool verified);
     QStringList getDeletedDirectories();
+
+    // The modification times of the directories when they have been
+    // hashed or verified by the last scan. Directories without a stored
+    // modification time are omitted.
+    QHash<QString, QDateTime> getDirectoryModificationTimes();
+    void updateDirectoryModificationTime(const QString& dirPath,
+            const QDateTime& modifiedAt);
 };
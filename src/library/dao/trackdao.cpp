@@ -85,6 +85,7 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
           m_analysisDao(analysisDao),
           m_libraryHashDao(libraryHashDao),
           m_pConfig(pConfig),
+          m_saveTracksBatchDepth(0),
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
           m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex) {
@@ -136,6 +137,9 @@ void TrackDAO::finish() {
         markTrackLocationsAsDeleted(m_database, dir);
     }
     transaction.commit();
+
+    DEBUG_ASSERT(m_saveTracksBatchDepth == 0);
+    m_pQuerySaveTrack.reset();
 }
 
 TrackId TrackDAO::getTrackIdByLocation(const QString& location) const {
@@ -326,6 +330,31 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
     return true;
 }
 
+void TrackDAO::saveTracksPrepare() const {
+    if (m_saveTracksBatchDepth++ > 0) {
+        // Nested batch
+        DEBUG_ASSERT(m_pSaveTracksTransaction);
+        return;
+    }
+    DEBUG_ASSERT(!m_pSaveTracksTransaction);
+    m_pSaveTracksTransaction = std::make_unique<SqlTransaction>(m_database);
+}
+
+void TrackDAO::saveTracksFinish() const {
+    VERIFY_OR_DEBUG_ASSERT(m_saveTracksBatchDepth > 0) {
+        return;
+    }
+    if (--m_saveTracksBatchDepth > 0) {
+        // Nested batch
+        return;
+    }
+    DEBUG_ASSERT(m_pSaveTracksTransaction);
+    if (*m_pSaveTracksTransaction) {
+        m_pSaveTracksTransaction->commit();
+    }
+    m_pSaveTracksTransaction.reset();
+}
+
 void TrackDAO::slotDatabaseTracksChanged(const QSet<TrackId>& changedTrackIds) {
     if (!changedTrackIds.isEmpty()) {
         emit tracksChanged(changedTrackIds);
@@ -814,7 +843,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const mixxx::FileAccess& fileAccess,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::ImportedMetadata* pImportedMetadata) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -864,7 +894,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pImportedMetadata);
     if (!pTrack->checkSourceSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -992,7 +1023,7 @@ bool TrackDAO::onPurgingTracks(
     QStringList idList;
     idList.reserve(trackIds.size());
     for (const auto& trackId : trackIds) {
-        GlobalTrackCacheLocker().purgeTrackId(trackId);
+        GlobalTrackCacheLocker(trackId).purgeTrackId(trackId);
         idList.append(trackId.toString());
     }
     QString idListJoined = idList.join(",");
@@ -1298,7 +1329,7 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     }
 
     // The GlobalTrackCache is only locked while executing the following line.
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    TrackPointer pTrack = GlobalTrackCacheLocker(trackId).lookupTrackById(trackId);
     if (pTrack) {
         return pTrack;
     }
@@ -1567,7 +1598,7 @@ TrackId TrackDAO::getTrackIdByRef(
     if (trackRef.getId().isValid()) {
         return trackRef.getId();
     }
-    const auto pTrack = GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+    const auto pTrack = GlobalTrackCacheLocker(trackRef).lookupTrackByRef(trackRef);
     if (pTrack) {
         const auto trackId = pTrack->getId();
         DEBUG_ASSERT(trackId.isValid());
@@ -1581,7 +1612,7 @@ TrackPointer TrackDAO::getTrackByRef(
     if (!trackRef.isValid()) {
         return nullptr;
     }
-    const auto pTrack = GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+    const auto pTrack = GlobalTrackCacheLocker(trackRef).lookupTrackByRef(trackRef);
     if (pTrack) {
         return pTrack;
     }
@@ -1606,14 +1637,61 @@ bool TrackDAO::updateTrack(const Track& track) const {
              << trackId
              << track.getLocation();
 
-    SqlTransaction transaction(m_database);
+    // Tracks that are saved in a batch share a single transaction
+    std::unique_ptr<SqlTransaction> pTransaction;
+    if (!m_pSaveTracksTransaction) {
+        pTransaction = std::make_unique<SqlTransaction>(m_database);
+    }
     // PerformanceTimer time;
     // time.start();
 
-    QSqlQuery query(m_database);
+    // The statement is prepared only once and then reused
+    if (!m_pQuerySaveTrack) {
+        m_pQuerySaveTrack = std::make_unique<QSqlQuery>(m_database);
+        prepareUpdateTrackQuery(m_pQuerySaveTrack.get());
+    }
+    QSqlQuery& query = *m_pQuerySaveTrack;
 
+    query.bindValue(":track_id", trackId.toVariant());
+
+    const auto trackRecord = track.getRecord();
+    bindTrackLibraryValues(
+            &query,
+            trackRecord,
+            track.getBeats());
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        DEBUG_ASSERT(!"Failed query");
+        return false;
+    }
+
+    if (query.numRowsAffected() == 0) {
+        qWarning() << "updateTrack had no effect: trackId" << trackId << "invalid";
+        return false;
+    }
+
+    //qDebug() << "Update track took : " << time.elapsed().formatMillisWithUnit() << "Now updating cues";
+    //time.start();
+    m_analysisDao.saveTrackAnalyses(
+            trackId,
+            track.getWaveform(),
+            track.getWaveformSummary());
+    m_cueDao.saveTrackCues(
+            trackId, track.getCuePoints());
+    if (pTransaction) {
+        pTransaction->commit();
+    }
+
+    //qDebug() << "Update track in database took: " << time.elapsed().formatMillisWithUnit();
+    //time.start();
+    return true;
+}
+
+//static
+void TrackDAO::prepareUpdateTrackQuery(QSqlQuery* pQuery) {
     // Update everything but "location", since that's what we identify the track by.
-    query.prepare(
+    pQuery->prepare(
             "UPDATE library SET "
             "artist=:artist,"
             "title=:title,"
@@ -1660,39 +1738,6 @@ bool TrackDAO::updateTrack(const Track& track) const {
             "coverart_digest=:coverart_digest,"
             "coverart_hash=:coverart_hash "
             "WHERE id=:track_id");
-
-    query.bindValue(":track_id", trackId.toVariant());
-
-    const auto trackRecord = track.getRecord();
-    bindTrackLibraryValues(
-            &query,
-            trackRecord,
-            track.getBeats());
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        DEBUG_ASSERT(!"Failed query");
-        return false;
-    }
-
-    if (query.numRowsAffected() == 0) {
-        qWarning() << "updateTrack had no effect: trackId" << trackId << "invalid";
-        return false;
-    }
-
-    //qDebug() << "Update track took : " << time.elapsed().formatMillisWithUnit() << "Now updating cues";
-    //time.start();
-    m_analysisDao.saveTrackAnalyses(
-            trackId,
-            track.getWaveform(),
-            track.getWaveformSummary());
-    m_cueDao.saveTrackCues(
-            trackId, track.getCuePoints());
-    transaction.commit();
-
-    //qDebug() << "Update track in database took: " << time.elapsed().formatMillisWithUnit();
-    //time.start();
-    return true;
 }
 
 // Mark all the tracks in the library as invalid.
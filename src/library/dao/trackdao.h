@@ -9,6 +9,7 @@
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 
@@ -72,6 +73,14 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
 
+    // Only used by friend class TrackCollection, but public for testing!
+    // All tracks that are saved between saveTracksPrepare() and
+    // saveTracksFinish() are written in a single transaction, reusing
+    // the prepared statements. Nested batches are merged into the
+    // outermost batch.
+    void saveTracksPrepare() const;
+    void saveTracksFinish() const;
+
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
     bool updatePlayCounterFromPlayedHistory(
@@ -147,9 +156,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// Metadata that has been imported from the file in advance, e.g.
+    /// by a worker thread of the library scanner, is used instead of
+    /// reading the file again if the track is new.
     TrackPointer addTracksAddFile(
             const mixxx::FileAccess& fileAccess,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::ImportedMetadata* pImportedMetadata = nullptr);
     TrackPointer addTracksAddFile(
             const QString& filePath,
             bool unremove) {
@@ -160,6 +173,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
+    static void prepareUpdateTrackQuery(QSqlQuery* pQuery);
 
     void hideAllTracks(const QDir& rootDir) const;
 
@@ -207,6 +221,9 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     std::unique_ptr<QSqlQuery> m_pQueryLibraryUpdate;
     std::unique_ptr<QSqlQuery> m_pQueryLibrarySelect;
     std::unique_ptr<SqlTransaction> m_pTransaction;
+    mutable std::unique_ptr<QSqlQuery> m_pQuerySaveTrack;
+    mutable std::unique_ptr<SqlTransaction> m_pSaveTracksTransaction;
+    mutable int m_saveTracksBatchDepth;
     int m_trackLocationIdColumn;
     int m_queryLibraryIdColumn;
     int m_queryLibraryMixxxDeletedColumn;
@@ -14,6 +14,17 @@ extern const QString kConfigGroup;
 
 extern const ConfigKey kRescanOnStartupConfigKey;
 
+/// The number of worker threads that walk the library directories and
+/// parse the file tags of new tracks during a library scan. The number
+/// of CPU cores, but at most 4 by default.
+extern const ConfigKey kScannerThreadCountConfigKey;
+
+/// Skip directories that have not been modified since the last library
+/// scan instead of listing and hashing all directories. Disabled by
+/// default, because not all file systems update the modification time
+/// of directories reliably.
+extern const ConfigKey kIncrementalRescanConfigKey;
+
 extern const ConfigKey kKeyNotationConfigKey;
 
 extern const ConfigKey kTrackDoubleClickActionConfigKey;
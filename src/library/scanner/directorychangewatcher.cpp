@@ -0,0 +1,141 @@
+#include "library/scanner/directorychangewatcher.h"
+
+#include <QStorageInfo>
+
+#include "moc_directorychangewatcher.cpp"
+#include "util/logger.h"
+
+namespace {
+
+#ifdef Q_OS_LINUX
+const mixxx::Logger kLogger("DirectoryChangeWatcher");
+
+// The number of inotify watches is limited per user and shared
+// with all other applications.
+constexpr int kMaxWatchedDirectories = 8192;
+
+bool isNetworkFileSystem(const QByteArray& fileSystemType) {
+    return fileSystemType.startsWith("nfs") ||
+            fileSystemType.startsWith("smb") ||
+            fileSystemType == "cifs" ||
+            fileSystemType == "9p" ||
+            fileSystemType == "afpfs" ||
+            fileSystemType == "davfs" ||
+            fileSystemType == "fuse.sshfs";
+}
+
+bool isInDirectory(const QString& path, const QString& dirPath) {
+    return path.startsWith(dirPath) &&
+            (path.size() == dirPath.size() ||
+                    dirPath.endsWith(QChar('/')) ||
+                    path.at(dirPath.size()) == QChar('/'));
+}
+#endif
+
+} // anonymous namespace
+
+DirectoryChangeWatcher::DirectoryChangeWatcher(QObject* pParent)
+        : QObject(pParent),
+          m_watcher(this) {
+    connect(&m_watcher,
+            &QFileSystemWatcher::directoryChanged,
+            this,
+            &DirectoryChangeWatcher::slotDirectoryChanged);
+}
+
+QSet<QString> DirectoryChangeWatcher::takeUnchangedDirectories() {
+    const QStringList watchedDirectories = m_watcher.directories();
+    QSet<QString> watchedNow(watchedDirectories.begin(), watchedDirectories.end());
+    QSet<QString> unchangedDirectories = m_watchedSinceScanStart;
+    // Deleted directories are no longer watched
+    unchangedDirectories.intersect(watchedNow);
+    unchangedDirectories.subtract(m_changedDirectories);
+    m_watchedSinceScanStart = std::move(watchedNow);
+    m_changedDirectories.clear();
+    return unchangedDirectories;
+}
+
+void DirectoryChangeWatcher::watchDirectories(
+        const QList<mixxx::FileInfo>& rootDirs,
+        const QStringList& dirPaths) {
+#ifdef Q_OS_LINUX
+    QStringList localRootDirs;
+    for (const auto& rootDir : rootDirs) {
+        const QStorageInfo storageInfo(rootDir.location());
+        if (storageInfo.isValid() && !isNetworkFileSystem(storageInfo.fileSystemType())) {
+            localRootDirs.append(rootDir.location());
+        } else {
+            kLogger.info()
+                    << "Not watching directories of"
+                    << rootDir.location()
+                    << "on file system"
+                    << storageInfo.fileSystemType();
+        }
+    }
+
+    const QSet<QString> dirPathSet(dirPaths.begin(), dirPaths.end());
+    QStringList obsoleteDirectories;
+    const QStringList watchedDirectories = m_watcher.directories();
+    for (const auto& dirPath : watchedDirectories) {
+        if (!dirPathSet.contains(dirPath)) {
+            obsoleteDirectories.append(dirPath);
+        }
+    }
+    if (!obsoleteDirectories.isEmpty()) {
+        m_watcher.removePaths(obsoleteDirectories);
+    }
+
+    const QSet<QString> watchedDirectorySet(
+            watchedDirectories.begin(), watchedDirectories.end());
+    int remainingWatches = kMaxWatchedDirectories -
+            static_cast<int>(watchedDirectories.size() - obsoleteDirectories.size());
+    QStringList newDirectories;
+    for (const auto& dirPath : dirPaths) {
+        if (remainingWatches <= 0) {
+            break;
+        }
+        if (watchedDirectorySet.contains(dirPath)) {
+            continue;
+        }
+        for (const auto& rootDir : std::as_const(localRootDirs)) {
+            if (isInDirectory(dirPath, rootDir)) {
+                newDirectories.append(dirPath);
+                --remainingWatches;
+                break;
+            }
+        }
+    }
+    if (newDirectories.isEmpty()) {
+        return;
+    }
+    const QStringList failedDirectories = m_watcher.addPaths(newDirectories);
+    kLogger.debug()
+            << "Watching"
+            << newDirectories.size() - failedDirectories.size()
+            << "new directories";
+    if (!failedDirectories.isEmpty()) {
+        // Probably the limit of inotify watches has been reached
+        kLogger.info()
+                << "Failed to watch"
+                << failedDirectories.size()
+                << "directories";
+    }
+#else
+    // Watching thousands of directories is only efficient with inotify
+    Q_UNUSED(rootDirs);
+    Q_UNUSED(dirPaths);
+#endif
+}
+
+void DirectoryChangeWatcher::clear() {
+    const QStringList watchedDirectories = m_watcher.directories();
+    if (!watchedDirectories.isEmpty()) {
+        m_watcher.removePaths(watchedDirectories);
+    }
+    m_watchedSinceScanStart.clear();
+    m_changedDirectories.clear();
+}
+
+void DirectoryChangeWatcher::slotDirectoryChanged(const QString& dirPath) {
+    m_changedDirectories.insert(dirPath);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "util/fileinfo.h"
+
+/// Records which library directories have been modified between
+/// subsequent library scans, using inotify on Linux.
+///
+/// Directories are only reported as unchanged if they have been watched
+/// continuously since the start of the previous scan. Only directories
+/// on local file systems are watched, because modifications of network
+/// shares by other hosts are not reported.
+///
+/// Must only be used from the thread of the library scanner.
+class DirectoryChangeWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit DirectoryChangeWatcher(QObject* pParent = nullptr);
+    ~DirectoryChangeWatcher() override = default;
+
+    /// Returns the directories that have been watched since the previous
+    /// call and have not been modified in the meantime. Invoked at the
+    /// start of each scan.
+    QSet<QString> takeUnchangedDirectories();
+
+    /// Watch the given directories of the library after a scan has
+    /// finished. Directories of network shares are skipped.
+    void watchDirectories(
+            const QList<mixxx::FileInfo>& rootDirs,
+            const QStringList& dirPaths);
+
+    void clear();
+
+  private slots:
+    void slotDirectoryChanged(const QString& dirPath);
+
+  private:
+    QFileSystemWatcher m_watcher;
+
+    // The directories that were already watched at the start of the
+    // previous scan.
+    QSet<QString> m_watchedSinceScanStart;
+    QSet<QString> m_changedDirectories;
+};
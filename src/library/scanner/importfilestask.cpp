@@ -1,5 +1,6 @@
 #include "library/scanner/importfilestask.h"
 
+#include "library/coverartutils.h"
 #include "moc_importfilestask.cpp"
 #include "util/timer.h"
 
@@ -8,6 +9,7 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const QString& dirPath,
         const bool prevHashExists,
         const mixxx::cache_key_t newHash,
+        const QDateTime& dirModifiedAt,
         const std::list<QFileInfo>& filesToImport,
         const std::list<QFileInfo>& possibleCovers,
         SecurityTokenPointer pToken)
@@ -15,6 +17,7 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
           m_dirPath(dirPath),
           m_prevHashExists(prevHashExists),
           m_newHash(newHash),
+          m_dirModifiedAt(dirModifiedAt),
           m_filesToImport(filesToImport),
           m_possibleCovers(possibleCovers),
           m_pToken(pToken) {
@@ -22,6 +25,9 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    // All files are located in the same directory and the guesser
+    // caches the cover files of this directory.
+    CoverInfoGuesser coverInfoGuesser;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -49,10 +55,17 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Parse the file tags in this worker thread. The scanner thread
+            // only needs to write the results into the database.
+            const auto importedMetadata =
+                    SoundSourceProxy::importMetadataOfNewTrackFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->resetMissingTagMetadataOnImport(),
+                            &coverInfoGuesser);
+            emit addNewTrack(trackLocation, importedMetadata);
         }
     }
     // Insert or update the hash in the database.
-    emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
+    emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash, m_dirModifiedAt);
     setSuccess(true);
 }
@@ -15,6 +15,7 @@ class ImportFilesTask : public ScannerTask {
             const QString& dirPath,
             const bool prevHashExists,
             const mixxx::cache_key_t newHash,
+            const QDateTime& dirModifiedAt,
             const std::list<QFileInfo>& filesToImport,
             const std::list<QFileInfo>& possibleCovers,
             SecurityTokenPointer pToken);
@@ -26,6 +27,7 @@ class ImportFilesTask : public ScannerTask {
     const QString m_dirPath;
     const bool m_prevHashExists;
     const mixxx::cache_key_t m_newHash;
+    const QDateTime m_dirModifiedAt;
     const std::list<QFileInfo> m_filesToImport;
     const std::list<QFileInfo> m_possibleCovers;
     SecurityTokenPointer m_pToken;
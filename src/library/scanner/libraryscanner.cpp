@@ -1,6 +1,9 @@
 #include "library/scanner/libraryscanner.h"
 
+#include <algorithm>
+
 #include "library/coverartutils.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "library/scanner/libraryscannerdlg.h"
 #include "library/scanner/recursivescandirectorytask.h"
@@ -19,8 +22,10 @@
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
+// Directories are walked and the tags of new files are parsed by
+// the worker threads. More threads mainly hide the latency of slow
+// storage like network shares.
+constexpr int kMaxDefaultScannerThreadCount = 4;
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -92,12 +97,20 @@ void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
     }
 }
 
+int scannerThreadCount(const UserSettings& config) {
+    const int threadCount = config.getValue(
+            mixxx::library::prefs::kScannerThreadCountConfigKey,
+            std::min(QThread::idealThreadCount(), kMaxDefaultScannerThreadCount));
+    return std::max(threadCount, 1);
+}
+
 } // anonymous namespace
 
 LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
@@ -112,7 +125,9 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_pool.setMaxThreadCount(scannerThreadCount(*m_pConfig));
+
+    qRegisterMetaType<SoundSourceProxy::ImportedMetadata>();
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -174,10 +189,14 @@ void LibraryScanner::run() {
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
 
+        m_pDirectoryWatcher = std::make_unique<DirectoryChangeWatcher>();
+
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        m_pDirectoryWatcher.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -207,8 +226,27 @@ void LibraryScanner::slotStartScan() {
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)
+                            .resetMissingTagMetadataOnImport));
+
+    // Apply a modified thread count for each scan
+    m_pool.setMaxThreadCount(scannerThreadCount(*m_pConfig));
+
+    if (m_pConfig->getValue(mixxx::library::prefs::kIncrementalRescanConfigKey, false)) {
+        kLogger.info()
+                << "Skipping directories that have not been modified since"
+                << "the last scan";
+        m_scannerGlobal->enableIncrementalScan(
+                m_libraryHashDao.getDirectoryModificationTimes(),
+                m_pDirectoryWatcher->takeUnchangedDirectories());
+    } else {
+        m_pDirectoryWatcher->clear();
+    }
 
     m_scannerGlobal->startTimer();
 
@@ -411,6 +449,14 @@ void LibraryScanner::slotFinishUnhashedScan() {
         cleanUpScan();
     }
 
+    if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly &&
+            m_scannerGlobal->isIncrementalScan()) {
+        // All directories are up to date now
+        m_pDirectoryWatcher->watchDirectories(
+                m_libraryRootDirs,
+                m_libraryHashDao.getDirectoryHashes().keys());
+    }
+
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
         updateQueryPlannerStatisticsForDatabase(dbConnection);
@@ -530,7 +576,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
 }
 
 void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
-                                               bool newDirectory, mixxx::cache_key_t hash) {
+        bool newDirectory,
+        mixxx::cache_key_t hash,
+        const QDateTime& modifiedAt) {
     ScopedTimer timer(QStringLiteral("LibraryScanner::slotDirectoryHashedAndScanned"));
     //kLogger.debug() << "sloDirectoryHashedAndScanned" << directoryPath
     //          << newDirectory << hash;
@@ -542,19 +590,23 @@ void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
     }
 
     if (newDirectory) {
-        m_libraryHashDao.saveDirectoryHash(directoryPath, hash);
+        m_libraryHashDao.saveDirectoryHash(directoryPath, hash, modifiedAt);
     } else {
-        m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0);
+        m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0, modifiedAt);
     }
     emit progressHashing(directoryPath);
 }
 
-void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
+void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath,
+        const QDateTime& modifiedAt) {
     ScopedTimer timer(QStringLiteral("LibraryScanner::slotDirectoryUnchanged"));
     //kLogger.debug() << "slotDirectoryUnchanged" << directoryPath;
     if (m_scannerGlobal) {
         m_scannerGlobal->addVerifiedDirectory(directoryPath);
     }
+    if (modifiedAt.isValid()) {
+        m_libraryHashDao.updateDirectoryModificationTime(directoryPath, modifiedAt);
+    }
     emit progressHashing(directoryPath);
 }
 
@@ -566,13 +618,17 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
     }
 }
 
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
+void LibraryScanner::slotAddNewTrack(const QString& trackPath,
+        const SoundSourceProxy::ImportedMetadata& importedMetadata) {
     //kLogger.debug() << "slotAddNewTrack" << trackPath;
     ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
-    // For statistics tracking and to detect moved tracks
+    // The file tags have already been parsed by the worker thread.
+    // All new tracks are inserted within the single transaction that
+    // spans the whole scan.
     TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
+            mixxx::FileAccess(mixxx::FileInfo(trackPath)),
+            false,
+            &importedMetadata);
     if (pTrack) {
         DEBUG_ASSERT(!pTrack->isDirty());
         // The track's actual location might differ from the
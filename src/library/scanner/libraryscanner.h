@@ -7,6 +7,7 @@
 #include <QSemaphore>
 #include <QThread>
 #include <QThreadPool>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -14,6 +15,7 @@
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
+#include "library/scanner/directorychangewatcher.h"
 #include "library/scanner/scannerglobal.h"
 #include "track/track_decl.h"
 #include "util/db/dbconnectionpool.h"
@@ -66,10 +68,13 @@ class LibraryScanner : public QThread {
 
     // ScannerTask signal handlers.
     void slotDirectoryHashedAndScanned(const QString& directoryPath,
-                                   bool newDirectory, mixxx::cache_key_t hash);
-    void slotDirectoryUnchanged(const QString& directoryPath);
+            bool newDirectory,
+            mixxx::cache_key_t hash,
+            const QDateTime& modifiedAt);
+    void slotDirectoryUnchanged(const QString& directoryPath, const QDateTime& modifiedAt);
     void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotAddNewTrack(const QString& trackPath,
+            const SoundSourceProxy::ImportedMetadata& importedMetadata);
 
   private:
     enum ScannerState {
@@ -97,6 +102,8 @@ class LibraryScanner : public QThread {
 
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
+    const UserSettingsPointer m_pConfig;
+
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
 
@@ -111,6 +118,9 @@ class LibraryScanner : public QThread {
     // Global scanner state for scan currently in progress.
     ScannerGlobalPointer m_scannerGlobal;
 
+    // Created and accessed only by the library scanner thread
+    std::unique_ptr<DirectoryChangeWatcher> m_pDirectoryWatcher;
+
     // The Semaphore guards the state transitions queued to the
     // Qt even Queue in the way, that you cannot start a
     // new scan while the old one is canceled
@@ -30,10 +30,33 @@ void RecursiveScanDirectoryTask::run() {
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
 
+    if (m_scannerGlobal->directoryUnchangedSinceLastScan(m_dirAccess.info())) {
+        // Neither list nor hash the directory again and continue with
+        // the subdirectories that have been found by previous scans.
+        emit directoryUnchanged(m_dirAccess.info().location(), QDateTime());
+        const QSet<QString> subdirPaths =
+                m_scannerGlobal->knownSubdirectories(m_dirAccess.info().location());
+        for (const QString& subdirPath : subdirPaths) {
+            if (m_scannerGlobal->directoryBlacklisted(subdirPath)) {
+                continue;
+            }
+            const mixxx::FileInfo subdirInfo(subdirPath);
+            if (!subdirInfo.isDir()) {
+                continue;
+            }
+            scanSubdirectory(subdirInfo);
+        }
+        setSuccess(true);
+        return;
+    }
+
     // Note, we save on filesystem operations (and random work) by initializing
     // a QDirIterator with a QDir instead of a QString -- but it inherits its
     // Filter from the QDir so we have to set it first. If the QDir has not done
     // any FS operations yet then this should be lightweight.
+    // Modifications while listing the directory are detected by the
+    // next scan.
+    const QDateTime dirModifiedAt = m_dirAccess.info().lastModified();
     auto dir = m_dirAccess.info().toQDir();
     dir.setFilter(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::System);
     // sort directory by file name to increase chance that files are sorted sensible
@@ -102,14 +125,16 @@ void RecursiveScanDirectoryTask::run() {
                         dirLocation,
                         prevHashExists,
                         newHash,
+                        dirModifiedAt,
                         filesToImport,
                         possibleCovers,
                         m_dirAccess.token()));
             } else {
-                emit directoryHashedAndScanned(dirLocation, !prevHashExists, newHash);
+                emit directoryHashedAndScanned(
+                        dirLocation, !prevHashExists, newHash, dirModifiedAt);
             }
         } else {
-            emit directoryUnchanged(dirLocation);
+            emit directoryUnchanged(dirLocation, dirModifiedAt);
         }
     } else {
         m_scannerGlobal->addUnhashedDir(m_dirAccess);
@@ -117,17 +142,21 @@ void RecursiveScanDirectoryTask::run() {
 
     // Process all of the sub-directories.
     for (const mixxx::FileInfo& dirInfo : dirsToScan) {
-        // Atomically test and mark the directory as scanned to avoid
-        // that the same directory is scanned multiple times by different
-        // tasks.
-        if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
-            m_pScanner->queueTask(
-                    new RecursiveScanDirectoryTask(
-                            m_pScanner,
-                            m_scannerGlobal,
-                            mixxx::FileAccess(dirInfo, m_dirAccess.token()),
-                            m_scanUnhashed));
-        }
+        scanSubdirectory(dirInfo);
     }
     setSuccess(true);
 }
+
+void RecursiveScanDirectoryTask::scanSubdirectory(const mixxx::FileInfo& dirInfo) {
+    // Atomically test and mark the directory as scanned to avoid
+    // that the same directory is scanned multiple times by different
+    // tasks.
+    if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+        m_pScanner->queueTask(
+                new RecursiveScanDirectoryTask(
+                        m_pScanner,
+                        m_scannerGlobal,
+                        mixxx::FileAccess(dirInfo, m_dirAccess.token()),
+                        m_scanUnhashed));
+    }
+}
@@ -6,8 +6,9 @@
 /// Recursively scan a music library. Doesn't import tracks for any directories
 /// that have already been scanned and have not changed. Changes are tracked by
 /// performing a hash of the directory's file list, and those hashes are stored
-/// in the database. Successful if the scan completed without being
-/// cancelled. False if the scan was cancelled part-way through.
+/// in the database. Incremental scans skip listing directories that have not
+/// been modified since the last scan. Successful if the scan completed without
+/// being cancelled. False if the scan was cancelled part-way through.
 class RecursiveScanDirectoryTask : public ScannerTask {
     Q_OBJECT
   public:
@@ -20,6 +21,8 @@ class RecursiveScanDirectoryTask : public ScannerTask {
     void run() override;
 
   private:
+    void scanSubdirectory(const mixxx::FileInfo& dirInfo);
+
     const mixxx::FileAccess m_dirAccess;
     const bool m_scanUnhashed;
 };
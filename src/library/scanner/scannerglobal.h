@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDateTime>
 #include <QDir>
 #include <QHash>
 #include <QMutex>
@@ -20,16 +21,87 @@ class ScannerGlobal {
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            bool resetMissingTagMetadataOnImport)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_resetMissingTagMetadataOnImport(resetMissingTagMetadataOnImport),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
-              m_numScannedDirectories(0) {
+              m_numScannedDirectories(0),
+              m_incrementalScan(false) {
+    }
+
+    // Enables skipping directories that have not been modified since the
+    // last scan, i.e. these directories are neither listed nor hashed
+    // again. A directory is unchanged if it has been watched by the
+    // DirectoryChangeWatcher without being modified or if its modification
+    // time equals the one that has been stored when it was last scanned.
+    void enableIncrementalScan(
+            QHash<QString, QDateTime> directoryModificationTimes,
+            QSet<QString> unchangedWatchedDirectories) {
+        m_directoryModificationTimes = std::move(directoryModificationTimes);
+        m_unchangedWatchedDirectories = std::move(unchangedWatchedDirectories);
+        // Build the tree of all previously scanned directories to find
+        // the subdirectories of unchanged directories without listing them.
+        // Directories without tracks have no hash and are included as
+        // the intermediate nodes of this tree.
+        for (auto it = m_directoryHashes.constBegin(); it != m_directoryHashes.constEnd(); ++it) {
+            QString dirPath = it.key();
+            while (true) {
+                const int separatorIndex = dirPath.lastIndexOf(QChar('/'));
+                if (separatorIndex <= 0) {
+                    break;
+                }
+                const QString parentPath = dirPath.left(separatorIndex);
+                QSet<QString>& subdirectories = m_knownSubdirectories[parentPath];
+                if (subdirectories.contains(dirPath)) {
+                    // All ancestors have already been added
+                    break;
+                }
+                subdirectories.insert(dirPath);
+                dirPath = parentPath;
+            }
+        }
+        m_incrementalScan = true;
+    }
+
+    bool isIncrementalScan() const {
+        return m_incrementalScan;
+    }
+
+    // Returns whether the directory has been hashed by a previous scan and
+    // has not been modified since. Only used for incremental scans.
+    bool directoryUnchangedSinceLastScan(const mixxx::FileInfo& dirInfo) const {
+        if (!m_incrementalScan) {
+            return false;
+        }
+        const QString dirPath = dirInfo.location();
+        if (!m_directoryHashes.contains(dirPath)) {
+            return false;
+        }
+        if (m_unchangedWatchedDirectories.contains(dirPath)) {
+            return true;
+        }
+        // Adding, removing or renaming an entry of a directory updates
+        // its modification time. Only the stored modification time of the
+        // directory itself is compared, because the clock of the file system
+        // might differ from the local clock and copying files with rsync -a
+        // or cp -p preserves the original, possibly older, time stamps.
+        const QDateTime storedModifiedAt = m_directoryModificationTimes.value(dirPath);
+        const QDateTime lastModified = dirInfo.lastModified();
+        return storedModifiedAt.isValid() && lastModified.isValid() &&
+                lastModified.toMSecsSinceEpoch() == storedModifiedAt.toMSecsSinceEpoch();
+    }
+
+    // The subdirectories that have been found by previous scans. Only
+    // available for incremental scans.
+    QSet<QString> knownSubdirectories(const QString& dirPath) const {
+        return m_knownSubdirectories.value(dirPath);
     }
 
     TaskWatcher& getTaskWatcher() {
@@ -50,6 +122,11 @@ class ScannerGlobal {
         return m_directoriesBlacklist.contains(directoryPath);
     }
 
+    // Passed when importing the metadata of new tracks in worker threads
+    bool resetMissingTagMetadataOnImport() const {
+        return m_resetMissingTagMetadataOnImport;
+    }
+
     const QRegularExpression& supportedExtensionsRegex() const {
         return m_supportedExtensionsMatcher;
     }
@@ -182,6 +259,8 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const bool m_resetMissingTagMetadataOnImport;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -197,6 +276,13 @@ class ScannerGlobal {
     // Stats tracking.
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
+
+    // Immutable after incremental scanning has been enabled
+    // before the first task is started.
+    bool m_incrementalScan;
+    QHash<QString, QDateTime> m_directoryModificationTimes;
+    QSet<QString> m_unchangedWatchedDirectories;
+    QHash<QString, QSet<QString>> m_knownSubdirectories;
 };
 
 typedef QSharedPointer<ScannerGlobal> ScannerGlobalPointer;
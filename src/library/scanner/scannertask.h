@@ -4,6 +4,7 @@
 #include <QRunnable>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 
 class LibraryScanner;
 
@@ -19,11 +20,17 @@ class ScannerTask : public QObject, public QRunnable {
   signals:
     void taskDone(bool success);
     void queueTask(ScannerTask* pTask);
+    // The modification time of the directory before it has been listed
+    // is stored to detect modifications by the next incremental scan.
     void directoryHashedAndScanned(const QString& directoryPath,
-                                   bool newDirectory, mixxx::cache_key_t hash);
-    void directoryUnchanged(const QString& directoryPath);
+            bool newDirectory,
+            mixxx::cache_key_t hash,
+            const QDateTime& modifiedAt);
+    // The modification time is invalid if it doesn't need to be updated
+    void directoryUnchanged(const QString& directoryPath, const QDateTime& modifiedAt);
     void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void addNewTrack(const QString& filePath,
+            const SoundSourceProxy::ImportedMetadata& importedMetadata);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
@@ -125,6 +125,16 @@ QString AndNode::toSql() const {
     return concatSqlClauses(queryFragments, "AND");
 }
 
+bool AndNode::compile(CompiledQuery* pQuery) const {
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->compile(pQuery)) {
+            return false;
+        }
+    }
+    pQuery->combine(CompiledQuery::Op::And, static_cast<int>(m_nodes.size()));
+    return true;
+}
+
 bool OrNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (pNode->match(pTrack)) {
@@ -149,6 +159,16 @@ QString OrNode::toSql() const {
     return concatSqlClauses(queryFragments, "OR");
 }
 
+bool OrNode::compile(CompiledQuery* pQuery) const {
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->compile(pQuery)) {
+            return false;
+        }
+    }
+    pQuery->combine(CompiledQuery::Op::Or, static_cast<int>(m_nodes.size()));
+    return true;
+}
+
 bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
@@ -165,6 +185,20 @@ QString NotNode::toSql() const {
     }
 }
 
+bool NotNode::compile(CompiledQuery* pQuery) const {
+    // SQL evaluates NOT of a comparison with a NULL column to NULL, i.e.
+    // the track doesn't match, while the compiled query only knows the
+    // cached empty strings. Only a test for NULL itself is never NULL.
+    if (!dynamic_cast<const NullOrEmptyTextFilterNode*>(m_pNode.get())) {
+        return false;
+    }
+    if (!m_pNode->compile(pQuery)) {
+        return false;
+    }
+    pQuery->combine(CompiledQuery::Op::Not, 1);
+    return true;
+}
+
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
@@ -226,6 +260,21 @@ QString TextFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::compile(CompiledQuery* pQuery) const {
+    // Wildcards and the delimiter for trailing spaces that are appended
+    // by toSql() can't be matched exactly like the LIKE operator.
+    // An empty argument doesn't match NULL values in SQL.
+    if (m_sqlColumns.isEmpty() ||
+            m_argument.isEmpty() ||
+            m_argument.contains(QChar('%')) ||
+            m_argument.contains(QChar('_')) ||
+            m_argument[m_argument.size() - 1].isSpace()) {
+        return false;
+    }
+    pQuery->matchText(m_sqlColumns, m_argument, m_matchMode == StringMatch::Equals);
+    return true;
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -246,6 +295,15 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::compile(CompiledQuery* pQuery) const {
+    if (m_sqlColumns.isEmpty()) {
+        return false;
+    }
+    // NULL values are cached as empty strings
+    pQuery->matchText({m_sqlColumns.first()}, QString(), true);
+    return true;
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
         const QString& crateNameLike)
         : m_pCrateStorage(pCrateStorage),
@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "library/compiledquery.h"
 #include "proto/keys.pb.h"
 #include "track/track_decl.h"
 #include "util/assert.h"
@@ -31,6 +32,13 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Append the node to a compiled query. Returns false if the
+    /// node can only be evaluated by SQL.
+    virtual bool compile(CompiledQuery* pQuery) const {
+        Q_UNUSED(pQuery);
+        return false;
+    }
+
   protected:
     QueryNode() = default;
 };
@@ -53,12 +61,14 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool compile(CompiledQuery* pQuery) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool compile(CompiledQuery* pQuery) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +80,7 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool compile(CompiledQuery* pQuery) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -84,6 +95,7 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool compile(CompiledQuery* pQuery) const override;
 
   private:
     QSqlDatabase m_database;
@@ -102,6 +114,7 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool compile(CompiledQuery* pQuery) const override;
 
   private:
     QSqlDatabase m_database;
@@ -548,6 +548,18 @@ bool TrackCollection::saveTrack(Track* pTrack) const {
     return m_trackDao.saveTrack(pTrack);
 }
 
+void TrackCollection::saveTracksPrepare() const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_trackDao.saveTracksPrepare();
+}
+
+void TrackCollection::saveTracksFinish() const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_trackDao.saveTracksFinish();
+}
+
 TrackPointer TrackCollection::getTrackById(
         TrackId trackId) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
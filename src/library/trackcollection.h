@@ -164,6 +164,8 @@ class TrackCollection : public QObject,
     DirectoryDAO::RelocateResult relocateDirectory(const QString& oldDir, const QString& newDir);
 
     bool saveTrack(Track* pTrack) const;
+    void saveTracksPrepare() const;
+    void saveTracksFinish() const;
 
     QSqlDatabase m_database;
 
@@ -21,6 +21,11 @@ const QString kConfigGroup = QStringLiteral("[TrackCollection]");
 
 const ConfigKey kConfigKeyRepairDatabaseOnNextRestart(kConfigGroup, "RepairDatabaseOnNextRestart");
 
+// Queued tracks are saved after this delay at the latest...
+constexpr int kSaveQueueDelayMillis = 500;
+// ...or as soon as the queue contains this many tracks
+constexpr int kSaveQueueMaxSize = 256;
+
 inline
 parented_ptr<TrackCollection> createInternalTrackCollection(
         TrackCollectionManager* parent,
@@ -54,6 +59,13 @@ TrackCollectionManager::TrackCollectionManager(
 
     m_pInternalCollection->connectDatabase(dbConnection);
 
+    m_saveQueueTimer.setSingleShot(true);
+    m_saveQueueTimer.setInterval(kSaveQueueDelayMillis);
+    connect(&m_saveQueueTimer,
+            &QTimer::timeout,
+            this,
+            &TrackCollectionManager::saveQueuedTracks);
+
     if (deleteTrackForTestingFn) {
         kLogger.info() << "External collections are disabled in test mode";
     } else {
@@ -129,6 +141,8 @@ TrackCollectionManager::TrackCollectionManager(
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    saveQueuedTracks();
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -189,12 +203,65 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     return res;
 }
 
+void TrackCollectionManager::queueSaveTrack(const TrackPointer& pTrack) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    VERIFY_OR_DEBUG_ASSERT(pTrack) {
+        return;
+    }
+    const TrackId trackId = pTrack->getId();
+    if (!trackId.isValid()) {
+        // Not (or no longer) in the internal collection
+        saveTrack(pTrack);
+        return;
+    }
+    if (m_saveQueueTrackIds.contains(trackId)) {
+        // Coalesced with the pending save
+        return;
+    }
+    m_saveQueueTrackIds.insert(trackId);
+    m_saveQueue.append(pTrack);
+    if (m_saveQueue.size() >= kSaveQueueMaxSize) {
+        saveQueuedTracks();
+    } else if (!m_saveQueueTimer.isActive()) {
+        m_saveQueueTimer.start();
+    }
+}
+
+void TrackCollectionManager::saveQueuedTracks() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    m_saveQueueTimer.stop();
+    if (m_saveQueue.isEmpty()) {
+        return;
+    }
+    // Tracks that are queued while saving will be saved in the next batch
+    const QList<TrackPointer> saveQueue = std::move(m_saveQueue);
+    m_saveQueue.clear();
+    m_saveQueueTrackIds.clear();
+    kLogger.debug()
+            << "Saving"
+            << saveQueue.size()
+            << "queued track(s)";
+    m_pInternalCollection->saveTracksPrepare();
+    for (const auto& pTrack : saveQueue) {
+        saveTrack(pTrack.get(), TrackMetadataExportMode::Deferred);
+    }
+    m_pInternalCollection->saveTracksFinish();
+}
+
 // Export metadata and save the track in both the internal database
 // and external libraries.
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
     saveTrack(pTrack, TrackMetadataExportMode::Immediate);
 }
 
+void TrackCollectionManager::beginSavingEvictedTracks() noexcept {
+    m_pInternalCollection->saveTracksPrepare();
+}
+
+void TrackCollectionManager::endSavingEvictedTracks() noexcept {
+    m_pInternalCollection->saveTracksFinish();
+}
+
 TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         Track* pTrack,
         TrackMetadataExportMode mode) const {
@@ -3,6 +3,7 @@
 #include <QDir>
 #include <QList>
 #include <QSet>
+#include <QTimer>
 #include <memory>
 
 #include "library/dao/directorydao.h"
@@ -92,6 +93,14 @@ class TrackCollectionManager: public QObject,
     };
     SaveTrackResult saveTrack(const TrackPointer& pTrack) const;
 
+    /// Save the track later together with other modified tracks in a
+    /// single batch, e.g. when modifying many tracks at once. Queued
+    /// tracks are kept in the cache until they have been saved. A track
+    /// that is queued multiple times is only saved once.
+    void queueSaveTrack(const TrackPointer& pTrack);
+    /// Save all queued tracks now
+    void saveQueuedTracks();
+
   signals:
     void libraryScanStarted();
     void libraryScanFinished();
@@ -105,8 +114,10 @@ class TrackCollectionManager: public QObject,
     void afterTracksUpdated(const QSet<TrackId>& updatedTrackIds) const;
     void afterTracksRelocated(const QList<RelocatedTrack>& relocatedTracks) const;
 
-    // Callback for GlobalTrackCache
+    // Callbacks for GlobalTrackCache
     void saveEvictedTrack(Track* pTrack) noexcept override;
+    void beginSavingEvictedTracks() noexcept override;
+    void endSavingEvictedTracks() noexcept override;
 
     // Might be called from any thread
     enum class TrackMetadataExportMode {
@@ -126,6 +137,10 @@ class TrackCollectionManager: public QObject,
 
     QList<ExternalTrackCollection*> m_externalCollections;
 
+    QList<TrackPointer> m_saveQueue;
+    QSet<TrackId> m_saveQueueTrackIds;
+    QTimer m_saveQueueTimer;
+
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
 };
@@ -0,0 +1,471 @@
+#include "library/trackcolumnindex.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+constexpr int kTrigramLength = 3;
+constexpr int kRowSetBits = 64;
+
+// The empty string is always interned and never removed
+constexpr int kEmptyStringId = 0;
+
+// Avoid compacting small string tables over and over again
+constexpr int kMinUnusedStringCountForCompaction = 1024;
+
+quint64 trigramAt(const QString& string, int pos) {
+    return (static_cast<quint64>(string[pos].unicode()) << 32) |
+            (static_cast<quint64>(string[pos + 1].unicode()) << 16) |
+            static_cast<quint64>(string[pos + 2].unicode());
+}
+
+} // anonymous namespace
+
+TrackColumnIndex::TrackColumnIndex(const Rows& rows)
+        : m_rows(rows),
+          m_unusedStringCount(0),
+          m_keyOrdersNotation(KeyUtils::KeyNotation::Invalid) {
+    clear();
+}
+
+void TrackColumnIndex::setColumnTypes(QVector<ColumnType> columnTypes) {
+    m_columnTypes = std::move(columnTypes);
+    clear();
+}
+
+void TrackColumnIndex::clear() {
+    m_rowByTrackId.clear();
+    m_trackIdByRow.clear();
+    m_freeRows.clear();
+    m_columns.clear();
+    m_columns.resize(m_columnTypes.size());
+    m_stringIds.clear();
+    m_strings.clear();
+    m_stringRefCounts.clear();
+    m_unusedStringCount = 0;
+    m_collationKeys.clear();
+    m_collationRanks.clear();
+    m_keyOrders.clear();
+    m_foldedStrings.clear();
+    m_trigramPostings.clear();
+    const int emptyStringId = internString(QString());
+    DEBUG_ASSERT(emptyStringId == kEmptyStringId);
+}
+
+void TrackColumnIndex::updateRow(TrackId trackId) {
+    const auto rowsIter = m_rows.constFind(trackId);
+    if (rowsIter == m_rows.constEnd()) {
+        removeRow(trackId);
+        return;
+    }
+
+    int row = m_rowByTrackId.value(trackId, -1);
+    if (row < 0) {
+        if (m_freeRows.empty()) {
+            row = static_cast<int>(m_trackIdByRow.size());
+            m_trackIdByRow.push_back(trackId);
+            for (auto& column : m_columns) {
+                if (column.materialized) {
+                    column.numbers.resize(m_trackIdByRow.size());
+                    column.stringIds.resize(m_trackIdByRow.size());
+                }
+            }
+        } else {
+            row = m_freeRows.back();
+            m_freeRows.pop_back();
+            m_trackIdByRow[row] = trackId;
+        }
+        m_rowByTrackId.insert(trackId, row);
+    }
+
+    const QVector<QVariant>& values = rowsIter.value();
+    for (int i = 0; i < static_cast<int>(m_columns.size()); ++i) {
+        Column& column = m_columns[i];
+        if (column.materialized) {
+            storeValue(&column, i, row, values.value(i));
+        }
+    }
+    compactStrings();
+}
+
+void TrackColumnIndex::removeRow(TrackId trackId) {
+    const auto iter = m_rowByTrackId.find(trackId);
+    if (iter == m_rowByTrackId.end()) {
+        return;
+    }
+    const int row = iter.value();
+    m_rowByTrackId.erase(iter);
+    m_trackIdByRow[row] = TrackId();
+    m_freeRows.push_back(row);
+    for (auto& column : m_columns) {
+        if (column.materialized) {
+            releaseString(column.stringIds[row]);
+            column.stringIds[row] = kEmptyStringId;
+        }
+    }
+    compactStrings();
+}
+
+void TrackColumnIndex::materializeColumn(int column) {
+    Column& indexColumn = m_columns[column];
+    if (indexColumn.materialized) {
+        return;
+    }
+    indexColumn.materialized = true;
+    indexColumn.numbers.resize(m_trackIdByRow.size());
+    indexColumn.stringIds.resize(m_trackIdByRow.size());
+    for (int row = 0; row < static_cast<int>(m_trackIdByRow.size()); ++row) {
+        const auto rowsIter = m_rows.constFind(m_trackIdByRow[row]);
+        if (rowsIter != m_rows.constEnd()) {
+            storeValue(&indexColumn, column, row, rowsIter.value().value(column));
+        }
+    }
+}
+
+void TrackColumnIndex::storeValue(
+        Column* pColumn, int column, int row, const QVariant& value) {
+    if (columnType(column) == ColumnType::Numeric) {
+        pColumn->numbers[row] = value.toDouble();
+    } else {
+        const int stringId = internString(value.toString());
+        releaseString(pColumn->stringIds[row]);
+        pColumn->stringIds[row] = stringId;
+    }
+}
+
+int TrackColumnIndex::internString(const QString& string) {
+    const auto iter = m_stringIds.constFind(string);
+    if (iter != m_stringIds.constEnd()) {
+        const int stringId = iter.value();
+        if (stringId != kEmptyStringId && m_stringRefCounts[stringId]++ == 0) {
+            --m_unusedStringCount;
+        }
+        return stringId;
+    }
+    const int stringId = static_cast<int>(m_strings.size());
+    m_strings.push_back(string);
+    m_stringRefCounts.push_back(1);
+    m_stringIds.insert(string, stringId);
+    return stringId;
+}
+
+void TrackColumnIndex::releaseString(int stringId) {
+    if (stringId == kEmptyStringId) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_stringRefCounts[stringId] > 0) {
+        return;
+    }
+    if (--m_stringRefCounts[stringId] == 0) {
+        ++m_unusedStringCount;
+    }
+}
+
+void TrackColumnIndex::compactStrings() {
+    if (m_unusedStringCount < kMinUnusedStringCountForCompaction ||
+            m_unusedStringCount * 2 < static_cast<int>(m_strings.size())) {
+        return;
+    }
+    // The ids of the remaining strings keep their relative order. This
+    // preserves the order of the trigram postings and allows to keep the
+    // values that have been derived from the strings.
+    std::vector<int> newStringIds(m_strings.size(), -1);
+    int stringCount = 0;
+    for (std::size_t i = 0; i < m_strings.size(); ++i) {
+        if (static_cast<int>(i) == kEmptyStringId || m_stringRefCounts[i] > 0) {
+            newStringIds[i] = stringCount++;
+        }
+    }
+    const auto compact = [&newStringIds](auto* pValues) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < pValues->size(); ++i) {
+            if (newStringIds[i] < 0) {
+                continue;
+            }
+            if (count != i) {
+                (*pValues)[count] = std::move((*pValues)[i]);
+            }
+            ++count;
+        }
+        pValues->erase(pValues->begin() + count, pValues->end());
+    };
+    compact(&m_strings);
+    compact(&m_stringRefCounts);
+    compact(&m_collationKeys);
+    compact(&m_keyOrders);
+    compact(&m_foldedStrings);
+    // All ranks are reassigned when sorting
+    m_collationRanks.clear();
+    m_unusedStringCount = 0;
+
+    m_stringIds.clear();
+    for (std::size_t i = 0; i < m_strings.size(); ++i) {
+        m_stringIds.insert(m_strings[i], static_cast<int>(i));
+    }
+    for (auto& column : m_columns) {
+        for (auto& stringId : column.stringIds) {
+            stringId = newStringIds[stringId];
+        }
+    }
+    for (auto iter = m_trigramPostings.begin(); iter != m_trigramPostings.end();) {
+        std::vector<int>& postings = iter.value();
+        std::size_t count = 0;
+        for (const int stringId : postings) {
+            if (newStringIds[stringId] >= 0) {
+                postings[count++] = newStringIds[stringId];
+            }
+        }
+        postings.resize(count);
+        if (postings.empty()) {
+            iter = m_trigramPostings.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void TrackColumnIndex::updateCollationRanks(const mixxx::StringCollator& collator) {
+    if (m_collationRanks.size() == m_strings.size()) {
+        return;
+    }
+    // Collation keys of new strings are computed once, the ranks of all
+    // strings need to be reassigned.
+    for (std::size_t i = m_collationKeys.size(); i < m_strings.size(); ++i) {
+        m_collationKeys.push_back(collator.sortKey(m_strings[i]));
+    }
+    std::vector<int> order(m_strings.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int lhs, int rhs) {
+        return m_collationKeys[lhs].compare(m_collationKeys[rhs]) < 0;
+    });
+    m_collationRanks.resize(m_strings.size());
+    int rank = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (i > 0 &&
+                m_collationKeys[order[i - 1]].compare(m_collationKeys[order[i]]) != 0) {
+            ++rank;
+        }
+        m_collationRanks[order[i]] = rank;
+    }
+}
+
+void TrackColumnIndex::updateKeyOrders(KeyUtils::KeyNotation keyNotation) {
+    if (m_keyOrdersNotation != keyNotation) {
+        m_keyOrders.clear();
+        m_keyOrdersNotation = keyNotation;
+    }
+    for (std::size_t i = m_keyOrders.size(); i < m_strings.size(); ++i) {
+        m_keyOrders.push_back(KeyUtils::keyToCircleOfFifthsOrder(
+                KeyUtils::guessKeyFromText(m_strings[i]), keyNotation));
+    }
+}
+
+int TrackColumnIndex::compareRows(int column, int lhsRow, int rhsRow) const {
+    const Column& indexColumn = m_columns[column];
+    switch (columnType(column)) {
+    case ColumnType::Numeric: {
+        const double lhs = indexColumn.numbers[lhsRow];
+        const double rhs = indexColumn.numbers[rhsRow];
+        return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+    }
+    case ColumnType::Key:
+        return m_keyOrders[indexColumn.stringIds[lhsRow]] -
+                m_keyOrders[indexColumn.stringIds[rhsRow]];
+    case ColumnType::Text:
+        return m_collationRanks[indexColumn.stringIds[lhsRow]] -
+                m_collationRanks[indexColumn.stringIds[rhsRow]];
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return 0;
+}
+
+void TrackColumnIndex::sort(QVector<TrackId>* pTrackIds,
+        const QVector<ColumnOrder>& columnOrders,
+        const mixxx::StringCollator& collator,
+        KeyUtils::KeyNotation keyNotation) {
+    QVector<ColumnOrder> validColumnOrders;
+    for (const auto& columnOrder : columnOrders) {
+        VERIFY_OR_DEBUG_ASSERT(columnOrder.column >= 0 &&
+                columnOrder.column < static_cast<int>(m_columns.size())) {
+            continue;
+        }
+        materializeColumn(columnOrder.column);
+        validColumnOrders.append(columnOrder);
+    }
+    updateCollationRanks(collator);
+    updateKeyOrders(keyNotation);
+
+    std::vector<int> rows;
+    rows.reserve(pTrackIds->size());
+    QVector<TrackId> missingTrackIds;
+    for (const auto& trackId : std::as_const(*pTrackIds)) {
+        const int row = m_rowByTrackId.value(trackId, -1);
+        if (row >= 0) {
+            rows.push_back(row);
+        } else {
+            missingTrackIds.append(trackId);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [&](int lhsRow, int rhsRow) {
+        for (const auto& columnOrder : std::as_const(validColumnOrders)) {
+            int result = compareRows(columnOrder.column, lhsRow, rhsRow);
+            if (result != 0) {
+                return columnOrder.order == Qt::AscendingOrder ? result < 0 : result > 0;
+            }
+        }
+        return m_trackIdByRow[lhsRow] < m_trackIdByRow[rhsRow];
+    });
+
+    pTrackIds->resize(0); // keeps allocated memory
+    for (const int row : rows) {
+        pTrackIds->append(m_trackIdByRow[row]);
+    }
+    pTrackIds->append(missingTrackIds);
+}
+
+void TrackColumnIndex::updateTrigramIndex() {
+    std::vector<quint64> trigrams;
+    for (std::size_t i = m_foldedStrings.size(); i < m_strings.size(); ++i) {
+        QString folded = m_strings[i];
+        mixxx::DbConnection::makeStringLatinLow(&folded);
+        trigrams.clear();
+        for (int pos = 0; pos + kTrigramLength <= folded.size(); ++pos) {
+            trigrams.push_back(trigramAt(folded, pos));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        // The ids are appended in ascending order
+        for (const auto trigram : trigrams) {
+            m_trigramPostings[trigram].push_back(static_cast<int>(i));
+        }
+        m_foldedStrings.push_back(std::move(folded));
+    }
+}
+
+std::vector<char> TrackColumnIndex::matchStrings(
+        const QString& argument, bool exactMatch) const {
+    // At least one element for rows that have never been assigned a value
+    std::vector<char> matches(std::max<std::size_t>(m_foldedStrings.size(), 1), 0);
+    const auto isMatch = [&](int stringId) {
+        const QString& folded = m_foldedStrings[stringId];
+        return exactMatch ? folded == argument : folded.contains(argument);
+    };
+    if (argument.size() < kTrigramLength) {
+        for (std::size_t i = 0; i < m_foldedStrings.size(); ++i) {
+            matches[i] = isMatch(static_cast<int>(i));
+        }
+        return matches;
+    }
+    // Only the strings that contain the least frequent trigram of the
+    // argument need to be compared
+    const std::vector<int>* pCandidates = nullptr;
+    for (int pos = 0; pos + kTrigramLength <= argument.size(); ++pos) {
+        const auto iter = m_trigramPostings.constFind(trigramAt(argument, pos));
+        if (iter == m_trigramPostings.constEnd()) {
+            return matches;
+        }
+        if (!pCandidates || iter.value().size() < pCandidates->size()) {
+            pCandidates = &iter.value();
+        }
+    }
+    for (const int stringId : *pCandidates) {
+        matches[stringId] = isMatch(stringId);
+    }
+    return matches;
+}
+
+TrackColumnIndex::RowSet TrackColumnIndex::matchText(
+        const CompiledQuery::Instruction& instruction) const {
+    const std::vector<char> matches =
+            matchStrings(instruction.argument, instruction.exactMatch);
+    const std::size_t rowCount = m_trackIdByRow.size();
+    RowSet rowSet((rowCount + kRowSetBits - 1) / kRowSetBits, 0);
+    for (const int column : instruction.columns) {
+        const std::vector<int>& stringIds = m_columns[column].stringIds;
+        for (std::size_t row = 0; row < rowCount; ++row) {
+            rowSet[row / kRowSetBits] |=
+                    static_cast<quint64>(matches[stringIds[row]])
+                    << (row % kRowSetBits);
+        }
+    }
+    return rowSet;
+}
+
+void TrackColumnIndex::filter(QVector<TrackId>* pTrackIds, const CompiledQuery& query) {
+    for (const auto& instruction : query.instructions()) {
+        for (const int column : instruction.columns) {
+            VERIFY_OR_DEBUG_ASSERT(column >= 0 &&
+                    column < static_cast<int>(m_columns.size()) &&
+                    columnType(column) != ColumnType::Numeric) {
+                return;
+            }
+            materializeColumn(column);
+        }
+    }
+    updateTrigramIndex();
+
+    const std::size_t wordCount = (m_trackIdByRow.size() + kRowSetBits - 1) / kRowSetBits;
+    std::vector<RowSet> stack;
+    for (const auto& instruction : query.instructions()) {
+        switch (instruction.op) {
+        case CompiledQuery::Op::MatchText:
+            stack.push_back(matchText(instruction));
+            break;
+        case CompiledQuery::Op::Not:
+            VERIFY_OR_DEBUG_ASSERT(!stack.empty()) {
+                return;
+            }
+            for (auto& word : stack.back()) {
+                word = ~word;
+            }
+            break;
+        case CompiledQuery::Op::And:
+        case CompiledQuery::Op::Or: {
+            const bool isAnd = instruction.op == CompiledQuery::Op::And;
+            const std::size_t operandCount = instruction.operandCount;
+            VERIFY_OR_DEBUG_ASSERT(operandCount <= stack.size()) {
+                return;
+            }
+            if (operandCount == 0) {
+                // An empty AND matches all tracks, an empty OR none
+                stack.emplace_back(wordCount, isAnd ? ~quint64(0) : quint64(0));
+                break;
+            }
+            RowSet& result = stack[stack.size() - operandCount];
+            for (std::size_t i = stack.size() - operandCount + 1; i < stack.size(); ++i) {
+                const RowSet& operand = stack[i];
+                if (isAnd) {
+                    for (std::size_t word = 0; word < wordCount; ++word) {
+                        result[word] &= operand[word];
+                    }
+                } else {
+                    for (std::size_t word = 0; word < wordCount; ++word) {
+                        result[word] |= operand[word];
+                    }
+                }
+            }
+            stack.resize(stack.size() - operandCount + 1);
+            break;
+        }
+        }
+    }
+    VERIFY_OR_DEBUG_ASSERT(stack.size() == 1) {
+        return;
+    }
+    const RowSet& rowSet = stack.back();
+
+    QVector<TrackId>& trackIds = *pTrackIds;
+    int count = 0;
+    for (int i = 0; i < trackIds.size(); ++i) {
+        const int row = m_rowByTrackId.value(trackIds[i], -1);
+        if (row >= 0 && (rowSet[row / kRowSetBits] >> (row % kRowSetBits)) & 1) {
+            trackIds[count++] = trackIds[i];
+        }
+    }
+    trackIds.resize(count);
+}
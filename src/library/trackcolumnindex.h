@@ -0,0 +1,138 @@
+#pragma once
+
+#include <QCollator>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <vector>
+
+#include "library/compiledquery.h"
+#include "track/keyutils.h"
+#include "track/trackid.h"
+#include "util/string.h"
+
+/// A columnar copy of the values that are cached by BaseTrackCache for
+/// sorting many tracks at once without issuing an SQL query.
+///
+/// The values of each column are stored in a typed array that is indexed
+/// by a dense row number instead of comparing the QVariants of two rows
+/// again and again. Strings are interned and ranked once by their
+/// precomputed collation keys, i.e. sorting text columns only compares
+/// integers.
+///
+/// Columns are materialized when they are used for the first time. Only
+/// the columns that are actually needed occupy memory.
+///
+/// Text searches are looked up in a trigram index of all interned strings
+/// that is extended incrementally. Each string needs to be matched only
+/// once, no matter how many tracks share it. Compiled queries are then
+/// evaluated on bitsets of all rows.
+class TrackColumnIndex final {
+  public:
+    typedef QHash<TrackId, QVector<QVariant>> Rows;
+
+    enum class ColumnType {
+        // Compared as floating point numbers
+        Numeric,
+        // The text of a musical key, ordered by the circle of fifths
+        Key,
+        // Compared case-insensitive by the collator
+        Text,
+    };
+
+    struct ColumnOrder {
+        int column;
+        Qt::SortOrder order;
+    };
+
+    /// The rows are owned by the BaseTrackCache and must outlive the index.
+    explicit TrackColumnIndex(const Rows& rows);
+
+    void setColumnTypes(QVector<ColumnType> columnTypes);
+    ColumnType columnType(int column) const {
+        return m_columnTypes.value(column, ColumnType::Text);
+    }
+
+    /// Discard all rows and interned strings after the rows have been
+    /// rebuilt from scratch.
+    void clear();
+
+    /// Insert or update the row of a track after its values have
+    /// been modified.
+    void updateRow(TrackId trackId);
+    void removeRow(TrackId trackId);
+
+    /// The number of interned strings, including unused strings that
+    /// have not been removed yet.
+    int stringCount() const {
+        return static_cast<int>(m_strings.size());
+    }
+
+    /// Sort the tracks by the given columns. Ties are ordered by track id.
+    /// Tracks without a row are moved to the end.
+    void sort(QVector<TrackId>* pTrackIds,
+            const QVector<ColumnOrder>& columnOrders,
+            const mixxx::StringCollator& collator,
+            KeyUtils::KeyNotation keyNotation);
+
+    /// Remove all tracks that don't match the query while preserving the
+    /// order of the remaining tracks. The columns of all instructions
+    /// must have been resolved and must not be numeric.
+    void filter(QVector<TrackId>* pTrackIds, const CompiledQuery& query);
+
+  private:
+    struct Column {
+        bool materialized = false;
+        // Numeric
+        std::vector<double> numbers;
+        // Text and Key, indexes into m_strings. Rows without a
+        // value refer to the empty string.
+        std::vector<int> stringIds;
+    };
+
+    void materializeColumn(int column);
+    void storeValue(Column* pColumn, int column, int row, const QVariant& value);
+    int internString(const QString& string);
+    void releaseString(int stringId);
+    void compactStrings();
+
+    void updateCollationRanks(const mixxx::StringCollator& collator);
+    void updateKeyOrders(KeyUtils::KeyNotation keyNotation);
+
+    int compareRows(int column, int lhsRow, int rhsRow) const;
+
+    // One bit per row
+    typedef std::vector<quint64> RowSet;
+
+    void updateTrigramIndex();
+    std::vector<char> matchStrings(const QString& argument, bool exactMatch) const;
+    RowSet matchText(const CompiledQuery::Instruction& instruction) const;
+
+    const Rows& m_rows;
+    QVector<ColumnType> m_columnTypes;
+
+    QHash<TrackId, int> m_rowByTrackId;
+    std::vector<TrackId> m_trackIdByRow;
+    std::vector<int> m_freeRows;
+
+    std::vector<Column> m_columns;
+
+    // Interned strings are reference counted by the rows. Unreferenced
+    // strings are removed once they outnumber the referenced ones.
+    QHash<QString, int> m_stringIds;
+    std::vector<QString> m_strings;
+    std::vector<int> m_stringRefCounts;
+    int m_unusedStringCount;
+    std::vector<QCollatorSortKey> m_collationKeys;
+    // The sort order of all strings. Equal strings have the same rank.
+    std::vector<int> m_collationRanks;
+    std::vector<int> m_keyOrders;
+    KeyUtils::KeyNotation m_keyOrdersNotation;
+
+    // The interned strings in latin low for text searches
+    std::vector<QString> m_foldedStrings;
+    // The ids of all folded strings that contain a trigram in
+    // ascending order
+    QHash<quint64, std::vector<int>> m_trigramPostings;
+};
@@ -67,7 +67,8 @@ int ModalTrackBatchProcessor::processTracks(
         case ProcessNextTrackResult::ContinueProcessing:
             break;
         case ProcessNextTrackResult::SaveTrackAndContinueProcessing:
-            pTrackCollectionManager->saveTrack(pTrack);
+            // Modified tracks are saved in batches
+            pTrackCollectionManager->queueSaveTrack(pTrack);
             break;
         }
         ++finishedTrackCount;
@@ -89,6 +90,7 @@ int ModalTrackBatchProcessor::processTracks(
                                 static_cast<PercentageOfCompletion>(
                                         estimatedTotalCount));
     }
+    pTrackCollectionManager->saveQueuedTracks();
     return finishedTrackCount;
 }
 
@@ -55,6 +55,7 @@
 #include "waveform/sharedglcontext.h"
 #include "waveform/visualsmanager.h"
 #include "waveform/waveformwidgetfactory.h"
+#include "widget/controlwidgetconnection.h"
 #include "widget/wglwidget.h"
 #include "widget/wmainmenubar.h"
 
@@ -131,6 +132,8 @@ MixxxMainWindow::MixxxMainWindow(std::shared_ptr<mixxx::CoreServices> pCoreServi
     show();
 
     m_pGuiTick = new GuiTick();
+    // Skin widgets are updated once per frame
+    ControlWidgetConnection::setFrameChangeSet(m_pGuiTick->changeSet());
     m_pVisualsManager = new VisualsManager();
 }
 
@@ -516,6 +519,7 @@ MixxxMainWindow::~MixxxMainWindow() {
 
     WaveformWidgetFactory::destroy();
 
+    ControlWidgetConnection::setFrameChangeSet(nullptr);
     delete m_pGuiTick;
     delete m_pVisualsManager;
 }
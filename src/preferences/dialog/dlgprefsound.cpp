@@ -15,10 +15,6 @@
 #include "util/rlimit.h"
 #include "util/scopedoverridecursor.h"
 
-#ifdef __RUBBERBAND__
-#include "engine/bufferscalers/rubberbandworkerpool.h"
-#endif
-
 namespace {
 
 const QString kAppGroup = QStringLiteral("[App]");
@@ -41,7 +37,6 @@ bool soundItemAlreadyExists(const AudioPath& output, const QWidget& widget) {
     return false;
 }
 
-#ifdef __RUBBERBAND__
 const QString kKeylockMultiThreadedAvailable = QStringLiteral("<p>") +
         QObject::tr(
                 "Distribute stereo channels into mono channels processed in "
@@ -58,11 +53,6 @@ const QString kKeylockMultiThreadedUnavailableMono = QStringLiteral("<i>") +
         QObject::tr(
                 "Dual threading mode is incompatible with mono main mix.") +
         QStringLiteral("</i>");
-const QString kKeylockMultiThreadedUnavailableRubberband =
-        QStringLiteral("<i>") +
-        QObject::tr("Dual threading mode is only available with RubberBand.") +
-        QStringLiteral("</i>");
-#endif
 } // namespace
 
 /// Construct a new sound preferences pane. Initializes and populates
@@ -220,14 +210,10 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
             &DlgPrefSound::updateKeylockDualThreadingCheckbox);
-#ifdef __RUBBERBAND__
     connect(keylockDualthreadedCheckBox,
             &QCheckBox::clicked,
             this,
             &DlgPrefSound::updateKeylockMultithreading);
-#else
-    keylockDualthreadedCheckBox->hide();
-#endif
 
     connect(queryButton, &QAbstractButton::clicked, this, &DlgPrefSound::queryClicked);
 
@@ -338,7 +324,6 @@ void DlgPrefSound::slotApply() {
         m_pSettings->set(kKeylockEngingeCfgkey,
                 ConfigValue(static_cast<int>(keylockEngine)));
 
-#ifdef __RUBBERBAND__
         bool keylockMultithreading = m_pSettings->getValue(
                 kKeylockMultiThreadingCfgkey, false);
         m_pSettings->setValue(kKeylockMultiThreadingCfgkey,
@@ -350,9 +335,8 @@ void DlgPrefSound::slotApply() {
             QMessageBox::information(this,
                     tr("Information"),
                     tr("Mixxx must be restarted before the multi-threaded "
-                       "RubberBand setting change will take effect."));
+                       "keylock setting change will take effect."));
         }
-#endif
         status = m_pSoundManager->setConfig(m_config);
     }
     if (status != SoundDeviceStatus::Ok) {
@@ -548,12 +532,10 @@ void DlgPrefSound::loadSettings(const SoundManagerConfig& config) {
         keylockComboBox->setCurrentIndex(keylockComboBox->count() - 1);
     }
 
-#ifdef __RUBBERBAND__
     // Default is no multi threading on keylock
     keylockDualthreadedCheckBox->setChecked(m_pSettings->getValue(
             kKeylockMultiThreadingCfgkey,
             false));
-#endif
 
     // Collect selected I/O channel indices for all non-empty device comboboxes
     // in order to allow auto-selecting free channels when different devices are
@@ -749,21 +731,15 @@ void DlgPrefSound::settingChanged() {
         return; // doesn't count if we're just loading prefs
     }
     m_settingsModified = true;
-
-#ifdef __RUBBERBAND__
 }
 
 void DlgPrefSound::updateKeylockDualThreadingCheckbox() {
-    bool supportedScaler = keylockComboBox->currentData()
-                                   .value<EngineBuffer::KeylockEngine>() !=
-            EngineBuffer::KeylockEngine::SoundTouch;
+    // Both RubberBand and SoundTouch support the dual threading mode
     bool monoMix = mainOutputModeComboBox->currentIndex() == 1;
-    keylockDualthreadedCheckBox->setEnabled(!monoMix && supportedScaler);
+    keylockDualthreadedCheckBox->setEnabled(!monoMix);
     keylockDualthreadedCheckBox->setToolTip(monoMix
                     ? kKeylockMultiThreadedUnavailableMono
-                    : (supportedScaler
-                                      ? kKeylockMultiThreadedAvailable
-                                      : kKeylockMultiThreadedUnavailableRubberband));
+                    : kKeylockMultiThreadedAvailable);
 }
 
 void DlgPrefSound::updateKeylockMultithreading(bool enabled) {
@@ -790,7 +766,6 @@ void DlgPrefSound::updateKeylockMultithreading(bool enabled) {
     keylockDualthreadedCheckBox->setChecked(msg.clickedButton() == pYesBtn);
 
     updateKeylockDualThreadingCheckbox();
-#endif
 }
 
 /// Slot called when a device from the config can not be selected, i.e. is
@@ -952,9 +927,7 @@ void DlgPrefSound::mainEnabledChanged(double value) {
 void DlgPrefSound::mainOutputModeComboBoxChanged(int value) {
     m_pMainMonoMixdown->set(static_cast<double>(value));
 
-#ifdef __RUBBERBAND__
     updateKeylockDualThreadingCheckbox();
-#endif
 }
 
 void DlgPrefSound::mainMonoMixdownChanged(double value) {
@@ -74,10 +74,8 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     void deviceChannelsChanged();
     void configuredDeviceNotFound();
     void queryClicked();
-#ifdef __RUBBERBAND__
     void updateKeylockDualThreadingCheckbox();
     void updateKeylockMultithreading(bool enabled);
-#endif
 
   private:
     void initializePaths();
@@ -1,9 +1,11 @@
 #include "sources/soundsourceproxy.h"
 
+#include <QFile>
 #include <QMimeDatabase>
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <tuple>
 
 #include "sources/audiosourcetrackproxy.h"
 
@@ -556,6 +558,29 @@ importTrackMetadataAndCoverImageUnavailable() {
     return std::make_pair(mixxx::MetadataSource::ImportResult::Unavailable, QDateTime());
 }
 
+/// Detects if a file has been written
+struct FileState {
+    QDateTime lastModified;
+    qint64 size = -1;
+
+    bool isValid() const {
+        return lastModified.isValid() && size >= 0;
+    }
+
+    bool operator==(const FileState& other) const {
+        return lastModified == other.lastModified && size == other.size;
+    }
+};
+
+FileState readFileState(const QString& location) {
+    // Read the modification time directly from the file system to
+    // bypass the caching of QFileInfo
+    const QFile file(location);
+    return FileState{
+            file.fileTime(QFileDevice::FileModificationTime),
+            file.size()};
+}
+
 } // anonymous namespace
 
 //static
@@ -570,18 +595,56 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
         // https://github.com/mixxxdj/mixxx/issues/9944
         return importTrackMetadataAndCoverImageUnavailable();
     }
+    const auto trackRef = TrackRef::fromFileInfo(trackFileAccess.info());
     TrackPointer pTrack;
-    // Lock the global track cache while accessing the file to ensure
-    // that no metadata is written. Since locking individual files
-    // is not possible the whole cache has to be locked.
-    GlobalTrackCacheLocker locker;
-    pTrack = locker.lookupTrackByRef(TrackRef::fromFileInfo(trackFileAccess.info()));
+    FileState fileState;
+    {
+        // Metadata is only written into files of cached track objects
+        // while the whole cache is locked, so locking the shards of this
+        // file is sufficient to ensure that no write is in progress.
+        GlobalTrackCacheLocker locker(trackRef);
+        pTrack = locker.lookupTrackByRef(trackRef);
+        if (!pTrack) {
+            fileState = readFileState(trackFileAccess.info().location());
+        }
+    }
+    if (pTrack) {
+        // The track object synchronizes the access to its file
+        return SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
+                pTrackMetadata,
+                pCoverImage,
+                resetMissingTagMetadata);
+    }
+
+    // Parsing the file tags takes much longer than accessing the cache.
+    // Parse a temporary track object without holding the locks and verify
+    // afterwards that the file has not been written in the meantime.
+    const mixxx::TrackMetadata trackMetadata =
+            pTrackMetadata ? *pTrackMetadata : mixxx::TrackMetadata{};
+    auto result = SoundSourceProxy(Track::newTemporary(trackFileAccess))
+                          .importTrackMetadataAndCoverImage(
+                                  pTrackMetadata,
+                                  pCoverImage,
+                                  resetMissingTagMetadata);
+    GlobalTrackCacheLocker locker(trackRef);
+    if (fileState.isValid() &&
+            fileState == readFileState(trackFileAccess.info().location())) {
+        return result;
+    }
+    kLogger.info()
+            << "File has been modified while importing metadata"
+            << trackFileAccess.info().location();
+    // Import the metadata again while the cache is locked
+    if (pTrackMetadata) {
+        *pTrackMetadata = trackMetadata;
+    }
+    if (pCoverImage) {
+        *pCoverImage = QImage();
+    }
+    pTrack = locker.lookupTrackByRef(trackRef);
     if (pTrack) {
-        // We can safely unlock the cache if the track object is already cached.
         locker.unlockCache();
     } else {
-        // If the track object is not cached we need to keep the cache
-        // locked and create a temporary track object instead.
         pTrack = Track::newTemporary(std::move(trackFileAccess));
     }
     return SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
@@ -606,6 +669,30 @@ SoundSourceProxy::importTrackMetadataAndCoverImage(
             resetMissingTagMetadata);
 }
 
+//static
+SoundSourceProxy::ImportedMetadata SoundSourceProxy::importMetadataOfNewTrackFromFile(
+        mixxx::FileAccess trackFileAccess,
+        bool resetMissingTagMetadata,
+        CoverInfoGuesser* pCoverInfoGuesser) {
+    DEBUG_ASSERT(pCoverInfoGuesser);
+    const mixxx::FileInfo trackFileInfo = trackFileAccess.info();
+    ImportedMetadata importedMetadata;
+    QImage coverImage;
+    std::tie(importedMetadata.importResult, importedMetadata.sourceSynchronizedAt) =
+            importTrackMetadataAndCoverImageFromFile(
+                    std::move(trackFileAccess),
+                    &importedMetadata.trackMetadata,
+                    &coverImage,
+                    resetMissingTagMetadata);
+    if (importedMetadata.importResult != mixxx::MetadataSource::ImportResult::Unavailable) {
+        importedMetadata.coverInfo = pCoverInfoGuesser->guessCoverInfo(
+                trackFileInfo,
+                importedMetadata.trackMetadata.getAlbumInfo().getTitle(),
+                coverImage);
+    }
+    return importedMetadata;
+}
+
 namespace {
 
 inline bool shouldUpdateTrackMetadataFromSource(
@@ -635,7 +722,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const ImportedMetadata* pImportedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -705,13 +793,33 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
+    // The metadata that has been imported in advance is only valid for
+    // tracks that have never been synchronized, i.e. when importing into
+    // the default values of a new track. This also implies that the cover
+    // art has not been selected by the user.
+    if (pImportedMetadata &&
+            (sourceSyncStatus != mixxx::TrackRecord::SourceSyncStatus::Void ||
+                    !pCoverImg)) {
+        pImportedMetadata = nullptr;
+    }
+
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    mixxx::MetadataSource::ImportResult metadataImportResult;
+    QDateTime sourceSynchronizedAt;
+    if (pImportedMetadata) {
+        metadataImportResult = pImportedMetadata->importResult;
+        sourceSynchronizedAt = pImportedMetadata->sourceSynchronizedAt;
+        if (metadataImportResult == mixxx::MetadataSource::ImportResult::Succeeded) {
+            trackMetadata = pImportedMetadata->trackMetadata;
+        }
+    } else {
+        std::tie(metadataImportResult, sourceSynchronizedAt) =
+                importTrackMetadataAndCoverImage(
+                        &trackMetadata,
+                        pCoverImg,
+                        syncParams.resetMissingTagMetadataOnImport);
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -859,7 +967,11 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
-    if (pCoverImg) {
+    if (pImportedMetadata) {
+        // The cover art has already been guessed
+        DEBUG_ASSERT(pImportedMetadata->coverInfo.source == CoverInfo::GUESSED);
+        m_pTrack->setCoverInfo(pImportedMetadata->coverInfo);
+    } else if (pCoverImg) {
         // If the pointer is not null then the cover art should be guessed
         auto coverInfo =
                 CoverInfoGuesser().guessCoverInfo(
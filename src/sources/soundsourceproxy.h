@@ -1,9 +1,13 @@
 #pragma once
 
+#include <QDateTime>
+#include <QMetaType>
 #include <QMimeType>
 
+#include "library/coverart.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
+#include "track/trackmetadata.h"
 
 namespace mixxx {
 
@@ -12,6 +16,8 @@ class FileInfo;
 
 } // namespace mixxx
 
+class CoverInfoGuesser;
+
 /// Creates sound sources for tracks. Only intended to be used
 /// in a narrow scope and not shareable between multiple threads!
 class SoundSourceProxy {
@@ -121,6 +127,32 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata) const;
 
+    /// Track metadata and cover art of a file that have been imported
+    /// in advance, i.e. before the track object for the file is created.
+    struct ImportedMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        // Guessed from the embedded cover image or image files
+        // in the same folder.
+        CoverInfoRelative coverInfo;
+    };
+
+    /// Import the track metadata of a file that has not been added to
+    /// the library yet and guess its cover art.
+    ///
+    /// Parsing the file tags is the most expensive part of adding a new
+    /// track to the library. This function is thread-safe and is invoked
+    /// concurrently by the worker threads of the library scanner. The
+    /// result is passed to updateTrackFromSource() when adding the track
+    /// to the database. The provided CoverInfoGuesser caches the cover
+    /// files of the last visited folder.
+    static ImportedMetadata importMetadataOfNewTrackFromFile(
+            mixxx::FileAccess trackFileAccess,
+            bool resetMissingTagMetadata,
+            CoverInfoGuesser* pCoverInfoGuesser);
+
     /// Controls which (metadata/coverart) and how tags are (re-)imported from
     /// audio files when creating a SoundSourceProxy.
     ///
@@ -172,10 +204,16 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// Metadata that has been imported in advance by
+    /// importMetadataOfNewTrackFromFile() is only used if the track has
+    /// never been synchronized with its file before. Otherwise the file
+    /// is read again.
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const ImportedMetadata* pImportedMetadata = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -242,3 +280,5 @@ class SoundSourceProxy {
     // the corresponding track pointer. Don't pass it around!!
     mixxx::SoundSourcePointer m_pSoundSource;
 };
+
+Q_DECLARE_METATYPE(SoundSourceProxy::ImportedMetadata)
@@ -1,7 +1,9 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QDir>
 #include <QtDebug>
+#include <cmath>
 #include <vector>
 
 #include "analyzer/analyzertrack.h"
@@ -130,4 +132,121 @@ TEST_F(AnalyzerWaveformTest, canary) {
     EXPECT_DOUBLE_EQ(pWaveformSummary->getAudioVisualRatio(), 1.0);
 }
 
+// A waveform with the size of a 5 minute track and stems
+WaveformPointer createWaveform() {
+    auto pWaveform = WaveformPointer(new Waveform(44100, 5 * 60 * 44100, 441, -1, 4));
+    WaveformData* pData = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        const auto value = static_cast<unsigned char>(
+                128 + 100 * std::sin(i * 0.001) * std::cos(i * 0.37));
+        pData[i].filtered.all = value;
+        pData[i].filtered.low = value / 2;
+        pData[i].filtered.mid = value / 3;
+        pData[i].filtered.high = static_cast<unsigned char>(i);
+        for (int stemIdx = 0; stemIdx < 4; ++stemIdx) {
+            pData[i].stems[stemIdx] = static_cast<unsigned char>(value >> stemIdx);
+        }
+    }
+    return pWaveform;
+}
+
+TEST(WaveformEncodingTest, compactRoundTrip) {
+    const auto pWaveform = createWaveform();
+    const QByteArray compact = pWaveform->toCompactByteArray();
+    EXPECT_TRUE(Waveform::isCompactByteArray(compact));
+    EXPECT_FALSE(Waveform::isCompactByteArray(pWaveform->toByteArray()));
+
+    const Waveform decoded(compact);
+    EXPECT_EQ(pWaveform->getDataSize(), decoded.getDataSize());
+    EXPECT_EQ(pWaveform->getDataSize(), decoded.getCompletion());
+    EXPECT_TRUE(decoded.hasStem());
+    EXPECT_DOUBLE_EQ(pWaveform->getAudioVisualRatio(), decoded.getAudioVisualRatio());
+    // Both encodings carry the same data
+    EXPECT_EQ(pWaveform->toByteArray(), decoded.toByteArray());
+    EXPECT_EQ(compact, Waveform(pWaveform->toByteArray()).toCompactByteArray());
+}
+
+TEST(WaveformEncodingTest, compactTruncated) {
+    const QByteArray compact = createWaveform()->toCompactByteArray();
+    EXPECT_EQ(0, Waveform(compact.left(compact.size() - 1)).getDataSize());
+    EXPECT_EQ(0, Waveform(compact.left(10)).getDataSize());
+}
+
+// Decoding a stored waveform when loading a track with the protobuf
+// encoding (0) and the compact encoding (1)
+void BM_DecodeStoredWaveform(benchmark::State& state) {
+    const auto pWaveform = createWaveform();
+    const QByteArray stored = qCompress(state.range(0) != 0
+                    ? pWaveform->toCompactByteArray()
+                    : pWaveform->toByteArray());
+    for (auto _ : state) {
+        const Waveform decoded(qUncompress(stored));
+        benchmark::DoNotOptimize(decoded.getDataSize());
+    }
+    state.counters["stored_bytes"] = static_cast<double>(stored.size());
+}
+BENCHMARK(BM_DecodeStoredWaveform)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// The strides are completed at the same positions as when checking
+// every single position.
+TEST(WaveformStrideTest, framesUntilStrideEnd) {
+    for (const double length : {0.5, 1.0, 22.96875, 99.99, 100.0, 441.0 / 7}) {
+        int position = 0;
+        int expectedEnd = 1;
+        while (position < 100000) {
+            while (std::fmod(expectedEnd, length) >= 1) {
+                ++expectedEnd;
+            }
+            ASSERT_EQ(expectedEnd - position,
+                    WaveformStride::framesUntilStrideEnd(position, length))
+                    << "length" << length << "position" << position;
+            position = expectedEnd;
+            ++expectedEnd;
+        }
+    }
+}
+
+// The summary is identical if the full resolution waveform is skipped
+TEST_F(AnalyzerWaveformTest, summaryOnly) {
+    constexpr SINT kFrameLength = 44100;
+    constexpr SINT kChunkFrames = 1000;
+    std::vector<CSAMPLE> samples(kFrameLength * kChannelCount);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<CSAMPLE>(std::sin(i * 0.0123) * std::cos(i * 0.00017));
+    }
+
+    TrackPointer pSummaryTrack = Track::newTemporary();
+    pSummaryTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(kChannelCount),
+            mixxx::audio::SampleRate(44100),
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromMillis(1000));
+    AnalyzerWaveform summaryAnalyzer(
+            config(), QSqlDatabase(), AnalyzerWaveform::Mode::SummaryOnly);
+
+    ASSERT_TRUE(m_aw.initialize(AnalyzerTrack(m_pTrack),
+            m_pTrack->getSampleRate(),
+            m_pTrack->getChannels(),
+            kFrameLength));
+    ASSERT_TRUE(summaryAnalyzer.initialize(AnalyzerTrack(pSummaryTrack),
+            pSummaryTrack->getSampleRate(),
+            pSummaryTrack->getChannels(),
+            kFrameLength));
+    for (SINT frame = 0; frame < kFrameLength; frame += kChunkFrames) {
+        const SINT count = math_min(kChunkFrames, kFrameLength - frame) * kChannelCount;
+        EXPECT_TRUE(m_aw.processSamples(&samples[frame * kChannelCount], count));
+        EXPECT_TRUE(summaryAnalyzer.processSamples(&samples[frame * kChannelCount], count));
+    }
+    m_aw.storeResults(m_pTrack);
+    m_aw.cleanup();
+    summaryAnalyzer.storeResults(pSummaryTrack);
+    summaryAnalyzer.cleanup();
+
+    EXPECT_EQ(nullptr, pSummaryTrack->getWaveform());
+    ASSERT_NE(nullptr, m_pTrack->getWaveformSummary());
+    ASSERT_NE(nullptr, pSummaryTrack->getWaveformSummary());
+    EXPECT_EQ(m_pTrack->getWaveformSummary()->toByteArray(),
+            pSummaryTrack->getWaveformSummary()->toByteArray());
+}
+
 } // namespace
@@ -0,0 +1,91 @@
+#include "analyzer/analyzerchunk.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/plugins/buffering_utils.h"
+
+namespace {
+
+constexpr SINT kNumFrames = 1000;
+
+class AnalyzerChunkTest : public testing::Test {
+  protected:
+    static std::vector<CSAMPLE> makeSamples(mixxx::audio::ChannelCount channelCount) {
+        std::vector<CSAMPLE> samples(kNumFrames * channelCount);
+        for (SINT i = 0; i < static_cast<SINT>(samples.size()); ++i) {
+            samples[i] = static_cast<CSAMPLE>(i % 17) / 16;
+        }
+        return samples;
+    }
+};
+
+TEST_F(AnalyzerChunkTest, StereoViewsReferenceSamples) {
+    const auto samples = makeSamples(mixxx::audio::ChannelCount::stereo());
+    AnalyzerChunk chunk;
+    chunk.prepare(samples.data(),
+            static_cast<SINT>(samples.size()),
+            mixxx::audio::ChannelCount::stereo(),
+            AnalyzerChunk::MonoMix);
+    EXPECT_EQ(kNumFrames, chunk.frameCount());
+    EXPECT_EQ(samples.data(), chunk.samples());
+    // No copy for the stereo mix of a stereo signal
+    EXPECT_EQ(samples.data(), chunk.stereoMix());
+    for (SINT i = 0; i < kNumFrames; ++i) {
+        EXPECT_FLOAT_EQ((samples[2 * i] + samples[2 * i + 1]) * 0.5f, chunk.monoMix()[i]);
+    }
+}
+
+TEST_F(AnalyzerChunkTest, StemsMixedToStereo) {
+    const auto samples = makeSamples(mixxx::audio::ChannelCount::stem());
+    AnalyzerChunk chunk;
+    chunk.prepare(samples.data(),
+            static_cast<SINT>(samples.size()),
+            mixxx::audio::ChannelCount::stem(),
+            AnalyzerChunk::StereoMix);
+    EXPECT_EQ(kNumFrames, chunk.frameCount());
+    EXPECT_NE(samples.data(), chunk.stereoMix());
+    for (SINT i = 0; i < kNumFrames; ++i) {
+        CSAMPLE left = 0;
+        CSAMPLE right = 0;
+        for (int stem = 0; stem < 4; ++stem) {
+            left += samples[8 * i + 2 * stem];
+            right += samples[8 * i + 2 * stem + 1];
+        }
+        EXPECT_FLOAT_EQ(left, chunk.stereoMix()[2 * i]);
+        EXPECT_FLOAT_EQ(right, chunk.stereoMix()[2 * i + 1]);
+    }
+}
+
+// Plugins receive identical windows from the shared mono view
+TEST_F(AnalyzerChunkTest, MonoSamplesFramedLikeStereoSamples) {
+    const auto samples = makeSamples(mixxx::audio::ChannelCount::stereo());
+    AnalyzerChunk chunk;
+    chunk.prepare(samples.data(),
+            static_cast<SINT>(samples.size()),
+            mixxx::audio::ChannelCount::stereo(),
+            AnalyzerChunk::MonoMix);
+
+    std::vector<std::vector<double>> stereoWindows;
+    mixxx::DownmixAndOverlapHelper stereoHelper;
+    ASSERT_TRUE(stereoHelper.initialize(256, 128, [&](double* pBuffer, size_t frames) {
+        stereoWindows.emplace_back(pBuffer, pBuffer + frames);
+        return true;
+    }));
+    std::vector<std::vector<double>> monoWindows;
+    mixxx::DownmixAndOverlapHelper monoHelper;
+    ASSERT_TRUE(monoHelper.initialize(256, 128, [&](double* pBuffer, size_t frames) {
+        monoWindows.emplace_back(pBuffer, pBuffer + frames);
+        return true;
+    }));
+
+    EXPECT_TRUE(stereoHelper.processStereoSamples(samples.data(), samples.size()));
+    EXPECT_TRUE(stereoHelper.finalize());
+    EXPECT_TRUE(monoHelper.processMonoSamples(chunk.monoMix(), chunk.frameCount()));
+    EXPECT_TRUE(monoHelper.finalize());
+    ASSERT_FALSE(stereoWindows.empty());
+    EXPECT_EQ(stereoWindows, monoWindows);
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+#include "library/basetrackcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+#include <algorithm>
+#include <memory>
+
+#include "test/librarytest.h"
+
+namespace {
+
+const QString kTableName = QStringLiteral("base_track_cache_test");
+
+class BaseTrackCacheTest : public LibraryTest {
+  protected:
+    BaseTrackCacheTest() {
+        QSqlQuery query(internalCollection()->database());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "CREATE TEMPORARY TABLE %1 (id INTEGER PRIMARY KEY, "
+                "artist TEXT, album_artist TEXT, album TEXT, title TEXT)")
+                                       .arg(kTableName)));
+        // Rows with NULL and empty values
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "INSERT INTO %1 VALUES "
+                "(1, 'Foo', NULL, 'Bar', 'One'), "
+                "(2, NULL, NULL, NULL, 'Two'), "
+                "(3, 'Baz', 'Foo', NULL, 'Three'), "
+                "(4, '', '', '', 'Four')")
+                                       .arg(kTableName)));
+
+        const QStringList searchColumns = {
+                QStringLiteral("artist"),
+                QStringLiteral("album_artist"),
+                QStringLiteral("album"),
+                QStringLiteral("title"),
+        };
+        m_pCache = std::make_unique<BaseTrackCache>(internalCollection(),
+                kTableName,
+                QStringLiteral("id"),
+                QStringList{QStringLiteral("id")} + searchColumns,
+                searchColumns,
+                false);
+    }
+
+    QList<int> filter(const QString& searchQuery, const QString& extraFilter) {
+        QSet<TrackId> trackIds;
+        for (int id = 1; id <= 4; ++id) {
+            trackIds.insert(TrackId(QVariant(id)));
+        }
+        QHash<TrackId, int> trackToIndex;
+        m_pCache->filterAndSort(trackIds,
+                searchQuery,
+                extraFilter,
+                QString(),
+                {},
+                0,
+                &trackToIndex);
+        QList<int> ids;
+        for (auto it = trackToIndex.constBegin(); it != trackToIndex.constEnd(); ++it) {
+            ids.append(it.key().toVariant().toInt());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    QList<int> sort(const QList<SortColumn>& sortColumns, int columnOffset) {
+        QSet<TrackId> trackIds;
+        for (int id = 1; id <= 4; ++id) {
+            trackIds.insert(TrackId(QVariant(id)));
+        }
+        QHash<TrackId, int> trackToIndex;
+        m_pCache->filterAndSort(trackIds,
+                QString(),
+                QString(),
+                QStringLiteral("ORDER BY title"),
+                sortColumns,
+                columnOffset,
+                &trackToIndex);
+        QList<int> ids(trackToIndex.size());
+        for (auto it = trackToIndex.constBegin(); it != trackToIndex.constEnd(); ++it) {
+            ids[it.value()] = it.key().toVariant().toInt();
+        }
+        return ids;
+    }
+
+    std::unique_ptr<BaseTrackCache> m_pCache;
+};
+
+TEST_F(BaseTrackCacheTest, FilterNullValuesLikeSql) {
+    const QStringList searchQueries = {
+            QStringLiteral("foo"),
+            QStringLiteral("-foo"),
+            QStringLiteral("-artist:foo"),
+            QStringLiteral("-album:bar"),
+            QStringLiteral("one -album:bar"),
+            QStringLiteral("album:\"\""),
+            QStringLiteral("-album:\"\""),
+            QStringLiteral("-artist:\"\""),
+    };
+    for (const auto& searchQuery : searchQueries) {
+        // A non-empty extra filter forces the search to be executed by SQL
+        EXPECT_EQ(filter(searchQuery, QStringLiteral("1")), filter(searchQuery, QString()))
+                << searchQuery.toStdString();
+    }
+}
+
+TEST_F(BaseTrackCacheTest, SortSkipsTableColumns) {
+    // The model has an id column and two table columns in front of the
+    // columns of the cache
+    constexpr int kColumnOffset = 2;
+    const int titleColumn = m_pCache->fieldIndex(QStringLiteral("title"));
+    ASSERT_GT(titleColumn, 0);
+    // The last table column must not be mistaken for the id column
+    EXPECT_EQ(QList<int>({2, 3, 1, 4}),
+            sort({SortColumn(kColumnOffset, Qt::AscendingOrder),
+                         SortColumn(titleColumn + kColumnOffset, Qt::DescendingOrder)},
+                    kColumnOffset));
+    EXPECT_EQ(QList<int>({4, 3, 2, 1}),
+            sort({SortColumn(0, Qt::DescendingOrder)}, kColumnOffset));
+}
+
+} // namespace
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "engine/cachingreader/cachingreader.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[test]");
+
+constexpr SINT kNumChunks = 4;
+
+const mixxx::IndexRange kFrameIndexRange = mixxx::IndexRange::forward(
+        0, kNumChunks * CachingReaderChunk::kFrames);
+
+} // namespace
+
+// The worker thread is stopped and its part is played by the test.
+// Read requests stay pending until they are explicitly discarded.
+class CachingReaderTest : public MixxxTest {
+  protected:
+    CachingReaderTest()
+            : m_reader(kGroup, config(), mixxx::audio::ChannelCount::stem()) {
+        m_reader.m_worker.quitWait();
+    }
+
+    void loadTrack(CachingReaderChunkPool* pChunkPool) {
+        m_reader.m_state.storeRelease(CachingReader::STATE_TRACK_LOADING);
+        const auto update = ReaderStatusUpdate::trackLoaded(
+                kFrameIndexRange, pChunkPool);
+        ASSERT_EQ(1, m_reader.m_readerStatusUpdateFIFO.write(&update, 1));
+        m_reader.process();
+    }
+
+    void requestChunk(SINT chunkIndex) {
+        auto* pChunk = m_reader.allocateChunk(chunkIndex);
+        ASSERT_NE(nullptr, pChunk);
+        ASSERT_TRUE(m_reader.submitReadRequest(
+                pChunk, CachingReaderChunk::ReadPriority::PlayPosition));
+    }
+
+    void discardReadRequests() {
+        CachingReaderChunkReadRequest request;
+        while (m_reader.m_chunkReadRequestFIFO.read(&request, 1) == 1) {
+            const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
+            ASSERT_EQ(1, m_reader.m_readerStatusUpdateFIFO.write(&update, 1));
+        }
+        m_reader.process();
+    }
+
+    const CachingReaderChunkPool* chunkPool() const {
+        return m_reader.m_pChunkPool;
+    }
+
+    const CachingReaderChunkPool* pendingChunkPool() const {
+        return m_reader.m_pPendingChunkPool;
+    }
+
+    CachingReader::ReadResult readFirstFrames() {
+        // Two stereo frames
+        CSAMPLE buffer[4];
+        return m_reader.read(0,
+                4,
+                false,
+                buffer,
+                mixxx::audio::ChannelCount::stereo());
+    }
+
+    CachingReader m_reader;
+};
+
+TEST_F(CachingReaderTest, adoptChunkPoolAfterPendingReads) {
+    auto* pStereoPool = new CachingReaderChunkPool(
+            kNumChunks, mixxx::audio::ChannelCount::stereo(), false);
+    loadTrack(pStereoPool);
+    EXPECT_EQ(pStereoPool, chunkPool());
+
+    // Load a stem track while a read for the previous track is pending
+    requestChunk(0);
+    auto* pStemPool = new CachingReaderChunkPool(
+            kNumChunks, mixxx::audio::ChannelCount::stem(), false);
+    loadTrack(pStemPool);
+    // The pending chunk still belongs to the stereo pool
+    EXPECT_EQ(pStereoPool, chunkPool());
+    EXPECT_EQ(pStemPool, pendingChunkPool());
+    EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE, readFirstFrames());
+
+    discardReadRequests();
+    EXPECT_EQ(pStemPool, chunkPool());
+    EXPECT_EQ(nullptr, pendingChunkPool());
+
+    // A track that needs yet another pool replaces it immediately
+    auto* pResidentPool = new CachingReaderChunkPool(
+            2 * kNumChunks, mixxx::audio::ChannelCount::stereo(), true);
+    loadTrack(pResidentPool);
+    EXPECT_EQ(pResidentPool, chunkPool());
+    EXPECT_EQ(nullptr, pendingChunkPool());
+}
+
+TEST_F(CachingReaderTest, supersedePendingChunkPool) {
+    auto* pStereoPool = new CachingReaderChunkPool(
+            kNumChunks, mixxx::audio::ChannelCount::stereo(), false);
+    loadTrack(pStereoPool);
+    requestChunk(0);
+    requestChunk(1);
+
+    // Two consecutive loads while the reads are pending
+    auto* pStemPool = new CachingReaderChunkPool(
+            kNumChunks, mixxx::audio::ChannelCount::stem(), false);
+    loadTrack(pStemPool);
+    auto* pResidentPool = new CachingReaderChunkPool(
+            2 * kNumChunks, mixxx::audio::ChannelCount::stereo(), true);
+    loadTrack(pResidentPool);
+    EXPECT_EQ(pStereoPool, chunkPool());
+    EXPECT_EQ(pResidentPool, pendingChunkPool());
+
+    // Only the most recent pool is adopted
+    discardReadRequests();
+    EXPECT_EQ(pResidentPool, chunkPool());
+    EXPECT_EQ(nullptr, pendingChunkPool());
+}
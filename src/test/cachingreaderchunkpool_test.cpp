@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <QSet>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+
+namespace {
+
+class CachingReaderChunkPoolTest : public testing::Test {
+};
+
+TEST_F(CachingReaderChunkPoolTest, takeAndPutFreeChunks) {
+    constexpr SINT kNumChunks = 8;
+    CachingReaderChunkPool pool(
+            kNumChunks, mixxx::audio::ChannelCount::stereo(), false);
+    EXPECT_EQ(kNumChunks, pool.size());
+    EXPECT_EQ(mixxx::audio::ChannelCount::stereo(), pool.channelCount());
+    EXPECT_FALSE(pool.isResident());
+
+    QSet<CachingReaderChunkForOwner*> takenChunks;
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        auto* pChunk = pool.takeFreeChunk();
+        ASSERT_NE(nullptr, pChunk);
+        EXPECT_EQ(CachingReaderChunkForOwner::FREE, pChunk->getState());
+        takenChunks.insert(pChunk);
+    }
+    EXPECT_EQ(kNumChunks, takenChunks.size());
+    // All chunks have been taken
+    EXPECT_EQ(nullptr, pool.takeFreeChunk());
+
+    for (auto* pChunk : std::as_const(takenChunks)) {
+        pool.putFreeChunk(pChunk);
+    }
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        EXPECT_TRUE(takenChunks.contains(pool.takeFreeChunk()));
+    }
+    EXPECT_EQ(nullptr, pool.takeFreeChunk());
+}
+
+TEST_F(CachingReaderChunkPoolTest, allocatedChunks) {
+    CachingReaderChunkPool pool(4, mixxx::audio::ChannelCount::stem(), true);
+    EXPECT_TRUE(pool.isResident());
+
+    auto* pChunk = pool.takeFreeChunk();
+    ASSERT_NE(nullptr, pChunk);
+    pChunk->init(3);
+    pool.insertAllocatedChunk(pChunk);
+    EXPECT_EQ(pChunk, pool.lookupAllocatedChunk(3));
+    EXPECT_EQ(nullptr, pool.lookupAllocatedChunk(2));
+
+    // Another chunk with the same index must not be removed
+    auto* pOtherChunk = pool.takeFreeChunk();
+    ASSERT_NE(nullptr, pOtherChunk);
+    pOtherChunk->init(3);
+    EXPECT_EQ(0, pool.removeAllocatedChunk(pOtherChunk));
+    EXPECT_EQ(pChunk, pool.lookupAllocatedChunk(3));
+    pOtherChunk->free();
+    pool.putFreeChunk(pOtherChunk);
+
+    EXPECT_EQ(1, pool.removeAllocatedChunk(pChunk));
+    EXPECT_EQ(nullptr, pool.lookupAllocatedChunk(3));
+    EXPECT_EQ(0, pool.removeAllocatedChunk(pChunk));
+    pChunk->free();
+    pool.putFreeChunk(pChunk);
+}
+
+TEST_F(CachingReaderChunkPoolTest, raiseReadPriority) {
+    CachingReaderChunkPool pool(1, mixxx::audio::ChannelCount::stereo(), false);
+    auto* pChunk = pool.takeFreeChunk();
+    ASSERT_NE(nullptr, pChunk);
+    pChunk->init(0);
+    pChunk->initReadPriority(CachingReaderChunk::ReadPriority::Cue, 1);
+    pChunk->giveToWorker();
+    EXPECT_EQ(CachingReaderChunk::ReadPriority::Cue, pChunk->getReadPriority());
+    EXPECT_EQ(1, pChunk->getReadEpoch());
+
+    // A lower priority is ignored, but the epoch is renewed
+    pChunk->raiseReadPriority(CachingReaderChunk::ReadPriority::Prefetch, 2);
+    EXPECT_EQ(CachingReaderChunk::ReadPriority::Cue, pChunk->getReadPriority());
+    EXPECT_EQ(2, pChunk->getReadEpoch());
+
+    pChunk->raiseReadPriority(CachingReaderChunk::ReadPriority::PlayPosition, 2);
+    EXPECT_EQ(CachingReaderChunk::ReadPriority::PlayPosition, pChunk->getReadPriority());
+
+    pChunk->takeFromWorker();
+    pChunk->free();
+    pool.putFreeChunk(pChunk);
+}
+
+} // namespace
@@ -0,0 +1,129 @@
+#include "engine/cachingreader/cachingreaderdiskcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+#include <limits>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+
+namespace {
+
+const auto kChannelCount = mixxx::audio::ChannelCount::stereo();
+const auto kSampleRate = mixxx::audio::SampleRate(44100);
+const auto kFrameIndexRange = mixxx::IndexRange::forward(
+        0, 3 * CachingReaderChunk::kFrames + 100);
+
+class CachingReaderDiskCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    std::unique_ptr<CachingReaderDiskCache> openCache(
+            const QString& cacheKey,
+            const mixxx::IndexRange& frameIndexRange = kFrameIndexRange) {
+        return CachingReaderDiskCache::open(
+                m_tempDir.path(),
+                cacheKey,
+                kChannelCount,
+                kSampleRate,
+                frameIndexRange);
+    }
+
+    static void fillChunk(CachingReaderDiskCache* pCache, SINT chunkIndex) {
+        CSAMPLE* pSamples = pCache->writableChunkSamples(chunkIndex);
+        for (SINT i = 0; i < CachingReaderChunk::kFrames * kChannelCount; ++i) {
+            pSamples[i] = static_cast<CSAMPLE>(chunkIndex) + i * 0.5f;
+        }
+        pCache->markChunkCached(chunkIndex);
+    }
+
+    const QTemporaryDir m_tempDir;
+};
+
+TEST_F(CachingReaderDiskCacheTest, storeAndReopen) {
+    {
+        auto pCache = openCache(QStringLiteral("track"));
+        ASSERT_NE(nullptr, pCache);
+        EXPECT_EQ(4, pCache->numChunks());
+        for (SINT i = 0; i < pCache->numChunks(); ++i) {
+            EXPECT_FALSE(pCache->isChunkCached(i));
+        }
+        fillChunk(pCache.get(), 2);
+        EXPECT_TRUE(pCache->isChunkCached(2));
+    }
+
+    // The cached chunks survive closing the file
+    auto pCache = openCache(QStringLiteral("track"));
+    ASSERT_NE(nullptr, pCache);
+    EXPECT_FALSE(pCache->isChunkCached(0));
+    EXPECT_FALSE(pCache->isChunkCached(1));
+    ASSERT_TRUE(pCache->isChunkCached(2));
+    EXPECT_FALSE(pCache->isChunkCached(3));
+    const CSAMPLE* pSamples = pCache->chunkSamples(2);
+    EXPECT_EQ(2.0f, pSamples[0]);
+    EXPECT_EQ(2.5f, pSamples[1]);
+    EXPECT_EQ(2.0f + 0.5f * (CachingReaderChunk::kFrames * kChannelCount - 1),
+            pSamples[CachingReaderChunk::kFrames * kChannelCount - 1]);
+}
+
+TEST_F(CachingReaderDiskCacheTest, resetOnMismatch) {
+    {
+        auto pCache = openCache(QStringLiteral("track"));
+        ASSERT_NE(nullptr, pCache);
+        fillChunk(pCache.get(), 0);
+    }
+
+    // A different length invalidates all chunks
+    auto pCache = openCache(QStringLiteral("track"),
+            mixxx::IndexRange::forward(0, 2 * CachingReaderChunk::kFrames));
+    ASSERT_NE(nullptr, pCache);
+    EXPECT_EQ(2, pCache->numChunks());
+    EXPECT_FALSE(pCache->isChunkCached(0));
+    EXPECT_FALSE(pCache->isChunkCached(1));
+}
+
+TEST_F(CachingReaderDiskCacheTest, replaceWhileMapped) {
+    auto pMappedCache = openCache(QStringLiteral("track"));
+    ASSERT_NE(nullptr, pMappedCache);
+    fillChunk(pMappedCache.get(), 1);
+
+    // Another deck opens the same file with a different length, which
+    // replaces the file instead of truncating the mapped one
+    auto pCache = openCache(QStringLiteral("track"),
+            mixxx::IndexRange::forward(0, 2 * CachingReaderChunk::kFrames));
+    ASSERT_NE(nullptr, pCache);
+    EXPECT_EQ(2, pCache->numChunks());
+    EXPECT_FALSE(pCache->isChunkCached(1));
+
+    ASSERT_TRUE(pMappedCache->isChunkCached(1));
+    EXPECT_EQ(1.0f, pMappedCache->chunkSamples(1)[0]);
+    EXPECT_EQ(1.5f, pMappedCache->chunkSamples(1)[1]);
+}
+
+TEST_F(CachingReaderDiskCacheTest, evictLeastRecentlyUsed) {
+    QString keepFilePath;
+    for (int i = 0; i < 3; ++i) {
+        auto pCache = openCache(QStringLiteral("track%1").arg(i));
+        ASSERT_NE(nullptr, pCache);
+        if (i == 0) {
+            keepFilePath = pCache->filePath();
+        }
+    }
+    const QDir cacheDir(m_tempDir.path());
+    ASSERT_EQ(3, cacheDir.entryList(QDir::Files).size());
+
+    // Everything fits
+    CachingReaderDiskCache::evictLeastRecentlyUsed(
+            m_tempDir.path(), std::numeric_limits<qint64>::max());
+    EXPECT_EQ(3, cacheDir.entryList(QDir::Files).size());
+
+    // Only the file that is in use is kept
+    CachingReaderDiskCache::evictLeastRecentlyUsed(m_tempDir.path(), 0, keepFilePath);
+    EXPECT_EQ(QStringList{QFileInfo(keepFilePath).fileName()},
+            cacheDir.entryList(QDir::Files));
+}
+
+} // namespace
@@ -0,0 +1,105 @@
+#include "control/controlchangeset.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlChangeSetTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_key1 = ConfigKey("[Channel1]", "co1");
+        m_key2 = ConfigKey("[Channel1]", "co2");
+        m_pControl1 = std::make_unique<ControlObject>(m_key1);
+        m_pControl2 = std::make_unique<ControlObject>(m_key2);
+    }
+
+    ConfigKey m_key1;
+    ConfigKey m_key2;
+    std::unique_ptr<ControlObject> m_pControl1;
+    std::unique_ptr<ControlObject> m_pControl2;
+    ControlChangeSet m_changeSet;
+};
+
+TEST_F(ControlChangeSetTest, ChangesAreCoalesced) {
+    QList<double> values;
+    m_changeSet.subscribe(m_key1, [&values](double value) {
+        values.append(value);
+    });
+
+    EXPECT_EQ(0, m_changeSet.drain());
+    m_pControl1->set(1.0);
+    m_pControl1->set(2.0);
+    m_pControl1->set(3.0);
+    EXPECT_EQ(1, m_changeSet.drain());
+    EXPECT_EQ(QList<double>({3.0}), values);
+    EXPECT_EQ(0, m_changeSet.drain());
+
+    // Ignored no-op changes
+    m_pControl1->set(3.0);
+    EXPECT_EQ(0, m_changeSet.drain());
+}
+
+TEST_F(ControlChangeSetTest, OwnChangesAreIgnored) {
+    ControlProxy proxy(m_key1);
+    QList<double> values;
+    m_changeSet.subscribe(
+            m_key1,
+            [&values](double value) {
+                values.append(value);
+            },
+            &proxy);
+
+    proxy.set(1.0);
+    EXPECT_EQ(0, m_changeSet.drain());
+    EXPECT_TRUE(values.isEmpty());
+
+    m_pControl1->set(2.0);
+    EXPECT_EQ(1, m_changeSet.drain());
+    EXPECT_EQ(QList<double>({2.0}), values);
+
+    // The receiver already knows the latest value it has set
+    m_pControl1->set(3.0);
+    proxy.set(4.0);
+    EXPECT_EQ(0, m_changeSet.drain());
+
+    proxy.set(5.0);
+    m_pControl1->set(6.0);
+    EXPECT_EQ(1, m_changeSet.drain());
+    EXPECT_EQ(QList<double>({2.0, 6.0}), values);
+}
+
+TEST_F(ControlChangeSetTest, MissingControl) {
+    EXPECT_EQ(-1,
+            m_changeSet.subscribe(ConfigKey("[Channel1]", "missing"), [](double) {}));
+    EXPECT_EQ(0, m_changeSet.size());
+}
+
+TEST_F(ControlChangeSetTest, UnsubscribeWhileDraining) {
+    int calls = 0;
+    int handle2 = -1;
+    m_changeSet.subscribe(m_key1, [&](double) {
+        ++calls;
+        m_changeSet.unsubscribe(handle2);
+    });
+    handle2 = m_changeSet.subscribe(m_key2, [&](double) {
+        ++calls;
+    });
+    EXPECT_EQ(2, m_changeSet.size());
+
+    m_pControl1->set(1.0);
+    m_pControl2->set(1.0);
+    EXPECT_EQ(1, m_changeSet.drain());
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(1, m_changeSet.size());
+
+    // The handle is reused
+    EXPECT_EQ(handle2, m_changeSet.subscribe(m_key2, [](double) {}));
+}
+
+} // namespace
@@ -4,6 +4,9 @@
 #include <memory>
 
 #include "control/controlobject.h"
+#include "control/controlprofiler.h"
+#include "control/controlproxy.h"
+#include "control/controlvaluearena.h"
 #include "test/mixxxtest.h"
 
 namespace {
@@ -86,4 +89,89 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+TEST_F(ControlObjectTest, Profiler) {
+    ControlProxy proxy(ck1);
+    co1->set(1.0);
+
+    ControlProfiler::setEnabled(true);
+    co1->set(2.0);
+    proxy.set(3.0);
+    proxy.set(4.0);
+    co2->set(1.0);
+    ControlProfiler::setEnabled(false);
+    co1->set(5.0);
+
+    const QList<ControlProfiler::Entry> entries = ControlProfiler::report();
+    ASSERT_EQ(2, entries.size());
+    EXPECT_EQ(ck1, entries[0].key);
+    EXPECT_EQ(3u, entries[0].setCount);
+    ASSERT_EQ(2, entries[0].senders.size());
+    EXPECT_EQ(QString("ControlProxy"), entries[0].senders[0].first);
+    EXPECT_EQ(2u, entries[0].senders[0].second);
+    EXPECT_EQ(QString("ControlObject"), entries[0].senders[1].first);
+    EXPECT_EQ(ck2, entries[1].key);
+    EXPECT_EQ(1u, entries[1].setCount);
+}
+
+TEST_F(ControlObjectTest, ProfilerDroppedSenders) {
+    // More sets than sender records fit into the buffer without draining it
+    constexpr int kSets = 1 << 15;
+    ControlObject co(ConfigKey("[Test3]", "dropped"));
+    ControlProfiler::setEnabled(true);
+    for (int i = 1; i <= kSets; ++i) {
+        co.set(i);
+    }
+    ControlProfiler::setEnabled(false);
+
+    const QList<ControlProfiler::Entry> entries = ControlProfiler::report();
+    ASSERT_EQ(1, entries.size());
+    EXPECT_EQ(static_cast<quint64>(kSets), entries[0].setCount);
+    EXPECT_GT(entries[0].droppedSenderCount, 0u);
+    ASSERT_EQ(1, entries[0].senders.size());
+    EXPECT_EQ(entries[0].setCount,
+            entries[0].senders[0].second + entries[0].droppedSenderCount);
+}
+
+TEST_F(ControlObjectTest, ValueArena) {
+    const ConfigKey ck3("[Test3]", "co3");
+    const ConfigKey ck4("[Test3]", "co4");
+    const ConfigKey ck5("[Test4]", "co5");
+
+    QSharedPointer<ControlValueArena> pArena;
+    {
+        const ControlValueArena::Scope scope(ck3.group);
+        auto co3 = std::make_unique<ControlObject>(ck3, false, false, false, 1.0);
+        auto co4 = std::make_unique<ControlObject>(ck4, false, false, false, 2.0);
+        // Controls of other groups are not allocated from the arena
+        auto co5 = std::make_unique<ControlObject>(ck5);
+
+        pArena = ControlValueArena::forKey(ck3);
+        ASSERT_TRUE(pArena);
+        EXPECT_FALSE(ControlValueArena::forKey(ck5));
+        EXPECT_EQ(2, pArena->size());
+
+        EXPECT_DOUBLE_EQ(1.0, co3->get());
+        EXPECT_DOUBLE_EQ(2.0, co4->get());
+
+        {
+            ControlProxy proxy(ck4);
+            proxy.set(3.0);
+            EXPECT_DOUBLE_EQ(3.0, co4->get());
+            EXPECT_DOUBLE_EQ(1.0, co3->get());
+        }
+
+        co4.reset();
+        EXPECT_EQ(1, pArena->size());
+
+        // Released slots are reused
+        co4 = std::make_unique<ControlObject>(ck4);
+        EXPECT_EQ(2, pArena->size());
+        EXPECT_DOUBLE_EQ(0.0, co4->get());
+    }
+    // Without a scope controls store their value inline
+    EXPECT_FALSE(ControlValueArena::forKey(ck3));
+    ControlObject co3(ck3);
+    EXPECT_EQ(0, pArena->size());
+}
+
 } // namespace
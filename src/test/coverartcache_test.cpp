@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
+#include "library/coverartthumbnailstore.h"
 #include "library/coverartutils.h"
 #include "library/trackcollection.h"
 #include "test/librarytest.h"
@@ -88,3 +93,118 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, thumbnailStoreMipmaps) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const CoverArtThumbnailStore store(tempDir.path());
+
+    QImage image(600, 600, QImage::Format_RGB32);
+    image.fill(Qt::darkRed);
+    const QByteArray imageDigest = CoverImageUtils::calculateDigest(image);
+    EXPECT_TRUE(store.loadImage(imageDigest, 100).isNull());
+
+    store.storeImage(imageDigest, image);
+    EXPECT_EQ(CoverArtThumbnailStore::kTableRowWidth,
+            store.loadImage(imageDigest, 100).width());
+    EXPECT_EQ(CoverArtThumbnailStore::kTableRowWidth,
+            store.loadImage(imageDigest, CoverArtThumbnailStore::kTableRowWidth)
+                    .width());
+    EXPECT_EQ(CoverArtThumbnailStore::kDeckWidth,
+            store.loadImage(imageDigest, 300).width());
+    // Full-size images are never stored
+    EXPECT_TRUE(store.loadImage(imageDigest, 0).isNull());
+    EXPECT_TRUE(store.loadImage(imageDigest, 600).isNull());
+
+    // Small images are stored unscaled as the smallest mipmap
+    QImage smallImage(64, 64, QImage::Format_RGB32);
+    smallImage.fill(Qt::darkBlue);
+    const QByteArray smallImageDigest = CoverImageUtils::calculateDigest(smallImage);
+    store.storeImage(smallImageDigest, smallImage);
+    EXPECT_EQ(smallImage.size(), store.loadImage(smallImageDigest, 50).size());
+    EXPECT_TRUE(store.loadImage(smallImageDigest, 300).isNull());
+}
+
+TEST_F(CoverArtCacheTest, thumbnailStoreEvictsLeastRecentlyUsed) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const auto storeSize = [&tempDir]() {
+        qint64 totalBytes = 0;
+        QDirIterator it(tempDir.path(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            totalBytes += it.fileInfo().size();
+        }
+        return totalBytes;
+    };
+    const auto createImage = [](int i) {
+        QImage image(600, 600, QImage::Format_RGB32);
+        image.fill(QColor(i * 30, 0, 0));
+        return image;
+    };
+
+    // Store the least recently used entry
+    const QImage firstImage = createImage(0);
+    const QByteArray firstImageDigest = CoverImageUtils::calculateDigest(firstImage);
+    CoverArtThumbnailStore(tempDir.path()).storeImage(firstImageDigest, firstImage);
+    QDirIterator entryIt(tempDir.path(), QDir::Files, QDirIterator::Subdirectories);
+    while (entryIt.hasNext()) {
+        QFile file(entryIt.next());
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        file.setFileTime(QDateTime::currentDateTimeUtc().addDays(-7),
+                QFileDevice::FileModificationTime);
+    }
+    const qint64 entrySize = storeSize();
+    ASSERT_GT(entrySize, 0);
+
+    // Limited to roughly the size of two entries
+    const qint64 maxBytes = 2 * entrySize;
+    const CoverArtThumbnailStore store(tempDir.path(), maxBytes);
+    for (int i = 1; i < 8; ++i) {
+        const QImage image = createImage(i);
+        store.storeImage(CoverImageUtils::calculateDigest(image), image);
+    }
+    store.evictLeastRecentlyUsed();
+
+    EXPECT_LE(storeSize(), maxBytes);
+    EXPECT_TRUE(store.loadImage(firstImageDigest, 100).isNull());
+}
+
+TEST_F(CoverArtCacheTest, loadCoverFromThumbnailStore) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const auto pStore = std::make_shared<const CoverArtThumbnailStore>(
+            tempDir.path());
+
+    const QString trackLocation = getTestDir().filePath(kTrackLocationTest);
+    QImage img;
+    SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(trackLocation)),
+            nullptr,
+            &img,
+            false);
+    ASSERT_FALSE(img.isNull());
+
+    CoverInfo info;
+    info.type = CoverInfo::METADATA;
+    info.source = CoverInfo::GUESSED;
+    info.trackLocation = trackLocation;
+    info.setImageDigest(img);
+
+    // The first request decodes the embedded image and fills the store
+    CoverArtCache::FutureResult res =
+            CoverArtCache::loadCover(TrackPointer(), info, 0, pStore);
+    EXPECT_EQ(img, res.coverArt.loadedImage.image);
+    EXPECT_QSTRING_EQ(trackLocation, res.coverArt.loadedImage.location);
+
+    // Full-size requests are never served from the store
+    res = CoverArtCache::loadCover(TrackPointer(), info, 0, pStore);
+    EXPECT_EQ(img, res.coverArt.loadedImage.image);
+    EXPECT_QSTRING_EQ(trackLocation, res.coverArt.loadedImage.location);
+
+    // Thumbnail requests are served from the store
+    res = CoverArtCache::loadCover(TrackPointer(), info, 50, pStore);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+    EXPECT_EQ(50, res.coverArt.loadedImage.image.width());
+    EXPECT_TRUE(res.coverArt.loadedImage.location.startsWith(tempDir.path()));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "effects/backends/effectprocessor.h"
+#include "util/defs.h"
+
+namespace {
+
+const mixxx::EngineParameters kEngineParameters(
+        mixxx::audio::SampleRate(96000), kMaxEngineFrames);
+
+class ReusableState : public EffectState {
+  public:
+    ReusableState(const mixxx::EngineParameters& engineParameters)
+            : EffectState(engineParameters),
+              counter(0) {
+    }
+
+    bool resetForReuse() override {
+        counter = 0;
+        return true;
+    }
+
+    int counter;
+};
+
+class DisposableState : public EffectState {
+  public:
+    DisposableState(const mixxx::EngineParameters& engineParameters)
+            : EffectState(engineParameters) {
+    }
+};
+
+class EffectStatePoolTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        EffectStatePool<ReusableState>::instance().clear();
+        EffectStatePool<DisposableState>::instance().clear();
+    }
+};
+
+TEST_F(EffectStatePoolTest, ReuseResetState) {
+    auto& pool = EffectStatePool<ReusableState>::instance();
+    auto pState = std::make_unique<ReusableState>(kEngineParameters);
+    pState->counter = 42;
+    const ReusableState* pReleasedState = pState.get();
+    pool.release(std::move(pState), kEngineParameters);
+    EXPECT_EQ(1u, pool.size());
+
+    const auto pReusedState = pool.acquire(kEngineParameters);
+    EXPECT_EQ(pReleasedState, pReusedState.get());
+    EXPECT_EQ(0, pReusedState->counter);
+    EXPECT_EQ(0u, pool.size());
+    EXPECT_EQ(nullptr, pool.acquire(kEngineParameters));
+}
+
+TEST_F(EffectStatePoolTest, OnlyReuseStatesWithSameParameters) {
+    auto& pool = EffectStatePool<ReusableState>::instance();
+    pool.release(std::make_unique<ReusableState>(kEngineParameters), kEngineParameters);
+
+    const mixxx::EngineParameters otherEngineParameters(
+            mixxx::audio::SampleRate(44100), kMaxEngineFrames);
+    EXPECT_EQ(nullptr, pool.acquire(otherEngineParameters));
+    EXPECT_NE(nullptr, pool.acquire(kEngineParameters));
+}
+
+TEST_F(EffectStatePoolTest, DeleteStatesThatCannotBeReused) {
+    auto& pool = EffectStatePool<DisposableState>::instance();
+    pool.release(std::make_unique<DisposableState>(kEngineParameters), kEngineParameters);
+    EXPECT_EQ(0u, pool.size());
+    EXPECT_EQ(nullptr, pool.acquire(kEngineParameters));
+}
+
+TEST_F(EffectStatePoolTest, LimitNumberOfStates) {
+    auto& pool = EffectStatePool<ReusableState>::instance();
+    for (std::size_t i = 0; i <= EffectStatePool<ReusableState>::kMaxStates; ++i) {
+        pool.release(std::make_unique<ReusableState>(kEngineParameters), kEngineParameters);
+    }
+    EXPECT_EQ(EffectStatePool<ReusableState>::kMaxStates, pool.size());
+}
+
+} // namespace
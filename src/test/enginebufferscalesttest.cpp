@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+#include "engine/bufferscalers/enginebufferscalest.h"
+#include "engine/bufferscalers/soundtouchworkerpool.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kBufferFrames = 1024;
+
+// Provides the same stereo signal for each stereo pair of channels
+class ReadAheadManagerFake : public ReadAheadManager {
+  public:
+    ReadAheadManagerFake()
+            : ReadAheadManager(),
+              m_framesRead(0) {
+    }
+
+    SINT getNextSamples(double dRate,
+            CSAMPLE* buffer,
+            SINT requested_samples,
+            mixxx::audio::ChannelCount channelCount) override {
+        Q_UNUSED(dRate);
+        const SINT frames = requested_samples / channelCount;
+        for (SINT f = 0; f < frames; ++f) {
+            const double t = static_cast<double>(m_framesRead + f) / kSampleRate;
+            for (int ch = 0; ch < channelCount; ++ch) {
+                const double frequency = ch % 2 == 0 ? 440.0 : 660.0;
+                buffer[f * channelCount + ch] =
+                        static_cast<CSAMPLE>(0.5 * std::sin(2 * M_PI * frequency * t));
+            }
+        }
+        m_framesRead += frames;
+        return frames * channelCount;
+    }
+
+  private:
+    SINT m_framesRead;
+};
+
+class EngineBufferScaleSTTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        SoundTouchWorkerPool::createInstance();
+    }
+
+    void TearDown() override {
+        SoundTouchWorkerPool::destroy();
+    }
+};
+
+TEST_F(EngineBufferScaleSTTest, StemWorkersMatchStereoScaler) {
+    if (SoundTouchWorkerPool::instance()->channelPerWorker(
+                mixxx::audio::ChannelCount::stem()) !=
+            mixxx::audio::ChannelCount::stereo()) {
+        GTEST_SKIP() << "Not enough threads to process the stems in parallel";
+    }
+
+    ReadAheadManagerFake stereoReadAheadManager;
+    EngineBufferScaleST stereoScaler(&stereoReadAheadManager);
+    stereoScaler.setSignal(kSampleRate, mixxx::audio::ChannelCount::stereo());
+
+    ReadAheadManagerFake stemReadAheadManager;
+    EngineBufferScaleST stemScaler(&stemReadAheadManager);
+    stemScaler.setSignal(kSampleRate, mixxx::audio::ChannelCount::stem());
+
+    for (auto* pScaler : {&stereoScaler, &stemScaler}) {
+        double tempoRatio = 1.2;
+        double pitchRatio = 0.9;
+        pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    }
+
+    const int stemChannels = mixxx::audio::ChannelCount::stem();
+    mixxx::SampleBuffer stereoOutput(kBufferFrames * 2);
+    mixxx::SampleBuffer stemOutput(kBufferFrames * stemChannels);
+    for (int i = 0; i < 20; ++i) {
+        const double stereoFramesRead =
+                stereoScaler.scaleBuffer(stereoOutput.data(), stereoOutput.size());
+        const double stemFramesRead =
+                stemScaler.scaleBuffer(stemOutput.data(), stemOutput.size());
+        EXPECT_DOUBLE_EQ(stereoFramesRead, stemFramesRead);
+        for (SINT f = 0; f < kBufferFrames; ++f) {
+            for (int ch = 0; ch < stemChannels; ++ch) {
+                ASSERT_FLOAT_EQ(stereoOutput[f * 2 + ch % 2],
+                        stemOutput[f * stemChannels + ch])
+                        << "frame " << f << " channel " << ch;
+            }
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,290 @@
+#include "engine/effects/engineeffectsmanager.h"
+
+#include <gtest/gtest.h>
+
+#include <QSet>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/effectsbackendmanager.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "test/mixxxtest.h"
+#include "util/defs.h"
+#include "util/messagepipe.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kNumChannels = 4;
+constexpr int kNumChains = 3;
+constexpr unsigned int kNumSamples = 1024;
+const mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+class EngineEffectsManagerTest : public MixxxTest {
+  protected:
+    EngineEffectsManagerTest()
+            : m_outputHandle(m_factory.getOrCreateHandle(QStringLiteral("[Master]"))),
+              m_pBackendManager(new EffectsBackendManager()) {
+        for (int i = 0; i < kNumChannels; ++i) {
+            const QString group = QStringLiteral("[Channel%1]").arg(i + 1);
+            m_inputHandles.push_back(m_factory.getOrCreateHandle(group));
+            m_inputChannels.insert(ChannelHandleAndGroup(m_inputHandles.back(), group));
+            m_buffers.emplace_back(kMaxEngineSamples);
+        }
+        m_outputChannels = {
+                ChannelHandleAndGroup(m_outputHandle, QStringLiteral("[Master]"))};
+        createEngine();
+    }
+
+    // (Re-)creates the manager with empty chains in their initial state
+    void createEngine() {
+        m_pManager.reset();
+        m_effects.clear();
+        m_chains.clear();
+        m_requests.clear();
+
+        auto pipes = TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::
+                makeTwoWayMessagePipe(64, 64);
+        m_pRequestPipe = std::move(pipes.first);
+        m_pManager = std::make_unique<EngineEffectsManager>(std::move(pipes.second));
+
+        for (int i = 0; i < kNumChains; ++i) {
+            m_chains.push_back(std::make_unique<EngineEffectChain>(
+                    QStringLiteral("[EffectRack1_EffectUnit%1]").arg(i + 1),
+                    m_inputChannels,
+                    m_outputChannels));
+            auto pRequest = std::make_unique<EffectsRequest>();
+            pRequest->type = EffectsRequest::ADD_EFFECT_CHAIN;
+            pRequest->AddEffectChain.pChain = m_chains.back().get();
+            pRequest->AddEffectChain.signalProcessingStage =
+                    SignalProcessingStage::Postfader;
+            sendRequest(std::move(pRequest));
+
+            // Fully wet, otherwise the effects would not be audible
+            auto pParametersRequest = std::make_unique<EffectsRequest>();
+            pParametersRequest->type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+            pParametersRequest->pTargetChain = m_chains.back().get();
+            pParametersRequest->SetEffectChainParameters.enabled = true;
+            pParametersRequest->SetEffectChainParameters.mix_mode =
+                    EffectChainMixMode::DrySlashWet;
+            pParametersRequest->SetEffectChainParameters.mix = 1.0;
+            sendRequest(std::move(pParametersRequest));
+        }
+        // Each chain is enabled for some of the channels
+        for (int i = 0; i < kNumChannels; ++i) {
+            for (int k = 0; k < kNumChains; ++k) {
+                if ((i + k) % 2 == 0) {
+                    continue;
+                }
+                auto pRequest = std::make_unique<EffectsRequest>();
+                pRequest->type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+                pRequest->pTargetChain = m_chains[k].get();
+                pRequest->EnableInputChannelForChain.channelHandle = m_inputHandles[i];
+                sendRequest(std::move(pRequest));
+            }
+        }
+        m_pManager->onCallbackStart();
+    }
+
+    void sendRequest(std::unique_ptr<EffectsRequest> pRequest) {
+        m_pRequestPipe->writeMessage(pRequest.get());
+        m_requests.push_back(std::move(pRequest));
+    }
+
+    // Loads an enabled effect into a slot of a chain. The requests are
+    // processed by the next onCallbackStart().
+    EngineEffect* addEffect(int chainIndex, int effectIndex, const QString& effectId) {
+        const EffectManifestPointer pManifest =
+                m_pBackendManager->getManifest(effectId, EffectBackendType::BuiltIn);
+        EXPECT_TRUE(pManifest);
+        m_effects.push_back(std::make_unique<EngineEffect>(pManifest,
+                m_pBackendManager,
+                m_inputChannels,
+                m_inputChannels,
+                m_outputChannels));
+        EngineEffect* pEffect = m_effects.back().get();
+
+        auto pAddRequest = std::make_unique<EffectsRequest>();
+        pAddRequest->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+        pAddRequest->pTargetChain = m_chains[chainIndex].get();
+        pAddRequest->AddEffectToChain.pEffect = pEffect;
+        pAddRequest->AddEffectToChain.iIndex = effectIndex;
+        sendRequest(std::move(pAddRequest));
+
+        auto pEnableRequest = std::make_unique<EffectsRequest>();
+        pEnableRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        pEnableRequest->pTargetEffect = pEffect;
+        pEnableRequest->SetEffectParameters.enabled = true;
+        sendRequest(std::move(pEnableRequest));
+        return pEffect;
+    }
+
+    // Fills the channel buffers, processes them and returns the mix
+    mixxx::SampleBuffer processChannels(bool inPlace) {
+        std::vector<EngineEffectsManager::PostFaderChannel> channels;
+        for (int i = 0; i < kNumChannels; ++i) {
+            SampleUtil::fill(m_buffers[i].data(), 0.1f * (i + 1), kNumSamples);
+            channels.push_back({m_inputHandles[i],
+                    m_buffers[i].data(),
+                    &m_features,
+                    CSAMPLE_GAIN_ONE,
+                    0.5f * (i + 1),
+                    false});
+        }
+        mixxx::SampleBuffer output(kNumSamples);
+        output.clear();
+        m_pManager->onCallbackStart();
+        m_pManager->processPostFaderAndMixChannels(channels.data(),
+                kNumChannels,
+                m_outputHandle,
+                output.data(),
+                kNumSamples,
+                kSampleRate,
+                inPlace);
+        return output;
+    }
+
+    ChannelHandleFactory m_factory;
+    const ChannelHandle m_outputHandle;
+    std::vector<ChannelHandle> m_inputHandles;
+    QSet<ChannelHandleAndGroup> m_inputChannels;
+    QSet<ChannelHandleAndGroup> m_outputChannels;
+    std::vector<mixxx::SampleBuffer> m_buffers;
+    GroupFeatureState m_features;
+
+    EffectsBackendManagerPointer m_pBackendManager;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    std::vector<std::unique_ptr<EffectsRequest>> m_requests;
+    std::vector<std::unique_ptr<EngineEffectChain>> m_chains;
+    std::vector<std::unique_ptr<EngineEffect>> m_effects;
+    std::unique_ptr<EngineEffectsManager> m_pManager;
+};
+
+TEST_F(EngineEffectsManagerTest, ConcurrentChannelsMatchSerialProcessing) {
+    // Longer than the default delay of the echo
+    constexpr int kNumCallbacks = 100;
+    config()->setValue(ConfigKey("[App]", "engine_multithreading"), true);
+    RealtimeWorkerPool pool(config());
+
+    // The echo keeps a state per channel and each chain is shared by
+    // several channels
+    const auto processScenario = [this](bool inPlace, RealtimeWorkerPool* pPool) {
+        createEngine();
+        for (int k = 0; k < kNumChains; ++k) {
+            addEffect(k, 0, QStringLiteral("org.mixxx.effects.echo"));
+        }
+        m_pManager->setRealtimeWorkerPool(pPool);
+        std::vector<mixxx::SampleBuffer> outputs;
+        for (int i = 0; i < kNumCallbacks; ++i) {
+            outputs.push_back(processChannels(inPlace));
+        }
+        m_pManager->setRealtimeWorkerPool(nullptr);
+        return outputs;
+    };
+
+    for (const bool inPlace : {false, true}) {
+        const std::vector<mixxx::SampleBuffer> serialOutputs =
+                processScenario(inPlace, nullptr);
+        // Repeat to catch ordering issues between the workers
+        for (int repetition = 0; repetition < 5; ++repetition) {
+            const std::vector<mixxx::SampleBuffer> concurrentOutputs =
+                    processScenario(inPlace, &pool);
+            for (int i = 0; i < kNumCallbacks; ++i) {
+                for (unsigned int s = 0; s < kNumSamples; ++s) {
+                    ASSERT_FLOAT_EQ(serialOutputs[i][s], concurrentOutputs[i][s])
+                            << "callback " << i << " sample " << s;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(EngineEffectsManagerTest, GovernorBypassesCostliestEffectPerCallback) {
+    EngineEffect* pEffect1 = addEffect(0, 0, QStringLiteral("org.mixxx.effects.echo"));
+    EngineEffect* pEffect2 = addEffect(1, 0, QStringLiteral("org.mixxx.effects.echo"));
+    EngineEffect* pEffect3 = addEffect(2, 0, QStringLiteral("org.mixxx.effects.echo"));
+    m_pManager->onCallbackStart();
+    m_pManager->setCpuBudget(0.5);
+
+    pEffect1->setCpuUsageForTest(0.3);
+    pEffect2->setCpuUsageForTest(0.4);
+    pEffect3->setCpuUsageForTest(0.25);
+    m_pManager->onCallbackStart();
+    EXPECT_FALSE(pEffect1->isBypassedByGovernor());
+    EXPECT_TRUE(pEffect2->isBypassedByGovernor());
+    EXPECT_FALSE(pEffect3->isBypassedByGovernor());
+
+    // Still over budget without the bypassed effect
+    pEffect1->setCpuUsageForTest(0.3);
+    pEffect3->setCpuUsageForTest(0.25);
+    m_pManager->onCallbackStart();
+    EXPECT_TRUE(pEffect1->isBypassedByGovernor());
+    EXPECT_TRUE(pEffect2->isBypassedByGovernor());
+    EXPECT_FALSE(pEffect3->isBypassedByGovernor());
+
+    // Within budget
+    pEffect3->setCpuUsageForTest(0.25);
+    m_pManager->onCallbackStart();
+    EXPECT_TRUE(pEffect1->isBypassedByGovernor());
+    EXPECT_TRUE(pEffect2->isBypassedByGovernor());
+    EXPECT_FALSE(pEffect3->isBypassedByGovernor());
+}
+
+TEST_F(EngineEffectsManagerTest, GovernorResumesBelowHysteresis) {
+    EngineEffect* pEffect1 = addEffect(0, 0, QStringLiteral("org.mixxx.effects.echo"));
+    EngineEffect* pEffect2 = addEffect(0, 1, QStringLiteral("org.mixxx.effects.echo"));
+    m_pManager->onCallbackStart();
+    m_pManager->setCpuBudget(1.0);
+
+    pEffect1->setCpuUsageForTest(0.5);
+    pEffect2->setCpuUsageForTest(0.6);
+    m_pManager->onCallbackStart();
+    ASSERT_TRUE(pEffect2->isBypassedByGovernor());
+
+    // Resuming the effect would exceed 80% of the budget
+    pEffect1->setCpuUsageForTest(0.3);
+    m_pManager->onCallbackStart();
+    EXPECT_FALSE(pEffect1->isBypassedByGovernor());
+    EXPECT_TRUE(pEffect2->isBypassedByGovernor());
+
+    pEffect1->setCpuUsageForTest(0.1);
+    m_pManager->onCallbackStart();
+    EXPECT_FALSE(pEffect1->isBypassedByGovernor());
+    EXPECT_FALSE(pEffect2->isBypassedByGovernor());
+}
+
+TEST_F(EngineEffectsManagerTest, GovernorFadesOutWithinOneCallback) {
+    EngineEffect* pEffect = addEffect(0, 0, QStringLiteral("org.mixxx.effects.echo"));
+    m_pManager->onCallbackStart();
+    m_pManager->setCpuBudget(0.5);
+
+    mixxx::SampleBuffer input(kNumSamples);
+    mixxx::SampleBuffer output(kNumSamples);
+    SampleUtil::fill(input.data(), 0.1f, kNumSamples);
+    const auto process = [&] {
+        return pEffect->process(m_inputHandles[0],
+                m_outputHandle,
+                input.data(),
+                output.data(),
+                kNumSamples,
+                kSampleRate,
+                EffectEnableState::Enabled,
+                m_features);
+    };
+    EXPECT_TRUE(process());
+
+    pEffect->setCpuUsageForTest(0.9);
+    m_pManager->onCallbackStart();
+    ASSERT_TRUE(pEffect->isBypassedByGovernor());
+    // The effect is still processed once for fading out
+    EXPECT_TRUE(process());
+
+    m_pManager->onCallbackStart();
+    EXPECT_TRUE(pEffect->isBypassedByGovernor());
+    EXPECT_FALSE(process());
+}
+
+} // namespace
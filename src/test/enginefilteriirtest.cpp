@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <type_traits>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbutterworth4.h"
+#include "engine/filters/enginefilterbutterworth8.h"
+#include "engine/filters/enginefilterlinkwitzriley4.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr int kBufferSize = 1024;
+// The largest state of all EngineFilterIIR specializations
+constexpr int kMaxFilterStateSize = 16;
+
+template<typename Filter>
+std::unique_ptr<Filter> createFilter() {
+    if constexpr (std::is_constructible_v<Filter, mixxx::audio::SampleRate, double, double>) {
+        return std::make_unique<Filter>(kSampleRate, 300, 3000);
+    } else {
+        return std::make_unique<Filter>(kSampleRate, 600);
+    }
+}
+
+// Exposes the per channel processing of a single double
+template<typename Filter>
+class ReferenceFilter : public Filter {
+  public:
+    using Filter::Filter;
+
+    // Processes each channel on its own as before the introduction of
+    // IIRStereoSample. Only valid for a settled filter.
+    void processReference(const CSAMPLE* pIn, CSAMPLE* pOutput, int iBufferSize) {
+        for (int i = 0; i < iBufferSize; i += 2) {
+            pOutput[i] = static_cast<CSAMPLE>(
+                    this->processSample(this->m_coef, m_left, static_cast<double>(pIn[i])));
+            pOutput[i + 1] = static_cast<CSAMPLE>(
+                    this->processSample(this->m_coef, m_right, static_cast<double>(pIn[i + 1])));
+        }
+    }
+
+  private:
+    double m_left[kMaxFilterStateSize] = {};
+    double m_right[kMaxFilterStateSize] = {};
+};
+
+void fillNoise(mixxx::SampleBuffer* pBuffer) {
+    // Deterministic pseudo random signal with distinct channels
+    unsigned int state = 1;
+    for (SINT i = 0; i < pBuffer->size(); ++i) {
+        state = state * 1664525 + 1013904223;
+        (*pBuffer)[i] = static_cast<CSAMPLE>(state >> 8) / (1 << 24) - 0.5f;
+    }
+}
+
+template<typename Filter>
+class EngineFilterIIRTest : public testing::Test {
+};
+
+using FilterTypes = testing::Types<
+        EngineFilterBessel4Low,
+        EngineFilterBessel4Band,
+        EngineFilterBessel4High,
+        EngineFilterBessel8Low,
+        EngineFilterBessel8Band,
+        EngineFilterBessel8High,
+        EngineFilterButterworth4Low,
+        EngineFilterButterworth4Band,
+        EngineFilterButterworth4High,
+        EngineFilterButterworth8Low,
+        EngineFilterButterworth8Band,
+        EngineFilterButterworth8High,
+        EngineFilterLinkwitzRiley4Low,
+        EngineFilterLinkwitzRiley4High,
+        EngineFilterLinkwitzRiley8Low,
+        EngineFilterLinkwitzRiley8High>;
+TYPED_TEST_SUITE(EngineFilterIIRTest, FilterTypes);
+
+TYPED_TEST(EngineFilterIIRTest, StereoMatchesSeparateChannels) {
+    auto pFilter = createFilter<ReferenceFilter<TypeParam>>();
+    pFilter->assumeSettled();
+
+    mixxx::SampleBuffer input(kBufferSize);
+    fillNoise(&input);
+    mixxx::SampleBuffer output(kBufferSize);
+    mixxx::SampleBuffer expected(kBufferSize);
+    for (int i = 0; i < 10; ++i) {
+        pFilter->process(input.data(), output.data(), kBufferSize);
+        pFilter->processReference(input.data(), expected.data(), kBufferSize);
+        for (int s = 0; s < kBufferSize; ++s) {
+            ASSERT_FLOAT_EQ(expected[s], output[s]) << s;
+        }
+    }
+}
+
+template<typename Filter>
+void BM_EngineFilterIIRProcess(benchmark::State& state) {
+    auto pFilter = createFilter<Filter>();
+    pFilter->assumeSettled();
+
+    mixxx::SampleBuffer input(kBufferSize);
+    fillNoise(&input);
+    mixxx::SampleBuffer output(kBufferSize);
+    for (auto _ : state) {
+        pFilter->process(input.data(), output.data(), kBufferSize);
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterBessel4Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterBessel8Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterButterworth4Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterButterworth8Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterLinkwitzRiley4Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterLinkwitzRiley8Low);
+
+} // namespace
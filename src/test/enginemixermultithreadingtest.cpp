@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "engine/bufferscalers/enginebufferscale.h"
+#include "engine/sync/enginesync.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+const ConfigKey kEngineMultiThreadingConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("engine_multithreading"));
+
+constexpr int kNumBuffers = 60;
+
+// Renders a sine wave, advanced by the tempo ratio. Unlike MockScaler it
+// produces audio, so a deck that renders with the wrong tempo or at the wrong
+// time is visible in the main output. Seeks restart the wave.
+class SineScaler : public EngineBufferScale {
+  public:
+    SineScaler()
+            : EngineBufferScale(),
+              m_phase(0) {
+    }
+
+    void clear() override {
+        m_phase = 0;
+    }
+
+    double scaleBuffer(CSAMPLE* pOutput, SINT buf_size) override {
+        DEBUG_ASSERT((buf_size % 2) == 0); // 2 channels
+        const SINT numFrames = buf_size / 2;
+        for (SINT i = 0; i < numFrames; ++i) {
+            const auto value = static_cast<CSAMPLE>(0.5 * std::sin(m_phase));
+            pOutput[2 * i] = value;
+            pOutput[2 * i + 1] = value;
+            m_phase += 0.01 * m_dTempoRatio;
+        }
+        return numFrames * m_dTempoRatio;
+    }
+
+  private:
+    void onSignalChanged() override {
+    }
+
+    double m_phase;
+};
+
+struct ScenarioResult {
+    std::vector<CSAMPLE> mainOutput;
+    std::vector<double> deckState;
+};
+
+class EngineMixerMultiThreadingTest : public BaseSignalPathTest {
+  protected:
+    // Plays three decks, two of them following the explicit leader, and
+    // changes the sync state and seeks while playing.
+    ScenarioResult runSyncScenario() {
+        m_scalers.clear();
+        const std::vector<QString> groups = {m_sGroup1, m_sGroup2, m_sGroup3};
+        const std::vector<Deck*> decks = {m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3};
+        const std::vector<double> bpms = {120.0, 128.0, 140.0};
+        for (std::size_t i = 0; i < decks.size(); ++i) {
+            m_scalers.push_back(std::make_unique<SineScaler>());
+            m_scalers.push_back(std::make_unique<SineScaler>());
+            decks[i]->getEngineDeck()->getEngineBuffer()->setScalerForTest(
+                    m_scalers[m_scalers.size() - 2].get(),
+                    m_scalers[m_scalers.size() - 1].get());
+            decks[i]->loadFakeTrack(false, bpms[i]);
+        }
+
+        ControlProxy syncMode1(m_sGroup1, "sync_mode");
+        ControlProxy syncMode2(m_sGroup2, "sync_mode");
+        syncMode1.set(static_cast<double>(SyncMode::LeaderExplicit));
+        syncMode2.set(static_cast<double>(SyncMode::Follower));
+        ControlObject::set(ConfigKey(m_sGroup1, "rate"), getRateSliderValue(1.2));
+        ControlObject::set(ConfigKey(m_sGroup3, "rate"), getRateSliderValue(0.9));
+        for (const auto& group : groups) {
+            ControlObject::set(ConfigKey(group, "play"), 1.0);
+        }
+
+        ScenarioResult result;
+        for (int i = 0; i < kNumBuffers; ++i) {
+            if (i == 10) {
+                ControlObject::set(ConfigKey(m_sGroup2, "playposition"), 0.5);
+            } else if (i == 20) {
+                ControlObject::set(ConfigKey(m_sGroup3, "sync_enabled"), 1.0);
+            } else if (i == 30) {
+                ControlObject::set(ConfigKey(m_sGroup1, "rate"), getRateSliderValue(1.1));
+            } else if (i == 40) {
+                ControlObject::set(ConfigKey(m_sGroup3, "playposition"), 0.25);
+                ControlObject::set(ConfigKey(m_sGroup1, "playposition"), 0.75);
+            }
+            ProcessBuffer();
+
+            const CSAMPLE* pMain = m_pEngineMixer->getMainBuffer();
+            result.mainOutput.insert(result.mainOutput.end(), pMain, pMain + kProcessBufferSize);
+            for (const auto& group : groups) {
+                result.deckState.push_back(ControlObject::get(ConfigKey(group, "playposition")));
+                result.deckState.push_back(ControlObject::get(ConfigKey(group, "bpm")));
+                result.deckState.push_back(ControlObject::get(ConfigKey(group, "beat_distance")));
+            }
+        }
+        return result;
+    }
+
+    // Not owned by the EngineBuffers
+    std::vector<std::unique_ptr<SineScaler>> m_scalers;
+};
+
+TEST_F(EngineMixerMultiThreadingTest, SyncedDecksMatchSerialProcessing) {
+    const ScenarioResult serial = runSyncScenario();
+
+    destroyEngine();
+    config()->setValue(kEngineMultiThreadingConfigKey, true);
+    createEngine();
+    const ScenarioResult concurrent = runSyncScenario();
+
+    ASSERT_EQ(serial.mainOutput.size(), concurrent.mainOutput.size());
+    for (std::size_t i = 0; i < serial.mainOutput.size(); ++i) {
+        ASSERT_FLOAT_EQ(serial.mainOutput[i], concurrent.mainOutput[i]) << "sample " << i;
+    }
+    ASSERT_EQ(serial.deckState.size(), concurrent.deckState.size());
+    for (std::size_t i = 0; i < serial.deckState.size(); ++i) {
+        ASSERT_DOUBLE_EQ(serial.deckState[i], concurrent.deckState[i]) << "value " << i;
+    }
+}
+
+} // namespace
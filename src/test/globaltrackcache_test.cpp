@@ -3,6 +3,7 @@
 #include <QThread>
 #include <QtDebug>
 #include <atomic>
+#include <thread>
 
 #include "test/mixxxtest.h"
 #include "track/track.h"
@@ -229,3 +230,58 @@ TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
 
     EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
 }
+
+TEST_F(GlobalTrackCacheTest, resolveWhileLookupIsLocked) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    TrackPointer track;
+    std::atomic<bool> resolved(false);
+    {
+        // Only the shard of this id is locked
+        GlobalTrackCacheLocker cacheLocker(TrackId(QVariant(1)));
+
+        // Resolving a track without an id only requires the shard
+        // of its canonical location and must not be blocked
+        auto testFileAccess = mixxx::FileAccess(
+                mixxx::FileInfo(getTestDir().filePath(kTestFile)));
+        std::thread resolverThread([&] {
+            track = GlobalTrackCacheResolver(testFileAccess).getTrack();
+            resolved.store(true);
+        });
+        for (int i = 0; i < 1000 && !resolved.load(); ++i) {
+            QThread::msleep(10);
+        }
+        EXPECT_TRUE(resolved.load());
+
+        cacheLocker.unlockCache();
+        resolverThread.join();
+    }
+    EXPECT_TRUE(static_cast<bool>(track));
+
+    track.reset();
+    while (!GlobalTrackCacheLocker().isEmpty()) {
+        QCoreApplication::processEvents();
+    }
+}
+
+TEST_F(GlobalTrackCacheTest, evictWhileShardIsLocked) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    TrackPointer track = GlobalTrackCacheResolver(
+            mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile))))
+                                 .getTrack();
+    ASSERT_TRUE(static_cast<bool>(track));
+
+    {
+        // Evicting requires all shards. Locking them while holding only
+        // this one would violate the lock order, so the eviction of the
+        // released track must be deferred.
+        GlobalTrackCacheLocker cacheLocker(TrackId(QVariant(1)));
+        track.reset();
+    }
+    EXPECT_FALSE(GlobalTrackCacheLocker().isEmpty());
+
+    while (!GlobalTrackCacheLocker().isEmpty()) {
+        QCoreApplication::processEvents();
+    }
+}
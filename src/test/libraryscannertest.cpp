@@ -1,9 +1,67 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <benchmark/benchmark.h>
+
+#include <QAtomicInt>
+#include <QTemporaryDir>
+#include <QThreadPool>
 
 #include "test/librarytest.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "library/coverartutils.h"
+#include "library/scanner/importfilestask.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/globaltrackcache.h"
+#include "track/track.h"
+
+namespace {
+
+// A small file with tags to keep the synthetic library compact
+const QString kTemplateFile = QStringLiteral("id3-test-data/artist.mp3");
+
+constexpr int kFilesPerDirectory = 100;
+
+void deleteTrack(Track* pTrack) {
+    // Delete track objects directly without an event loop
+    delete pTrack;
+}
+
+class ImportFilesBenchmarkScope : public virtual GlobalTrackCacheSaver,
+                                  SoundSourceProviderRegistration {
+  public:
+    ImportFilesBenchmarkScope() {
+        GlobalTrackCache::createInstance(this, deleteTrack);
+    }
+    ~ImportFilesBenchmarkScope() override {
+        GlobalTrackCache::destroyInstance();
+    }
+
+    void saveEvictedTrack(Track* pTrack) noexcept override {
+        Q_UNUSED(pTrack);
+    }
+};
+
+/// Creates a library of fileCount copies of the template file
+/// with kFilesPerDirectory files in each directory.
+std::vector<std::list<QFileInfo>> createSyntheticLibrary(
+        const QDir& rootDir, const QString& templateFile, int fileCount) {
+    std::vector<std::list<QFileInfo>> directories;
+    for (int i = 0; i < fileCount; ++i) {
+        if (i % kFilesPerDirectory == 0) {
+            const QString dirName = QStringLiteral("dir%1").arg(i / kFilesPerDirectory);
+            rootDir.mkdir(dirName);
+            directories.emplace_back();
+        }
+        const QDir dir(rootDir.filePath(QStringLiteral("dir%1").arg(i / kFilesPerDirectory)));
+        const QString filePath = dir.filePath(QStringLiteral("track%1.mp3").arg(i));
+        QFile::copy(templateFile, filePath);
+        directories.back().push_back(QFileInfo(filePath));
+    }
+    return directories;
+}
+
+} // anonymous namespace
 
 class LibraryScannerTest : public LibraryTest {
   protected:
@@ -52,3 +110,132 @@ TEST_F(LibraryScannerTest, ScannerRoundtrip) {
     m_libraryScanner.changeScannerState(LibraryScanner::IDLE);
     EXPECT_EQ(m_libraryScanner.m_state, LibraryScanner::IDLE);
 }
+
+TEST_F(LibraryScannerTest, IncrementalScanSkipsUnmodifiedDirectories) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QDir rootDir(tempDir.path());
+    ASSERT_TRUE(rootDir.mkpath(QStringLiteral("artist/album1")));
+    ASSERT_TRUE(rootDir.mkpath(QStringLiteral("artist/album2")));
+    const QString artistDir = rootDir.filePath(QStringLiteral("artist"));
+    const QString album1Dir = rootDir.filePath(QStringLiteral("artist/album1"));
+    const QString album2Dir = rootDir.filePath(QStringLiteral("artist/album2"));
+
+    // Only directories that contain tracks have a hash
+    QHash<QString, mixxx::cache_key_t> directoryHashes;
+    directoryHashes.insert(album1Dir, 1);
+    directoryHashes.insert(album2Dir, 2);
+    const auto newScannerGlobal = [&directoryHashes]() {
+        return ScannerGlobalPointer(new ScannerGlobal(QSet<QString>(),
+                directoryHashes,
+                QRegularExpression(),
+                QRegularExpression(),
+                QStringList(),
+                false));
+    };
+
+    auto scannerGlobal = newScannerGlobal();
+    EXPECT_FALSE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album1Dir)));
+
+    // The modification times of the directories that have been stored
+    // by the last scan. Both newer and older time stamps, e.g. due to
+    // clock skew or preserved by rsync -a, indicate a modification.
+    const QDateTime album1ModifiedAt = mixxx::FileInfo(album1Dir).lastModified();
+    const QDateTime album2ModifiedAt = mixxx::FileInfo(album2Dir).lastModified();
+    ASSERT_TRUE(album1ModifiedAt.isValid());
+    ASSERT_TRUE(album2ModifiedAt.isValid());
+    QHash<QString, QDateTime> directoryModificationTimes;
+    directoryModificationTimes.insert(album1Dir, album1ModifiedAt);
+    directoryModificationTimes.insert(album2Dir, album2ModifiedAt);
+    directoryModificationTimes.insert(artistDir, mixxx::FileInfo(artistDir).lastModified());
+    scannerGlobal->enableIncrementalScan(directoryModificationTimes, QSet<QString>{});
+    EXPECT_TRUE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album1Dir)));
+    EXPECT_TRUE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album2Dir)));
+    // Directories without a hash are always listed
+    EXPECT_FALSE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(artistDir)));
+    EXPECT_EQ((QSet<QString>{album1Dir, album2Dir}),
+            scannerGlobal->knownSubdirectories(artistDir));
+    EXPECT_EQ(QSet<QString>{artistDir},
+            scannerGlobal->knownSubdirectories(rootDir.path()));
+
+    directoryModificationTimes.insert(album1Dir, album1ModifiedAt.addSecs(60));
+    directoryModificationTimes.insert(album2Dir, album2ModifiedAt.addSecs(-60));
+    scannerGlobal = newScannerGlobal();
+    scannerGlobal->enableIncrementalScan(directoryModificationTimes, QSet<QString>{});
+    EXPECT_FALSE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album1Dir)));
+    EXPECT_FALSE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album2Dir)));
+
+    // Without a stored modification time the directory is unchanged
+    // only if the watcher did not report any modifications
+    scannerGlobal = newScannerGlobal();
+    scannerGlobal->enableIncrementalScan(
+            QHash<QString, QDateTime>{}, QSet<QString>{album2Dir});
+    EXPECT_FALSE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album1Dir)));
+    EXPECT_TRUE(scannerGlobal->directoryUnchangedSinceLastScan(mixxx::FileInfo(album2Dir)));
+}
+
+// Reports the throughput of the worker threads that parse the file tags
+// of new tracks in a synthetic library of range(0) files with range(1)
+// scanner threads. The database is not involved.
+void BM_ImportFilesOfSyntheticLibrary(benchmark::State& state) {
+    const ImportFilesBenchmarkScope scope;
+    const QTemporaryDir tempDir;
+    const auto directories = createSyntheticLibrary(
+            QDir(tempDir.path()),
+            MixxxTest::getOrInitTestDir().filePath(kTemplateFile),
+            static_cast<int>(state.range(0)));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(static_cast<int>(state.range(1)));
+    int importedFilesCount = 0;
+    for (auto _ : state) {
+        const auto scannerGlobal = ScannerGlobalPointer(new ScannerGlobal(
+                QSet<QString>(),
+                QHash<QString, mixxx::cache_key_t>(),
+                SoundSourceProxy::getSupportedFileNamesRegex(),
+                QRegularExpression(CoverArtUtils::supportedCoverArtExtensionsRegex(),
+                        QRegularExpression::CaseInsensitiveOption),
+                QStringList(),
+                false));
+        QAtomicInt addedTracksCount;
+        for (const auto& files : directories) {
+            auto* pTask = new ImportFilesTask(nullptr,
+                    scannerGlobal,
+                    files.front().absolutePath(),
+                    false,
+                    mixxx::invalidCacheKey(),
+                    QDateTime(),
+                    files,
+                    {},
+                    SecurityTokenPointer());
+            QObject::connect(
+                    pTask,
+                    &ScannerTask::addNewTrack,
+                    pTask,
+                    [&addedTracksCount](const QString&,
+                            const SoundSourceProxy::ImportedMetadata& importedMetadata) {
+                        if (importedMetadata.importResult ==
+                                mixxx::MetadataSource::ImportResult::Succeeded) {
+                            addedTracksCount.fetchAndAddRelaxed(1);
+                        }
+                    },
+                    Qt::DirectConnection);
+            scannerGlobal->getTaskWatcher().watchTask();
+            pool.start(pTask);
+        }
+        pool.waitForDone();
+        importedFilesCount += addedTracksCount.loadRelaxed();
+    }
+    state.counters["files_per_second"] = benchmark::Counter(
+            importedFilesCount, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ImportFilesOfSyntheticLibrary)
+        ->Args({10000, 1})
+        ->Args({10000, 4})
+        ->Args({100000, 1})
+        ->Args({100000, 2})
+        ->Args({100000, 4})
+        ->Args({100000, 8})
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
@@ -5,6 +5,7 @@
 #include "control/controlindicatortimer.h"
 #include "database/mixxxdb.h"
 #include "effects/effectsmanager.h"
+#include "engine/bufferscalers/soundtouchworkerpool.h"
 #include "engine/channels/enginedeck.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginemixer.h"
@@ -99,6 +100,7 @@ class PlayerManagerTest : public MixxxDbTest, SoundSourceProviderRegistration {
 
         m_pPlayerManager->bindToLibrary(m_pLibrary.get());
         RubberBandWorkerPool::createInstance();
+        SoundTouchWorkerPool::createInstance();
     }
 
     void TearDown() override {
@@ -106,6 +108,7 @@ class PlayerManagerTest : public MixxxDbTest, SoundSourceProviderRegistration {
 #ifdef __RUBBERBAND__
         RubberBandWorkerPool::destroy();
 #endif
+        SoundTouchWorkerPool::destroy();
     }
 
     ~PlayerManagerTest() {
@@ -0,0 +1,86 @@
+#include "engine/realtimeworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+class CountingTask : public RealtimeTask {
+  public:
+    CountingTask()
+            : m_runCount(0),
+              m_pThread(nullptr) {
+    }
+
+    int runCount() const {
+        return m_runCount.load();
+    }
+
+    QThread* thread() const {
+        return m_pThread.load();
+    }
+
+  protected:
+    void process() override {
+        m_pThread = QThread::currentThread();
+        m_runCount.fetch_add(1);
+    }
+
+  private:
+    std::atomic<int> m_runCount;
+    std::atomic<QThread*> m_pThread;
+};
+
+class RealtimeWorkerPoolTest : public MixxxTest {
+  protected:
+    void runTasks(RealtimeWorkerPool* pPool, int numTasks, int numRounds) {
+        std::vector<std::unique_ptr<CountingTask>> tasks;
+        for (int i = 0; i < numTasks; ++i) {
+            tasks.push_back(std::make_unique<CountingTask>());
+        }
+        for (int round = 0; round < numRounds; ++round) {
+            for (auto& pTask : tasks) {
+                pTask->submit(pPool);
+            }
+            for (auto& pTask : tasks) {
+                pTask->waitReady();
+            }
+            for (const auto& pTask : tasks) {
+                EXPECT_EQ(round + 1, pTask->runCount());
+            }
+        }
+    }
+};
+
+TEST_F(RealtimeWorkerPoolTest, DisabledByDefault) {
+    RealtimeWorkerPool pool(config());
+    EXPECT_FALSE(pool.isEnabled());
+
+    // Without workers all tasks are run by the submitting thread
+    CountingTask task;
+    task.submit(&pool);
+    task.waitReady();
+    EXPECT_EQ(1, task.runCount());
+    EXPECT_EQ(QThread::currentThread(), task.thread());
+}
+
+TEST_F(RealtimeWorkerPoolTest, NoPoolRunsInline) {
+    runTasks(nullptr, 4, 3);
+}
+
+TEST_F(RealtimeWorkerPoolTest, EnabledRunsAllTasks) {
+    config()->setValue(ConfigKey("[App]", "engine_multithreading"), true);
+    RealtimeWorkerPool pool(config());
+    EXPECT_EQ(QThread::idealThreadCount() > 1, pool.isEnabled());
+
+    // More tasks than workers, so some of them are always run inline
+    runTasks(&pool, 2 * QThread::idealThreadCount() + 1, 10);
+}
+
+} // namespace
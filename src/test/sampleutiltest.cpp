@@ -176,6 +176,60 @@ TEST_F(SampleUtilTest, add3WithGain) {
     }
 }
 
+TEST_F(SampleUtilTest, addWithRampingGain) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int k = evenBuffers[i];
+        CSAMPLE* buffer = buffers[k];
+        int size = sizes[k];
+        std::vector<CSAMPLE> source(size);
+        for (int j = 0; j < size; ++j) {
+            source[j] = static_cast<CSAMPLE>(j % 7) * 0.1f;
+        }
+        FillBuffer(buffer, 0.5f, size);
+        SampleUtil::addWithRampingGain(buffer, source.data(), 0.2f, 1.0f, size);
+        const CSAMPLE_GAIN gainDelta = (1.0f - 0.2f) / (size / 2);
+        for (int j = 0; j < size; ++j) {
+            const CSAMPLE_GAIN gain = 0.2f + gainDelta * (j / 2 + 1);
+            EXPECT_NEAR(0.5f + source[j] * gain, buffer[j], 1e-6);
+        }
+    }
+}
+
+TEST_F(SampleUtilTest, copyWithRampingGain) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int k = evenBuffers[i];
+        CSAMPLE* buffer = buffers[k];
+        int size = sizes[k];
+        std::vector<CSAMPLE> source(size);
+        for (int j = 0; j < size; ++j) {
+            source[j] = static_cast<CSAMPLE>(j % 5) * -0.1f;
+        }
+        SampleUtil::copyWithRampingGain(buffer, source.data(), 1.0f, 0.0f, size);
+        const CSAMPLE_GAIN gainDelta = -1.0f / (size / 2);
+        for (int j = 0; j < size; ++j) {
+            const CSAMPLE_GAIN gain = 1.0f + gainDelta * (j / 2 + 1);
+            EXPECT_NEAR(source[j] * gain, buffer[j], 1e-6);
+        }
+    }
+}
+
+TEST_F(SampleUtilTest, applyRampingGain) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int k = evenBuffers[i];
+        CSAMPLE* buffer = buffers[k];
+        int size = sizes[k];
+        FillBuffer(buffer, 0.8f, size);
+        SampleUtil::applyRampingGain(buffer, 0.0f, 0.5f, size);
+        const CSAMPLE_GAIN gainDelta = 0.5f / (size / 2);
+        for (int j = 0; j < size; ++j) {
+            const CSAMPLE_GAIN gain = gainDelta * (j / 2 + 1);
+            EXPECT_NEAR(0.8f * gain, buffer[j], 1e-6);
+        }
+        // The last frame reaches the target gain
+        EXPECT_FLOAT_EQ(0.8f * 0.5f, buffer[size - 1]);
+    }
+}
+
 TEST_F(SampleUtilTest, copyWithGain) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -652,4 +706,75 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+static void BM_AddWithRampingGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_AddWithRampingGain)->Range(64, 4096);
+
+static void BM_CopyWithRampingGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_CopyWithRampingGain)->Range(64, 4096);
+
+static void BM_ApplyRampingGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyRampingGain(buffer, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_ApplyRampingGain)->Range(64, 4096);
+
+// Mixes state.range(1) channels into a bus with ramping gains, like
+// ChannelMixer does when the channel faders are moved.
+static void BM_MixChannelsWithRampingGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    const auto numChannels = static_cast<int>(state.range(1));
+    CSAMPLE* output = SampleUtil::alloc(size);
+    std::vector<CSAMPLE*> channels;
+    for (int i = 0; i < numChannels; ++i) {
+        channels.push_back(SampleUtil::alloc(size));
+        SampleUtil::fill(channels.back(), 0.1f, size);
+    }
+
+    while (state.KeepRunning()) {
+        SampleUtil::clear(output, size);
+        for (CSAMPLE* channel : channels) {
+            SampleUtil::addWithRampingGain(output, channel, 0.9f, 1.0f, size);
+        }
+    }
+
+    SampleUtil::free(output);
+    for (CSAMPLE* channel : channels) {
+        SampleUtil::free(channel);
+    }
+}
+BENCHMARK(BM_MixChannelsWithRampingGain)->Ranges({{64, 4096}, {2, 16}});
+
 }  // namespace
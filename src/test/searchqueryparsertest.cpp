@@ -1381,3 +1381,26 @@ TEST_F(SearchQueryParserTest, QuotedOrOperator) {
     pTrackI->setComment("house");
     EXPECT_TRUE(pQuery->match(pTrackI));
 }
+
+TEST_F(SearchQueryParserTest, CompileTextQuery) {
+    m_parser.setSearchColumns({"artist", "title"});
+
+    CompiledQuery compiledQuery;
+    auto pQuery = m_parser.parseQuery("Ásdf -genre:\"\"", QString());
+    ASSERT_TRUE(pQuery->compile(&compiledQuery));
+    const auto& instructions = compiledQuery.instructions();
+    ASSERT_FALSE(instructions.empty());
+    EXPECT_EQ(CompiledQuery::Op::MatchText, instructions.front().op);
+    EXPECT_EQ(QStringList({"artist", "title"}), instructions.front().sqlColumns);
+    EXPECT_EQ(QString("asdf"), instructions.front().argument);
+    EXPECT_FALSE(instructions.front().exactMatch);
+    EXPECT_EQ(CompiledQuery::Op::And, instructions.back().op);
+
+    // Only evaluated by SQL
+    CompiledQuery unsupportedQuery;
+    EXPECT_FALSE(m_parser.parseQuery("bpm:120", QString())->compile(&unsupportedQuery));
+    EXPECT_FALSE(m_parser.parseQuery("as%df", QString())->compile(&unsupportedQuery));
+    EXPECT_FALSE(m_parser.parseQuery("asdf", "id > 0")->compile(&unsupportedQuery));
+    // NOT of a NULL column doesn't match in SQL
+    EXPECT_FALSE(m_parser.parseQuery("-asdf", QString())->compile(&unsupportedQuery));
+}
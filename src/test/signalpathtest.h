@@ -11,6 +11,7 @@
 #include "control/controlobject.h"
 #include "effects/effectsmanager.h"
 #include "engine/bufferscalers/enginebufferscale.h"
+#include "engine/bufferscalers/soundtouchworkerpool.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/channels/enginedeck.h"
 #include "engine/controls/ratecontrol.h"
@@ -70,6 +71,17 @@ class TestEngineMixer : public EngineMixer {
 class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
   protected:
     BaseSignalPathTest() {
+        createEngine();
+    }
+
+    ~BaseSignalPathTest() override {
+        destroyEngine();
+    }
+
+    /// Creates the engine with the decks. Called by the constructor, but
+    /// tests may destroy the engine and create it again, e.g. after changing
+    /// the config.
+    void createEngine() {
         m_pControlIndicatorTimer = std::make_unique<mixxx::ControlIndicatorTimer>();
         m_pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
         m_pNumDecks = new ControlObject(ConfigKey(
@@ -128,7 +140,7 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
         PlayerInfo::create();
     }
 
-    ~BaseSignalPathTest() override {
+    void destroyEngine() {
         delete m_pMixerDeck1;
         delete m_pMixerDeck2;
         delete m_pMixerDeck3;
@@ -149,12 +161,14 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
 #ifdef __RUBBERBAND__
         RubberBandWorkerPool::createInstance();
 #endif
+        SoundTouchWorkerPool::createInstance();
     }
 
     void TearDown() override {
 #ifdef __RUBBERBAND__
         RubberBandWorkerPool::destroy();
 #endif
+        SoundTouchWorkerPool::destroy();
     }
 
     void addDeck(EngineDeck* pDeck) {
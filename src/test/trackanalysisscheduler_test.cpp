@@ -0,0 +1,195 @@
+#include "analyzer/trackanalysisscheduler.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <map>
+
+#include "preferences/keydetectionsettings.h"
+#include "preferences/replaygainsettings.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+// A fixed corpus of files in different formats that are decodable
+// in all builds. Optional formats would be reported as failed.
+const QStringList kCorpusFiles = {
+        QStringLiteral("sine-30.wav"),
+        QStringLiteral("id3-test-data/cover-test.aiff"),
+        QStringLiteral("id3-test-data/cover-test.flac"),
+        QStringLiteral("id3-test-data/cover-test.ogg"),
+        QStringLiteral("id3-test-data/cover-test.wav"),
+};
+
+constexpr int kNumAnalyzerThreads = 2;
+
+const ConfigKey kAnalyzerMultiThreadingConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("analyzer_multithreading"));
+
+// The analysis is finished after a couple of seconds. Just prevent
+// that a failing test hangs forever.
+constexpr qint64 kTimeoutMillis = 5 * 60 * 1000;
+
+class CorpusEnvironment : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit CorpusEnvironment(const QDir& testDir) {
+        for (int i = 0; i < kCorpusFiles.size(); ++i) {
+            const TrackId trackId(QVariant(i + 1));
+            m_tracks.emplace(trackId,
+                    Track::newDummy(testDir.filePath(kCorpusFiles[i]), trackId));
+        }
+    }
+
+    TrackPointer loadTrackById(TrackId trackId) const override {
+        const auto i = m_tracks.find(trackId);
+        if (i == m_tracks.end()) {
+            return nullptr;
+        }
+        return i->second;
+    }
+
+    const std::map<TrackId, TrackPointer>& tracks() const {
+        return m_tracks;
+    }
+
+    QList<AnalyzerScheduledTrack> scheduledTracks() const {
+        QList<AnalyzerScheduledTrack> tracks;
+        for (const auto& [trackId, pTrack] : m_tracks) {
+            tracks.append(AnalyzerScheduledTrack(trackId));
+        }
+        return tracks;
+    }
+
+  private:
+    std::map<TrackId, TrackPointer> m_tracks;
+};
+
+struct AnalysisResult {
+    QByteArray beats;
+    Keys keys;
+    mixxx::ReplayGain replayGain;
+};
+
+struct CorpusResult {
+    int doneCount = 0;
+    std::map<TrackId, AnalysisResult> tracks;
+};
+
+// Analyzes all tracks of the corpus and returns the number of tracks
+// that have been reported as done together with the analysis results.
+CorpusResult analyzeCorpus(const QDir& testDir, const UserSettingsPointer& pConfig) {
+    auto pEnvironment = std::make_unique<CorpusEnvironment>(testDir);
+    const auto scheduledTracks = pEnvironment->scheduledTracks();
+    // The environment is owned by the scheduler
+    const auto tracks = pEnvironment->tracks();
+    // Without AnalyzerModeFlags::WithWaveform no database is needed
+    auto pScheduler = TrackAnalysisScheduler::createInstance(
+            std::move(pEnvironment),
+            kNumAnalyzerThreads,
+            mixxx::DbConnectionPoolPtr(),
+            pConfig,
+            AnalyzerModeFlags::WithBeats);
+
+    CorpusResult result;
+    bool finished = false;
+    QObject::connect(pScheduler.get(),
+            &TrackAnalysisScheduler::trackProgress,
+            [&result](TrackId, AnalyzerProgress analyzerProgress) {
+                // Failing to decode a file is reported as unknown
+                if (analyzerProgress == kAnalyzerProgressDone) {
+                    ++result.doneCount;
+                }
+            });
+    QObject::connect(pScheduler.get(),
+            &TrackAnalysisScheduler::finished,
+            [&finished] {
+                finished = true;
+            });
+
+    pScheduler->scheduleTracks(scheduledTracks);
+    pScheduler->resume();
+    QElapsedTimer timer;
+    timer.start();
+    while (!finished && !timer.hasExpired(kTimeoutMillis)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    pScheduler.reset();
+
+    for (const auto& [trackId, pTrack] : tracks) {
+        const auto pBeats = pTrack->getBeats();
+        result.tracks.emplace(trackId,
+                AnalysisResult{
+                        pBeats ? pBeats->toByteArray() : QByteArray(),
+                        pTrack->getKeys(),
+                        pTrack->getReplayGain(),
+                });
+    }
+    return result;
+}
+
+class TrackAnalysisSchedulerTest : public MixxxTest {
+  protected:
+    TrackAnalysisSchedulerTest() {
+        // All analyzers that are run by the worker pool
+        KeyDetectionSettings(config()).setKeyDetectionEnabled(true);
+        ReplayGainSettings replayGainSettings(config());
+        replayGainSettings.setReplayGainAnalyzerEnabled(true);
+        replayGainSettings.setReplayGainAnalyzerVersion(2);
+    }
+};
+
+TEST_F(TrackAnalysisSchedulerTest, AnalyzeCorpusSingleThreaded) {
+    config()->setValue(kAnalyzerMultiThreadingConfigKey, false);
+    EXPECT_EQ(kCorpusFiles.size(), analyzeCorpus(getTestDir(), config()).doneCount);
+}
+
+TEST_F(TrackAnalysisSchedulerTest, AnalyzeCorpusMultiThreaded) {
+    config()->setValue(kAnalyzerMultiThreadingConfigKey, true);
+    EXPECT_EQ(kCorpusFiles.size(), analyzeCorpus(getTestDir(), config()).doneCount);
+}
+
+TEST_F(TrackAnalysisSchedulerTest, PooledAnalysisMatchesSequential) {
+    config()->setValue(kAnalyzerMultiThreadingConfigKey, false);
+    const CorpusResult sequential = analyzeCorpus(getTestDir(), config());
+    ASSERT_EQ(kCorpusFiles.size(), sequential.doneCount);
+
+    config()->setValue(kAnalyzerMultiThreadingConfigKey, true);
+    const CorpusResult pooled = analyzeCorpus(getTestDir(), config());
+    ASSERT_EQ(kCorpusFiles.size(), pooled.doneCount);
+
+    ASSERT_EQ(sequential.tracks.size(), pooled.tracks.size());
+    for (const auto& [trackId, expected] : sequential.tracks) {
+        const auto& actual = pooled.tracks.at(trackId);
+        SCOPED_TRACE(trackId.toVariant().toString().toStdString());
+        EXPECT_FALSE(expected.beats.isEmpty());
+        EXPECT_EQ(expected.beats, actual.beats);
+        EXPECT_TRUE(expected.keys == actual.keys);
+        EXPECT_TRUE(expected.replayGain == actual.replayGain);
+    }
+}
+
+// Reports the throughput in tracks/minute with the shared pool of
+// analyzer workers disabled (0) and enabled (1).
+void BM_AnalyzeCorpus(benchmark::State& state) {
+    const QTemporaryDir tempDir;
+    const auto pConfig = UserSettingsPointer(
+            new UserSettings(tempDir.filePath(QStringLiteral("test.cfg"))));
+    pConfig->setValue(kAnalyzerMultiThreadingConfigKey, state.range(0) != 0);
+    const QDir& testDir = MixxxTest::getOrInitTestDir();
+
+    int analyzedTracksCount = 0;
+    for (auto _ : state) {
+        // All tracks are recreated for each iteration, because
+        // analyzed tracks would be skipped
+        analyzedTracksCount += analyzeCorpus(testDir, pConfig).doneCount;
+    }
+    state.counters["tracks_per_minute"] = benchmark::Counter(
+            analyzedTracksCount * 60.0, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_AnalyzeCorpus)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
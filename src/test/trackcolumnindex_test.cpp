@@ -0,0 +1,201 @@
+#include "library/trackcolumnindex.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+
+constexpr int kNumberColumn = 0;
+constexpr int kTextColumn = 1;
+constexpr int kKeyColumn = 2;
+
+class TrackColumnIndexTest : public testing::Test {
+  protected:
+    TrackColumnIndexTest()
+            : m_index(m_rows) {
+        m_index.setColumnTypes({
+                TrackColumnIndex::ColumnType::Numeric,
+                TrackColumnIndex::ColumnType::Text,
+                TrackColumnIndex::ColumnType::Key,
+        });
+    }
+
+    void setRow(int id, double number, const QString& text, const QString& key) {
+        const TrackId trackId(QVariant(id));
+        m_rows.insert(trackId, {QVariant(number), QVariant(text), QVariant(key)});
+        m_index.updateRow(trackId);
+    }
+
+    void removeRow(int id) {
+        const TrackId trackId(QVariant(id));
+        m_rows.remove(trackId);
+        m_index.removeRow(trackId);
+    }
+
+    QList<int> sorted(const QVector<TrackColumnIndex::ColumnOrder>& columnOrders) {
+        QVector<TrackId> trackIds;
+        for (auto it = m_rows.constBegin(); it != m_rows.constEnd(); ++it) {
+            trackIds.append(it.key());
+        }
+        m_index.sort(&trackIds,
+                columnOrders,
+                m_collator,
+                KeyUtils::KeyNotation::OpenKey);
+        QList<int> ids;
+        for (const auto& trackId : std::as_const(trackIds)) {
+            ids.append(trackId.toVariant().toInt());
+        }
+        return ids;
+    }
+
+    QList<int> filtered(const CompiledQuery& query) {
+        QList<TrackId> sortedTrackIds = m_rows.keys();
+        std::sort(sortedTrackIds.begin(), sortedTrackIds.end());
+        QVector<TrackId> trackIds(sortedTrackIds.begin(), sortedTrackIds.end());
+        m_index.filter(&trackIds, query);
+        QList<int> ids;
+        for (const auto& trackId : std::as_const(trackIds)) {
+            ids.append(trackId.toVariant().toInt());
+        }
+        return ids;
+    }
+
+    static CompiledQuery matchText(const QString& argument, bool exactMatch = false) {
+        CompiledQuery query;
+        query.matchText({}, argument, exactMatch);
+        query.instructions().back().columns = {kTextColumn};
+        return query;
+    }
+
+    TrackColumnIndex::Rows m_rows;
+    TrackColumnIndex m_index;
+    mixxx::StringCollator m_collator;
+};
+
+TEST_F(TrackColumnIndexTest, SortNumbers) {
+    setRow(1, 128.0, "a", "");
+    setRow(2, 90.5, "a", "");
+    setRow(3, 174.0, "a", "");
+    EXPECT_EQ(QList<int>({2, 1, 3}), sorted({{kNumberColumn, Qt::AscendingOrder}}));
+    EXPECT_EQ(QList<int>({3, 1, 2}), sorted({{kNumberColumn, Qt::DescendingOrder}}));
+}
+
+TEST_F(TrackColumnIndexTest, SortTextCaseInsensitive) {
+    setRow(1, 0, "beta", "");
+    setRow(2, 0, "Alpha", "");
+    setRow(3, 0, "alpha", "");
+    setRow(4, 0, "Gamma", "");
+    // Equal strings are ordered by track id
+    EXPECT_EQ(QList<int>({2, 3, 1, 4}), sorted({{kTextColumn, Qt::AscendingOrder}}));
+    EXPECT_EQ(QList<int>({4, 1, 2, 3}), sorted({{kTextColumn, Qt::DescendingOrder}}));
+}
+
+TEST_F(TrackColumnIndexTest, SortKeysByCircleOfFifths) {
+    setRow(1, 0, "", "D");
+    setRow(2, 0, "", "C");
+    setRow(3, 0, "", "G");
+    EXPECT_EQ(QList<int>({2, 3, 1}), sorted({{kKeyColumn, Qt::AscendingOrder}}));
+}
+
+TEST_F(TrackColumnIndexTest, SortMultipleColumns) {
+    setRow(1, 2, "b", "");
+    setRow(2, 1, "b", "");
+    setRow(3, 3, "a", "");
+    EXPECT_EQ(QList<int>({3, 2, 1}),
+            sorted({{kTextColumn, Qt::AscendingOrder},
+                    {kNumberColumn, Qt::AscendingOrder}}));
+}
+
+TEST_F(TrackColumnIndexTest, UpdateAndRemoveRows) {
+    setRow(1, 1, "c", "");
+    setRow(2, 2, "b", "");
+    setRow(3, 3, "a", "");
+    EXPECT_EQ(QList<int>({3, 2, 1}), sorted({{kTextColumn, Qt::AscendingOrder}}));
+
+    // Modified after the column has been materialized
+    setRow(3, 3, "d", "");
+    removeRow(2);
+    setRow(4, 4, "a", "");
+    EXPECT_EQ(QList<int>({4, 1, 3}), sorted({{kTextColumn, Qt::AscendingOrder}}));
+}
+
+TEST_F(TrackColumnIndexTest, FilterText) {
+    setRow(1, 0, "Daft Punk", "");
+    setRow(2, 0, "Punks not dead", "");
+    setRow(3, 0, "Café del Mar", "");
+    setRow(4, 0, "", "");
+    EXPECT_EQ(QList<int>({1, 2}), filtered(matchText("punk")));
+    // Matched without diacritics
+    EXPECT_EQ(QList<int>({3}), filtered(matchText("cafe")));
+    // Shorter than a trigram
+    EXPECT_EQ(QList<int>({1, 2, 3}), filtered(matchText("a")));
+    EXPECT_EQ(QList<int>(), filtered(matchText("xyz")));
+    EXPECT_EQ(QList<int>({1}), filtered(matchText("daft punk", true)));
+    EXPECT_EQ(QList<int>({4}), filtered(matchText("", true)));
+}
+
+TEST_F(TrackColumnIndexTest, FilterBooleanOperators) {
+    setRow(1, 0, "house", "");
+    setRow(2, 0, "techno", "");
+    setRow(3, 0, "tech house", "");
+
+    CompiledQuery andQuery = matchText("house");
+    for (const auto& instruction : matchText("tech").instructions()) {
+        andQuery.instructions().push_back(instruction);
+    }
+    andQuery.combine(CompiledQuery::Op::And, 2);
+    EXPECT_EQ(QList<int>({3}), filtered(andQuery));
+
+    CompiledQuery notQuery = matchText("tech");
+    notQuery.combine(CompiledQuery::Op::Not, 1);
+    EXPECT_EQ(QList<int>({1}), filtered(notQuery));
+
+    CompiledQuery emptyQuery;
+    emptyQuery.combine(CompiledQuery::Op::And, 0);
+    EXPECT_EQ(QList<int>({1, 2, 3}), filtered(emptyQuery));
+}
+
+TEST_F(TrackColumnIndexTest, FilterUpdatedRows) {
+    setRow(1, 0, "house", "");
+    setRow(2, 0, "techno", "");
+    EXPECT_EQ(QList<int>({1}), filtered(matchText("house")));
+
+    setRow(2, 0, "deep house", "");
+    EXPECT_EQ(QList<int>({1, 2}), filtered(matchText("house")));
+    removeRow(1);
+    EXPECT_EQ(QList<int>({2}), filtered(matchText("house")));
+}
+
+TEST_F(TrackColumnIndexTest, ReleaseUnusedStrings) {
+    constexpr int kRowCount = 100;
+    for (int id = 0; id < kRowCount; ++id) {
+        setRow(id, id, QStringLiteral("initial %1").arg(id), "");
+    }
+    // Materialize the text column
+    sorted({{kTextColumn, Qt::AscendingOrder}});
+
+    // Replace all strings many times
+    for (int i = 0; i < 100; ++i) {
+        for (int id = 0; id < kRowCount; ++id) {
+            const QString text = QStringLiteral("update %1 %2")
+                                         .arg(i)
+                                         .arg(kRowCount - id, 3, 10, QChar('0'));
+            setRow(id, id, text, "");
+        }
+    }
+    for (int id = 0; id < kRowCount / 2; ++id) {
+        removeRow(id);
+    }
+    EXPECT_LT(m_index.stringCount(), 5000);
+
+    // Strings that are still in use are sorted and matched correctly
+    const QList<int> ids = sorted({{kTextColumn, Qt::AscendingOrder}});
+    ASSERT_EQ(kRowCount / 2, ids.size());
+    EXPECT_EQ(kRowCount - 1, ids.first());
+    EXPECT_EQ(kRowCount / 2, ids.last());
+    EXPECT_EQ(QList<int>({kRowCount - 1}), filtered(matchText("update 99 001", true)));
+    EXPECT_EQ(QList<int>(), filtered(matchText("initial")));
+}
+
+} // namespace
@@ -1,6 +1,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "library/coverartutils.h"
+#include "sources/soundsourceproxy.h"
 #include "test/librarytest.h"
 #include "track/track.h"
 
@@ -56,3 +58,70 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, saveTracksBatch) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    const QDir dir(QDir::tempPath() + QStringLiteral("/batch"));
+    TrackPointer pTrack1 = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("file1.mp3"))));
+    TrackPointer pTrack2 = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("file2.mp3"))));
+    const TrackId trackId1 = internalCollection()->addTrack(pTrack1, false);
+    const TrackId trackId2 = internalCollection()->addTrack(pTrack2, false);
+    ASSERT_TRUE(trackId1.isValid());
+    ASSERT_TRUE(trackId2.isValid());
+
+    const auto titleInDatabase = [this](TrackId trackId) {
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT title FROM library WHERE id=:id");
+        query.bindValue(":id", trackId.toVariant());
+        EXPECT_TRUE(query.exec());
+        EXPECT_TRUE(query.next());
+        return query.value(0).toString();
+    };
+
+    pTrack1->setTitle(QStringLiteral("Title 1"));
+    pTrack2->setTitle(QStringLiteral("Title 2"));
+    trackDAO.saveTracksPrepare();
+    // Nested batches are merged into the outer batch
+    trackDAO.saveTracksPrepare();
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack1.get()));
+    trackDAO.saveTracksFinish();
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack2.get()));
+    trackDAO.saveTracksFinish();
+    EXPECT_FALSE(pTrack1->isDirty());
+    EXPECT_FALSE(pTrack2->isDirty());
+    EXPECT_EQ(QStringLiteral("Title 1"), titleInDatabase(trackId1));
+    EXPECT_EQ(QStringLiteral("Title 2"), titleInDatabase(trackId2));
+
+    // The prepared statement is reused outside of batches
+    pTrack1->setTitle(QStringLiteral("Title 3"));
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack1.get()));
+    EXPECT_EQ(QStringLiteral("Title 3"), titleInDatabase(trackId1));
+}
+
+TEST_F(TrackDAOTest, addTracksAddFileWithImportedMetadata) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+    const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(
+            getTestDir().filePath(QStringLiteral("id3-test-data/artist.mp3"))));
+
+    CoverInfoGuesser coverInfoGuesser;
+    auto importedMetadata = SoundSourceProxy::importMetadataOfNewTrackFromFile(
+            fileAccess, false, &coverInfoGuesser);
+    ASSERT_EQ(mixxx::MetadataSource::ImportResult::Succeeded, importedMetadata.importResult);
+    EXPECT_EQ(QStringLiteral("Test Artist"),
+            importedMetadata.trackMetadata.getTrackInfo().getArtist());
+    EXPECT_EQ(CoverInfo::GUESSED, importedMetadata.coverInfo.source);
+
+    // The file is not read again when adding the track
+    importedMetadata.trackMetadata.refTrackInfo().setArtist(QStringLiteral("Imported Artist"));
+    trackDAO.addTracksPrepare();
+    TrackPointer pTrack = trackDAO.addTracksAddFile(fileAccess, false, &importedMetadata);
+    trackDAO.addTracksFinish();
+    ASSERT_TRUE(pTrack);
+    EXPECT_TRUE(pTrack->getId().isValid());
+    EXPECT_FALSE(pTrack->isDirty());
+    EXPECT_EQ(QStringLiteral("Imported Artist"), pTrack->getArtist());
+    EXPECT_EQ(CoverInfo::GUESSED, pTrack->getCoverInfo().source);
+}
@@ -1,6 +1,7 @@
 #include "track/globaltrackcache.h"
 
 #include <QCoreApplication>
+#include <QThread>
 
 #include "moc_globaltrackcache.cpp"
 #include "track/track.h"
@@ -10,7 +11,7 @@
 
 namespace {
 
-constexpr std::size_t kUnorderedCollectionMinCapacity = 1024;
+constexpr std::size_t kUnorderedCollectionMinCapacity = 64;
 
 const mixxx::Logger kLogger("GlobalTrackCache");
 
@@ -30,6 +31,10 @@ inline bool traceLogEnabled() {
 
 constexpr bool kLogStats = false;
 
+// The shards that are held by all GlobalTrackCacheLocker instances
+// of the current thread
+thread_local quint32 t_lockedShards = 0;
+
 inline
 TrackRef createTrackRef(const Track& track) {
     return TrackRef::fromFileInfo(track.getFileInfo(), track.getId());
@@ -93,49 +98,97 @@ class EvictAndSaveFunctor {
 } // anonymous namespace
 
 GlobalTrackCacheLocker::GlobalTrackCacheLocker()
-        : m_pInstance(nullptr) {
-    lockCache();
+        : GlobalTrackCacheLocker(GlobalTrackCache::kAllShards) {
+}
+
+GlobalTrackCacheLocker::GlobalTrackCacheLocker(const TrackId& trackId)
+        : GlobalTrackCacheLocker(GlobalTrackCache::idShardMask(trackId)) {
+}
+
+GlobalTrackCacheLocker::GlobalTrackCacheLocker(const TrackRef& trackRef)
+        : GlobalTrackCacheLocker(GlobalTrackCache::trackRefShardMask(trackRef)) {
+}
+
+GlobalTrackCacheLocker::GlobalTrackCacheLocker(ShardMask shards)
+        : m_pInstance(s_pInstance),
+          m_lockedShards(0) {
+    DEBUG_ASSERT(m_pInstance);
+    lockShards(shards);
 }
 
 GlobalTrackCacheLocker::GlobalTrackCacheLocker(
         GlobalTrackCacheLocker&& moveable)
-        : m_pInstance(std::move(moveable.m_pInstance)) {
+        : m_pInstance(std::move(moveable.m_pInstance)),
+          m_lockedShards(moveable.m_lockedShards) {
     moveable.m_pInstance = nullptr;
+    moveable.m_lockedShards = 0;
 }
 
 GlobalTrackCacheLocker::~GlobalTrackCacheLocker() {
     unlockCache();
 }
 
-void GlobalTrackCacheLocker::lockCache() {
-    DEBUG_ASSERT(s_pInstance);
-    DEBUG_ASSERT(!m_pInstance);
+void GlobalTrackCacheLocker::lockShards(ShardMask shards) {
+    DEBUG_ASSERT(m_pInstance);
+    static_assert(sizeof(t_lockedShards) == sizeof(ShardMask));
+    // Shards that are held by an outer locker of this thread are
+    // neither locked nor unlocked again
+    const ShardMask newShards = shards & ~t_lockedShards;
+    if (!newShards) {
+        return;
+    }
+    // Locking shards out of order might cause a deadlock with other
+    // threads, regardless of which locker of this thread holds them
+    DEBUG_ASSERT(t_lockedShards < (newShards & (~newShards + 1)));
     if (traceLogEnabled()) {
-        kLogger.trace() << "Locking cache";
+        kLogger.trace() << "Locking shards" << newShards;
     }
-    s_pInstance->m_mutex.lock();
+    m_pInstance->lockShards(newShards);
     if (traceLogEnabled()) {
-        kLogger.trace() << "Cache is locked";
+        kLogger.trace() << "Shards are locked" << newShards;
     }
-    m_pInstance = s_pInstance;
+    m_lockedShards |= newShards;
+    t_lockedShards |= newShards;
 }
 
-void GlobalTrackCacheLocker::unlockCache() {
-    if (m_pInstance) {
-        if (traceLogEnabled()) {
-            kLogger.trace() << "Unlocking cache";
-        }
-        if (kLogStats && debugLogEnabled()) {
-            kLogger.debug()
-                    << "#tracksById ="
-                    << m_pInstance->m_tracksById.size()
-                    << "/ #tracksByCanonicalLocation ="
-                    << m_pInstance->m_tracksByCanonicalLocation.size();
+bool GlobalTrackCacheLocker::isLocked(ShardMask shards) const {
+    return (t_lockedShards & shards) == shards;
+}
+
+void GlobalTrackCacheLocker::unlockShards() {
+    DEBUG_ASSERT(m_pInstance);
+    if (!m_lockedShards) {
+        return;
+    }
+    if (traceLogEnabled()) {
+        kLogger.trace() << "Unlocking shards" << m_lockedShards;
+    }
+    if (kLogStats && debugLogEnabled() &&
+            m_lockedShards == GlobalTrackCache::kAllShards) {
+        std::size_t tracksById = 0;
+        for (const auto& shard : m_pInstance->m_tracksById) {
+            tracksById += shard.size();
         }
-        m_pInstance->m_mutex.unlock();
-        if (traceLogEnabled()) {
-            kLogger.trace() << "Cache is unlocked";
+        std::size_t tracksByCanonicalLocation = 0;
+        for (const auto& shard : m_pInstance->m_tracksByCanonicalLocation) {
+            tracksByCanonicalLocation += shard.size();
         }
+        kLogger.debug()
+                << "#tracksById ="
+                << tracksById
+                << "/ #tracksByCanonicalLocation ="
+                << tracksByCanonicalLocation;
+    }
+    // Lockers are expected to be released in reverse order
+    DEBUG_ASSERT((t_lockedShards & m_lockedShards) == m_lockedShards);
+    m_pInstance->unlockShards(m_lockedShards);
+    t_lockedShards &= ~m_lockedShards;
+    m_lockedShards = 0;
+}
+
+void GlobalTrackCacheLocker::unlockCache() {
+    if (m_pInstance) {
+        unlockShards();
         m_pInstance = nullptr;
     }
 }
@@ -143,44 +196,52 @@ void GlobalTrackCacheLocker::unlockCache() {
 void GlobalTrackCacheLocker::relocateCachedTracks(
         GlobalTrackCacheRelocator* pRelocator) const {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::kAllShards));
     m_pInstance->relocateTracks(pRelocator);
 }
 
 void GlobalTrackCacheLocker::purgeTrackId(const TrackId& trackId) {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::idShardMask(trackId)));
     m_pInstance->purgeTrackId(trackId);
 }
 
 void GlobalTrackCacheLocker::deactivateCache() const {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::kAllShards));
     m_pInstance->deactivate();
 }
 
 bool GlobalTrackCacheLocker::isEmpty() const {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::kAllShards));
     return m_pInstance->isEmpty();
 }
 
 TrackPointer GlobalTrackCacheLocker::lookupTrackById(
         const TrackId& trackId) const {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::idShardMask(trackId)));
     return m_pInstance->lookupById(trackId);
 }
 
 TrackPointer GlobalTrackCacheLocker::lookupTrackByRef(
         const TrackRef& trackRef) const {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::trackRefShardMask(trackRef)));
     return m_pInstance->lookupByRef(trackRef);
 }
 
 QSet<TrackId> GlobalTrackCacheLocker::getCachedTrackIds() const {
     DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(isLocked(GlobalTrackCache::kAllShards));
     return m_pInstance->getCachedTrackIds();
 }
 
 GlobalTrackCacheResolver::GlobalTrackCacheResolver(
         mixxx::FileAccess fileAccess)
-        : m_lookupResult(GlobalTrackCacheLookupResult::None) {
+        : GlobalTrackCacheLocker(ShardMask(0)),
+          m_lookupResult(GlobalTrackCacheLookupResult::None) {
     DEBUG_ASSERT(m_pInstance);
     m_pInstance->resolve(this, std::move(fileAccess), TrackId());
 }
@@ -188,7 +249,8 @@ GlobalTrackCacheResolver::GlobalTrackCacheResolver(
 GlobalTrackCacheResolver::GlobalTrackCacheResolver(
         mixxx::FileAccess fileAccess,
         TrackId trackId)
-        : m_lookupResult(GlobalTrackCacheLookupResult::None) {
+        : GlobalTrackCacheLocker(ShardMask(0)),
+          m_lookupResult(GlobalTrackCacheLookupResult::None) {
     DEBUG_ASSERT(m_pInstance);
     m_pInstance->resolve(this, std::move(fileAccess), std::move(trackId));
 }
@@ -214,6 +276,9 @@ void GlobalTrackCacheResolver::initTrackIdAndUnlockCache(TrackId trackId) {
         // Ignore initializing the same id twice
         DEBUG_ASSERT(m_trackRef.getId() == trackId);
     } else {
+        // Id shards always succeed the location shard that is
+        // already locked
+        lockShards(GlobalTrackCache::idShardMask(trackId));
         m_trackRef = m_pInstance->initTrackId(
                 m_strongPtr,
                 m_trackRef,
@@ -284,15 +349,25 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     // already have been either deleted or reused by a second
     // shared_ptr.
     if (s_pInstance) {
-        QMetaObject::invokeMethod(
-                s_pInstance,
-                [cacheEntryPtr = std::move(cacheEntryPtr)] {
-                    s_pInstance->slotEvictAndSave(cacheEntryPtr);
-                },
-                // Qt will choose either a direct or a queued connection
-                // depending on the thread from which this method has
-                // been invoked!
-                Qt::AutoConnection);
+        // Tracks that are released by other threads are collected
+        // and then evicted and saved together in a single batch.
+        bool firstPending;
+        {
+            const auto locked = lockMutex(&s_pInstance->m_pendingEvictionsMutex);
+            firstPending = s_pInstance->m_pendingEvictions.empty();
+            s_pInstance->m_pendingEvictions.push_back(std::move(cacheEntryPtr));
+        }
+        // Evicting locks the whole cache. If the current thread already
+        // holds some of the shards this would violate the lock order, so
+        // the eviction is deferred until the locks have been released.
+        if (QThread::currentThread() == s_pInstance->thread() && !t_lockedShards) {
+            s_pInstance->slotEvictAndSavePending();
+        } else if (firstPending) {
+            QMetaObject::invokeMethod(
+                    s_pInstance,
+                    &GlobalTrackCache::slotEvictAndSavePending,
+                    Qt::QueuedConnection);
+        }
     } else {
         // After the singular instance has been destroyed we are
         // not able to save pending changes. The track is deleted
@@ -308,14 +383,15 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
 GlobalTrackCache::GlobalTrackCache(
         GlobalTrackCacheSaver* pSaver,
         deleteTrackFn_t deleteTrackFn)
-        :
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-          m_mutex(QMutex::Recursive),
-#endif
-          m_pSaver(pSaver),
-          m_deleteTrackFn(deleteTrackFn),
-          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+        : m_pSaver(pSaver),
+          m_deleteTrackFn(deleteTrackFn) {
     DEBUG_ASSERT(m_pSaver);
+    for (auto& tracksById : m_tracksById) {
+        tracksById = TracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun);
+    }
+    for (auto& tracksByCanonicalLocation : m_tracksByCanonicalLocation) {
+        tracksByCanonicalLocation.reserve(kUnorderedCollectionMinCapacity);
+    }
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
 
@@ -323,53 +399,88 @@ GlobalTrackCache::~GlobalTrackCache() {
     deactivate();
 }
 
+//static
+int GlobalTrackCache::locationShardIndex(const QString& canonicalLocation) {
+    return static_cast<int>(qHash(canonicalLocation) % kShardCount);
+}
+
+//static
+int GlobalTrackCache::idShardIndex(const TrackId& trackId) {
+    return static_cast<int>(DbId::hash_fun(trackId) % kShardCount);
+}
+
+//static
+GlobalTrackCache::ShardMask GlobalTrackCache::trackRefShardMask(
+        const TrackRef& trackRef) {
+    ShardMask shards = 0;
+    if (trackRef.hasCanonicalLocation()) {
+        shards |= locationShardMask(trackRef.getCanonicalLocation());
+    }
+    if (trackRef.hasId()) {
+        shards |= idShardMask(trackRef.getId());
+    }
+    return shards;
+}
+
+void GlobalTrackCache::lockShards(ShardMask shards) const {
+    for (int i = 0; shards; ++i, shards >>= 1) {
+        if (shards & 1) {
+            m_shards[i].mutex.lock();
+        }
+    }
+}
+
+void GlobalTrackCache::unlockShards(ShardMask shards) const {
+    for (int i = static_cast<int>(m_shards.size()) - 1; i >= 0; --i) {
+        if (shards & (ShardMask(1) << i)) {
+            m_shards[i].mutex.unlock();
+        }
+    }
+}
+
 void GlobalTrackCache::relocateTracks(
         GlobalTrackCacheRelocator* pRelocator) {
     if (debugLogEnabled()) {
         kLogger.debug()
                 << "Relocating tracks";
     }
-    TracksByCanonicalLocation relocatedTracksByCanonicalLocation;
-    for (auto&&
-            i = m_tracksByCanonicalLocation.begin();
-            i != m_tracksByCanonicalLocation.end();
-            ++i) {
-        const QString oldCanonicalLocation = i->first;
-        Track* plainPtr = i->second->getPlainPtr();
-        const mixxx::FileInfo fileInfo = plainPtr->getFileInfo();
-        TrackRef trackRef = TrackRef::fromFileInfo(fileInfo, plainPtr->getId());
-        if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
-            auto relocatedFileAccess = pRelocator->relocateCachedTrack(trackRef.getId());
-            if (relocatedFileAccess.info().hasLocation() &&
-                    fileInfo != relocatedFileAccess.info()) {
-                plainPtr->relocate(relocatedFileAccess);
-                trackRef = TrackRef::fromFileInfo(
-                        relocatedFileAccess.info(),
-                        trackRef.getId());
+    // Relocated tracks might move into a different shard
+    std::array<TracksByCanonicalLocation, kShardCount> relocatedTracksByCanonicalLocation;
+    for (const auto& tracksByCanonicalLocation : m_tracksByCanonicalLocation) {
+        for (const auto& entry : tracksByCanonicalLocation) {
+            const QString& oldCanonicalLocation = entry.first;
+            Track* plainPtr = entry.second->getPlainPtr();
+            const mixxx::FileInfo fileInfo = plainPtr->getFileInfo();
+            TrackRef trackRef = TrackRef::fromFileInfo(fileInfo, plainPtr->getId());
+            if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
+                auto relocatedFileAccess = pRelocator->relocateCachedTrack(trackRef.getId());
+                if (relocatedFileAccess.info().hasLocation() &&
+                        fileInfo != relocatedFileAccess.info()) {
+                    plainPtr->relocate(relocatedFileAccess);
+                    trackRef = TrackRef::fromFileInfo(
+                            relocatedFileAccess.info(),
+                            trackRef.getId());
+                }
             }
+            if (!trackRef.hasCanonicalLocation()) {
+                kLogger.warning()
+                        << "Failed to relocate track"
+                        << oldCanonicalLocation
+                        << trackRef;
+                continue;
+            }
+            QString newCanonicalLocation = trackRef.getCanonicalLocation();
+            if (oldCanonicalLocation != newCanonicalLocation && debugLogEnabled()) {
+                kLogger.debug()
+                        << "Relocating track"
+                        << "from" << oldCanonicalLocation
+                        << "to" << newCanonicalLocation;
+            }
+            const int shardIndex = locationShardIndex(newCanonicalLocation);
+            relocatedTracksByCanonicalLocation[shardIndex].insert(std::make_pair(
+                    std::move(newCanonicalLocation),
+                    entry.second));
         }
-        if (!trackRef.hasCanonicalLocation()) {
-            kLogger.warning()
-                    << "Failed to relocate track"
-                    << oldCanonicalLocation
-                    << trackRef;
-            continue;
-        }
-        QString newCanonicalLocation = trackRef.getCanonicalLocation();
-        if (oldCanonicalLocation == newCanonicalLocation) {
-            // Copy the entry unmodified into the new map
-            relocatedTracksByCanonicalLocation.insert(*i);
-            continue;
-        }
-        if (debugLogEnabled()) {
-            kLogger.debug()
-                    << "Relocating track"
-                    << "from" << oldCanonicalLocation
-                    << "to" << newCanonicalLocation;
-        }
-        relocatedTracksByCanonicalLocation.insert(std::make_pair(
-                std::move(newCanonicalLocation),
-                i->second));
     }
     m_tracksByCanonicalLocation = std::move(relocatedTracksByCanonicalLocation);
 }
@@ -401,30 +512,31 @@ void GlobalTrackCache::deactivate() {
     // callback is triggered for all modified tracks before
     // exiting the application.
     kLogger.warning()
-            << "Evicting all remaining"
-            << m_tracksById.size()
-            << '/'
-            << m_tracksByCanonicalLocation.size()
-            << "tracks from cache";
-
-    while (!m_tracksById.empty()) {
-        auto i = m_tracksById.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(plainPtr->getFileInfo().canonicalLocation());
-        m_tracksById.erase(i);
+            << "Evicting all remaining tracks from cache";
+
+    for (auto& tracksById : m_tracksById) {
+        while (!tracksById.empty()) {
+            auto i = tracksById.begin();
+            Track* plainPtr= i->second->getPlainPtr();
+            saveEvictedTrack(plainPtr);
+            const QString canonicalLocation = plainPtr->getFileInfo().canonicalLocation();
+            m_tracksByCanonicalLocation[locationShardIndex(canonicalLocation)].erase(
+                    canonicalLocation);
+            tracksById.erase(i);
+        }
     }
 
-    while (!m_tracksByCanonicalLocation.empty()) {
-        auto i = m_tracksByCanonicalLocation.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(i);
+    for (auto& tracksByCanonicalLocation : m_tracksByCanonicalLocation) {
+        while (!tracksByCanonicalLocation.empty()) {
+            auto i = tracksByCanonicalLocation.begin();
+            Track* plainPtr= i->second->getPlainPtr();
+            saveEvictedTrack(plainPtr);
+            tracksByCanonicalLocation.erase(i);
+        }
     }
 
     // Verify that all cached tracks have been evicted
-    DEBUG_ASSERT(m_tracksById.empty());
-    DEBUG_ASSERT(m_tracksByCanonicalLocation.empty());
+    DEBUG_ASSERT(isEmpty());
 
     // The singular cache instance is already unavailable and
     // all allocated tracks will simply be deleted when their
@@ -434,14 +546,25 @@ void GlobalTrackCache::deactivate() {
 }
 
 bool GlobalTrackCache::isEmpty() const {
-    return m_tracksById.empty() && m_tracksByCanonicalLocation.empty();
+    for (const auto& tracksById : m_tracksById) {
+        if (!tracksById.empty()) {
+            return false;
+        }
+    }
+    for (const auto& tracksByCanonicalLocation : m_tracksByCanonicalLocation) {
+        if (!tracksByCanonicalLocation.empty()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 TrackPointer GlobalTrackCache::lookupById(
         const TrackId& trackId) {
     TrackPointer trackPtr;
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    const TracksById& tracksById = m_tracksById[idShardIndex(trackId)];
+    const auto trackById(tracksById.find(trackId));
+    if (tracksById.end() != trackById) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
@@ -488,9 +611,11 @@ TrackPointer GlobalTrackCache::lookupByRef(
 TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
         const QString& canonicalLocation) {
     TrackPointer trackPtr;
+    const TracksByCanonicalLocation& tracksByCanonicalLocation =
+            m_tracksByCanonicalLocation[locationShardIndex(canonicalLocation)];
     const auto trackByCanonicalLocation(
-            m_tracksByCanonicalLocation.find(canonicalLocation));
-    if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+            tracksByCanonicalLocation.find(canonicalLocation));
+    if (tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
@@ -513,14 +638,19 @@ TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
 
 QSet<TrackId> GlobalTrackCache::getCachedTrackIds() const {
     QSet<TrackId> trackIds;
-    for (const auto& entry : m_tracksById) {
-        trackIds << entry.first;
+    for (const auto& tracksById : m_tracksById) {
+        for (const auto& entry : tracksById) {
+            trackIds << entry.first;
+        }
     }
     return trackIds;
 }
 
 TrackPointer GlobalTrackCache::revive(
         GlobalTrackCacheEntryPointer entryPtr) {
+    // The same entry might be looked up concurrently by id and by
+    // canonical location while holding the locks of different shards
+    const auto locked = lockMutex(entryPtr->reviveMutex());
 
     TrackPointer savingPtr = entryPtr->lock();
     if (savingPtr) {
@@ -552,6 +682,27 @@ TrackPointer GlobalTrackCache::revive(
     return savingPtr;
 }
 
+bool GlobalTrackCache::resolveById(
+        GlobalTrackCacheResolver* /*in/out*/ pCacheResolver,
+        const TrackId& trackId) {
+    auto strongPtr = lookupById(trackId);
+    if (!strongPtr) {
+        return false;
+    }
+    if (debugLogEnabled()) {
+        kLogger.debug()
+                << "Cache hit - found track by id"
+                << trackId
+                << strongPtr.get();
+    }
+    TrackRef trackRef = createTrackRef(*strongPtr);
+    pCacheResolver->initLookupResult(
+            GlobalTrackCacheLookupResult::Hit,
+            std::move(strongPtr),
+            std::move(trackRef));
+    return true;
+}
+
 void GlobalTrackCache::resolve(
         GlobalTrackCacheResolver* /*in/out*/ pCacheResolver,
         mixxx::FileAccess /*in*/ fileAccess,
@@ -564,26 +715,22 @@ void GlobalTrackCache::resolve(
                     << "Resolving track by id"
                     << trackId;
         }
-        auto strongPtr = lookupById(trackId);
-        if (strongPtr) {
-            if (debugLogEnabled()) {
-                kLogger.debug()
-                        << "Cache hit - found track by id"
-                        << trackId
-                        << strongPtr.get();
-            }
-            TrackRef trackRef = createTrackRef(*strongPtr);
-            pCacheResolver->initLookupResult(
-                    GlobalTrackCacheLookupResult::Hit,
-                    std::move(strongPtr),
-                    std::move(trackRef));
+        pCacheResolver->lockShards(idShardMask(trackId));
+        if (resolveById(pCacheResolver, trackId)) {
             return;
         }
+        // The shard of the canonical location must be locked first
+        pCacheResolver->unlockShards();
     }
     // Secondary lookup by canonical location
     // The TrackRef is constructed now after the lookup by ID failed to
     // avoid calculating the canonical file path if it is not needed.
     TrackRef trackRef = TrackRef::fromFileInfo(fileAccess.info(), trackId);
+    pCacheResolver->lockShards(trackRefShardMask(trackRef));
+    // The track might have been added while the shard was unlocked
+    if (trackId.isValid() && resolveById(pCacheResolver, trackId)) {
+        return;
+    }
     if (trackRef.hasCanonicalLocation()) {
         if (debugLogEnabled()) {
             kLogger.debug()
@@ -654,17 +801,21 @@ void GlobalTrackCache::resolve(
 
     if (trackRef.hasId()) {
         // Insert item by id
-        DEBUG_ASSERT(m_tracksById.find(
-                trackRef.getId()) == m_tracksById.end());
-        m_tracksById.insert(std::make_pair(
+        TracksById& tracksById = m_tracksById[idShardIndex(trackRef.getId())];
+        DEBUG_ASSERT(tracksById.find(
+                trackRef.getId()) == tracksById.end());
+        tracksById.insert(std::make_pair(
                 trackRef.getId(),
                 cacheEntryPtr));
     }
     if (trackRef.hasCanonicalLocation()) {
         // Insert item by track location
-        DEBUG_ASSERT(m_tracksByCanonicalLocation.find(
-                trackRef.getCanonicalLocation()) == m_tracksByCanonicalLocation.end());
-        m_tracksByCanonicalLocation.insert(std::make_pair(
+        TracksByCanonicalLocation& tracksByCanonicalLocation =
+                m_tracksByCanonicalLocation[locationShardIndex(
+                        trackRef.getCanonicalLocation())];
+        DEBUG_ASSERT(tracksByCanonicalLocation.find(
+                trackRef.getCanonicalLocation()) == tracksByCanonicalLocation.end());
+        tracksByCanonicalLocation.insert(std::make_pair(
                 trackRef.getCanonicalLocation(),
                 cacheEntryPtr));
     }
@@ -696,14 +847,15 @@ TrackRef GlobalTrackCache::initTrackId(
     DEBUG_ASSERT(pDel);
 
     // Insert item by id
-    DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
-    m_tracksById.insert(std::make_pair(
+    TracksById& tracksById = m_tracksById[idShardIndex(trackId)];
+    DEBUG_ASSERT(tracksById.find(trackId) == tracksById.end());
+    tracksById.insert(std::make_pair(
             trackId,
             pDel->getCacheEntryPointer()));
 
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
-    DEBUG_ASSERT(m_tracksById.find(trackId) != m_tracksById.end());
+    DEBUG_ASSERT(tracksById.find(trackId) != tracksById.end());
 
     return trackRefWithId;
 }
@@ -711,15 +863,50 @@ TrackRef GlobalTrackCache::initTrackId(
 void GlobalTrackCache::purgeTrackId(TrackId trackId) {
     DEBUG_ASSERT(trackId.isValid());
 
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    TracksById& tracksById = m_tracksById[idShardIndex(trackId)];
+    const auto trackById(tracksById.find(trackId));
+    if (tracksById.end() != trackById) {
         Track* track = trackById->second->getPlainPtr();
         track->resetId();
-        m_tracksById.erase(trackById);
+        tracksById.erase(trackById);
+    }
+}
+
+void GlobalTrackCache::slotEvictAndSavePending() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    std::vector<GlobalTrackCacheEntryPointer> cacheEntryPtrs;
+    {
+        const auto locked = lockMutex(&m_pendingEvictionsMutex);
+        cacheEntryPtrs.swap(m_pendingEvictions);
+    }
+    if (cacheEntryPtrs.empty()) {
+        // Already evicted by a direct invocation
+        return;
+    }
+    if (debugLogEnabled()) {
+        kLogger.debug()
+                << "Evicting and saving"
+                << cacheEntryPtrs.size()
+                << "track(s)";
+    }
+
+    // The whole batch is saved while the cache is locked
+    GlobalTrackCacheLocker cacheLocker;
+
+    GlobalTrackCacheSaver* const pSaver = m_pSaver;
+    if (pSaver) {
+        pSaver->beginSavingEvictedTracks();
+    }
+    for (auto& cacheEntryPtr : cacheEntryPtrs) {
+        evictAndSave(std::move(cacheEntryPtr));
+    }
+    if (pSaver) {
+        pSaver->endSavingEvictedTracks();
     }
 }
 
-void GlobalTrackCache::slotEvictAndSave(
+void GlobalTrackCache::evictAndSave(
         GlobalTrackCacheEntryPointer cacheEntryPtr) {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     DEBUG_ASSERT(cacheEntryPtr);
@@ -782,10 +969,11 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
                 << plainPtr;
     }
     if (trackRef.hasId()) {
-        const auto trackById = m_tracksById.find(trackRef.getId());
-        if (trackById != m_tracksById.end()) {
+        TracksById& tracksById = m_tracksById[idShardIndex(trackRef.getId())];
+        const auto trackById = tracksById.find(trackRef.getId());
+        if (trackById != tracksById.end()) {
             if (trackById->second->getPlainPtr() == plainPtr) {
-                m_tracksById.erase(trackById);
+                tracksById.erase(trackById);
                 evicted = true;
             } else {
                 notEvicted = true;
@@ -793,11 +981,14 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
         }
     }
     if (trackRef.hasCanonicalLocation()) {
+        TracksByCanonicalLocation& tracksByCanonicalLocation =
+                m_tracksByCanonicalLocation[locationShardIndex(
+                        trackRef.getCanonicalLocation())];
         const auto trackByCanonicalLocation(
-                m_tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
-        if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+                tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
+        if (tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
             if (trackByCanonicalLocation->second->getPlainPtr() == plainPtr) {
-                m_tracksByCanonicalLocation.erase(
+                tracksByCanonicalLocation.erase(
                         trackByCanonicalLocation);
                 evicted = true;
             } else {
@@ -812,14 +1003,18 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
 }
 
 bool GlobalTrackCache::isCached(Track* plainPtr) const {
-    for (auto&& entry: m_tracksById) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-            return true;
+    for (const auto& tracksById : m_tracksById) {
+        for (auto&& entry : tracksById) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
-    for (auto&& entry: m_tracksByCanonicalLocation) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-              return true;
+    for (const auto& tracksByCanonicalLocation : m_tracksByCanonicalLocation) {
+        for (auto&& entry : tracksByCanonicalLocation) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
     return false;
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <map>
+#include <QMutex>
+#include <array>
 #include <unordered_map>
+#include <vector>
 
 #include "track/track_decl.h"
 #include "track/trackref.h"
@@ -57,7 +59,7 @@ class GlobalTrackCacheEntry final {
         : m_deletingPtr(std::move(deletingPtr)) {
     }
     GlobalTrackCacheEntry(const GlobalTrackCacheEntry& other) = delete;
-    GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = default;
+    GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = delete;
 
     void init(TrackWeakPointer savingWeakPtr) {
         // Uninitialized or expired
@@ -76,16 +78,42 @@ class GlobalTrackCacheEntry final {
         return m_savingWeakPtr.expired();
     }
 
+    /// The entry is reachable from two different shards of the cache,
+    /// by id and by canonical location. Reviving the track must be
+    /// serialized separately.
+    QMutex* reviveMutex() const {
+        return &m_reviveMutex;
+    }
+
   private:
+    mutable QMutex m_reviveMutex;
     std::unique_ptr<Track, TrackDeleter> m_deletingPtr;
     TrackWeakPointer m_savingWeakPtr;
 };
 
 typedef std::shared_ptr<GlobalTrackCacheEntry> GlobalTrackCacheEntryPointer;
 
+/// Locks either the whole GlobalTrackCache or only the shards that are
+/// needed for accessing a single track.
+///
+/// The cache is split into shards that are locked independently, one set
+/// for the index by canonical location and one set for the index by id.
+/// Shards are always locked in ascending order, i.e. all location shards
+/// before any id shard. This applies to all lockers of a thread together:
+/// the shards held by a thread are tracked across lockers and a nested
+/// locker must not lock additional shards that precede any shard already
+/// held by the thread. Shards that are already held by the thread are not
+/// locked again, but stay owned by the outer locker.
 class GlobalTrackCacheLocker {
 public:
+    /// Locks the whole cache
     GlobalTrackCacheLocker();
+    /// Locks only the shard that is needed for looking up
+    /// or purging the given id
+    explicit GlobalTrackCacheLocker(const TrackId& trackId);
+    /// Locks only the shards that are needed for looking up
+    /// the given reference
+    explicit GlobalTrackCacheLocker(const TrackRef& trackRef);
     GlobalTrackCacheLocker(const GlobalTrackCacheLocker&) = delete;
     GlobalTrackCacheLocker(GlobalTrackCacheLocker&&);
     virtual ~GlobalTrackCacheLocker();
@@ -116,16 +144,27 @@ public:
   private:
     friend class GlobalTrackCache;
 
-    void lockCache();
-
 protected:
+    // One bit per shard, location shards in the lower half
+    typedef quint32 ShardMask;
+
+    // Only locks the given shards, if any
+    explicit GlobalTrackCacheLocker(ShardMask shards);
+
     GlobalTrackCacheLocker(
             GlobalTrackCacheLocker&& moveable,
             GlobalTrackCacheLookupResult lookupResult,
             TrackPointer&& strongPtr,
             TrackRef&& trackRef);
 
+    void lockShards(ShardMask shards);
+    void unlockShards();
+    /// Checks if the shards are held by the current thread, either by
+    /// this or by an outer locker
+    bool isLocked(ShardMask shards) const;
+
     GlobalTrackCache* m_pInstance;
+    ShardMask m_lockedShards;
 };
 
 class GlobalTrackCacheResolver final: public GlobalTrackCacheLocker {
@@ -197,6 +236,15 @@ private:
     virtual void saveEvictedTrack(
             Track* pEvictedTrack) noexcept = 0;
 
+    /// Evicted tracks are saved in batches. These callbacks are
+    /// invoked before and after each batch while the cache is locked,
+    /// e.g. for saving all tracks of a batch in a single database
+    /// transaction.
+    virtual void beginSavingEvictedTracks() noexcept {
+    }
+    virtual void endSavingEvictedTracks() noexcept {
+    }
+
   protected:
     virtual ~GlobalTrackCacheSaver() = default;
 };
@@ -221,7 +269,7 @@ class GlobalTrackCache : public QObject {
     static void evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
   private slots:
-    void slotEvictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
+    void slotEvictAndSavePending();
 
   private:
     friend class GlobalTrackCacheLocker;
@@ -251,6 +299,9 @@ class GlobalTrackCache : public QObject {
 
     TrackPointer revive(GlobalTrackCacheEntryPointer entryPtr);
 
+    bool resolveById(
+            GlobalTrackCacheResolver* /*in/out*/ pCacheResolver,
+            const TrackId& trackId);
     void resolve(
             GlobalTrackCacheResolver* /*in/out*/ pCacheResolver,
             mixxx::FileAccess /*in*/ fileAccess,
@@ -270,10 +321,38 @@ class GlobalTrackCache : public QObject {
 
     void deactivate();
 
+    void evictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
     void saveEvictedTrack(Track* pEvictedTrack) const;
 
+    typedef GlobalTrackCacheLocker::ShardMask ShardMask;
+
+    static constexpr int kShardCount = 16;
+    static constexpr ShardMask kAllShards = ~ShardMask(0);
+    static_assert(sizeof(ShardMask) * 8 == 2 * kShardCount);
+
+    static int locationShardIndex(const QString& canonicalLocation);
+    static int idShardIndex(const TrackId& trackId);
+    static ShardMask locationShardMask(const QString& canonicalLocation) {
+        return ShardMask(1) << locationShardIndex(canonicalLocation);
+    }
+    static ShardMask idShardMask(const TrackId& trackId) {
+        return ShardMask(1) << (kShardCount + idShardIndex(trackId));
+    }
+    static ShardMask trackRefShardMask(const TrackRef& trackRef);
+
     // Managed by GlobalTrackCacheLocker
-    mutable QT_RECURSIVE_MUTEX m_mutex;
+    void lockShards(ShardMask shards) const;
+    void unlockShards(ShardMask shards) const;
+
+    class Shard {
+      public:
+        Shard()
+                : mutex(QT_RECURSIVE_MUTEX_INIT) {
+        }
+        mutable QT_RECURSIVE_MUTEX mutex;
+    };
+    // Indexed by the bits of ShardMask
+    std::array<Shard, 2 * kShardCount> m_shards;
 
     GlobalTrackCacheSaver* m_pSaver;
 
@@ -281,9 +360,14 @@ class GlobalTrackCache : public QObject {
 
     // This caches the unsaved Tracks by ID
     typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
-    TracksById m_tracksById;
+    std::array<TracksById, kShardCount> m_tracksById;
 
     // This caches the unsaved Tracks by location
-    typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
-    TracksByCanonicalLocation m_tracksByCanonicalLocation;
+    typedef std::unordered_map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
+    std::array<TracksByCanonicalLocation, kShardCount> m_tracksByCanonicalLocation;
+
+    // Tracks that have been released from any thread and
+    // are waiting to be evicted and saved in the next batch
+    QMutex m_pendingEvictionsMutex;
+    std::vector<GlobalTrackCacheEntryPointer> m_pendingEvictions;
 };
@@ -45,6 +45,7 @@ CmdlineArgs::CmdlineArgs()
           m_startAutoDJ(false),
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
+          m_controlProfiler(false),
           m_developer(false),
 #ifdef MIXXX_USE_QML
           m_qml(false),
@@ -257,6 +258,15 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(controllerAbortOnWarning);
 
+    const QCommandLineOption controlProfiler(QStringLiteral("control-profiler"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Records how often each control is set, by whom and "
+                                      "how long notifying its listeners takes. The most "
+                                      "frequently set controls are logged on exit and "
+                                      "shown as stats in developer-mode.")
+                            : QString());
+    parser.addOption(controlProfiler);
+
     const QCommandLineOption developer(QStringLiteral("developer"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Enables developer-mode. Includes extra log info, stats on "
@@ -416,6 +426,7 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
     m_controllerPreviewScreens = parser.isSet(controllerPreviewScreens);
     m_controllerAbortOnWarning = parser.isSet(controllerAbortOnWarning);
+    m_controlProfiler = parser.isSet(controlProfiler);
     m_developer = parser.isSet(developer);
 #ifdef MIXXX_USE_QML
     m_qml = parser.isSet(qml);
@@ -42,6 +42,9 @@ class CmdlineArgs final {
     bool getControllerAbortOnWarning() const {
         return m_controllerAbortOnWarning;
     }
+    bool getControlProfiler() const {
+        return m_controlProfiler;
+    }
     bool getDeveloper() const { return m_developer; }
 #ifdef MIXXX_USE_QML
     bool isQml() const {
@@ -92,6 +95,7 @@ class CmdlineArgs final {
     bool m_controllerDebug;
     bool m_controllerPreviewScreens;
     bool m_controllerAbortOnWarning; // Controller Engine will be stricter
+    bool m_controlProfiler;
     bool m_developer; // Developer Mode
 #ifdef MIXXX_USE_QML
     bool m_qml;
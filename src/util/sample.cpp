@@ -5,6 +5,7 @@
 
 #include "engine/engine.h"
 #include "util/math.h"
+#include "util/samplesimd.h"
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -142,13 +143,9 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        // Explicitly vectorized, see util/samplesimd.h
+        mixxx::simd::copyWithRampingGainStereo(
+                pBuffer, pBuffer, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -267,12 +264,9 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        // Explicitly vectorized, see util/samplesimd.h
+        mixxx::simd::addWithRampingGainStereo(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -365,12 +359,9 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i).
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        // Explicitly vectorized, see util/samplesimd.h
+        mixxx::simd::copyWithRampingGainStereo(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (SINT i = 0; i < numSamples; ++i) {
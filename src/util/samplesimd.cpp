@@ -0,0 +1,309 @@
+#include "util/samplesimd.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIXXX_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// The AVX2 kernels are only compiled where the compiler allows enabling the
+// instruction set per function, so the rest of the build stays portable.
+#if defined(MIXXX_SIMD_SSE2) && defined(__GNUC__) && \
+        (defined(__x86_64__) || defined(__i386__))
+#define MIXXX_SIMD_AVX2
+#define MIXXX_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace mixxx {
+
+namespace simd {
+
+namespace {
+
+// The per sample operation of each kernel, shared by all implementations
+// so they only differ in the number of frames processed per iteration.
+struct AddOp {
+    static CSAMPLE scalar(CSAMPLE dest, CSAMPLE src, CSAMPLE_GAIN gain) {
+        return dest + src * gain;
+    }
+#ifdef MIXXX_SIMD_SSE2
+    static __m128 sse2(__m128 dest, __m128 src, __m128 gain) {
+        return _mm_add_ps(dest, _mm_mul_ps(src, gain));
+    }
+#endif
+#ifdef MIXXX_SIMD_AVX2
+    MIXXX_SIMD_TARGET_AVX2 static __m256 avx2(__m256 dest, __m256 src, __m256 gain) {
+        // No FMA to stay bit exact with the other implementations
+        return _mm256_add_ps(dest, _mm256_mul_ps(src, gain));
+    }
+#endif
+};
+
+struct CopyOp {
+    static CSAMPLE scalar(CSAMPLE /*dest*/, CSAMPLE src, CSAMPLE_GAIN gain) {
+        return src * gain;
+    }
+#ifdef MIXXX_SIMD_SSE2
+    static __m128 sse2(__m128 /*dest*/, __m128 src, __m128 gain) {
+        return _mm_mul_ps(src, gain);
+    }
+#endif
+#ifdef MIXXX_SIMD_AVX2
+    MIXXX_SIMD_TARGET_AVX2 static __m256 avx2(__m256 /*dest*/, __m256 src, __m256 gain) {
+        return _mm256_mul_ps(src, gain);
+    }
+#endif
+};
+
+template<typename Op>
+void rampScalar(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT firstFrame,
+        SINT numFrames) {
+    for (SINT i = firstFrame; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * static_cast<CSAMPLE_GAIN>(i);
+        pDest[i * 2] = Op::scalar(pDest[i * 2], pSrc[i * 2], gain);
+        pDest[i * 2 + 1] = Op::scalar(pDest[i * 2 + 1], pSrc[i * 2 + 1], gain);
+    }
+}
+
+#ifdef MIXXX_SIMD_SSE2
+template<typename Op>
+void rampSse2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    constexpr SINT kFramesPerVector = 2;
+    const __m128 vStartGain = _mm_set1_ps(startGain);
+    const __m128 vGainDelta = _mm_set1_ps(gainDelta);
+    const __m128 vStep = _mm_set1_ps(static_cast<float>(kFramesPerVector));
+    // The frame index of each lane, L and R share the same index
+    __m128 vFrame = _mm_set_ps(1.0f, 1.0f, 0.0f, 0.0f);
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const __m128 vGain = _mm_add_ps(vStartGain, _mm_mul_ps(vGainDelta, vFrame));
+        const __m128 vSrc = _mm_loadu_ps(pSrc + i * 2);
+        const __m128 vDest = _mm_loadu_ps(pDest + i * 2);
+        _mm_storeu_ps(pDest + i * 2, Op::sse2(vDest, vSrc, vGain));
+        vFrame = _mm_add_ps(vFrame, vStep);
+    }
+    rampScalar<Op>(pDest, pSrc, startGain, gainDelta, i, numFrames);
+}
+#endif
+
+#ifdef MIXXX_SIMD_AVX2
+template<typename Op>
+MIXXX_SIMD_TARGET_AVX2 void rampAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    constexpr SINT kFramesPerVector = 4;
+    const __m256 vStartGain = _mm256_set1_ps(startGain);
+    const __m256 vGainDelta = _mm256_set1_ps(gainDelta);
+    const __m256 vStep = _mm256_set1_ps(static_cast<float>(kFramesPerVector));
+    __m256 vFrame = _mm256_set_ps(3.0f, 3.0f, 2.0f, 2.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const __m256 vGain = _mm256_add_ps(vStartGain, _mm256_mul_ps(vGainDelta, vFrame));
+        const __m256 vSrc = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 vDest = _mm256_loadu_ps(pDest + i * 2);
+        _mm256_storeu_ps(pDest + i * 2, Op::avx2(vDest, vSrc, vGain));
+        vFrame = _mm256_add_ps(vFrame, vStep);
+    }
+    rampScalar<Op>(pDest, pSrc, startGain, gainDelta, i, numFrames);
+}
+#endif
+
+template<typename Op>
+void rampScalarAll(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampScalar<Op>(pDest, pSrc, startGain, gainDelta, 0, numFrames);
+}
+
+void peakScalar(const CSAMPLE* pSrc,
+        SINT firstFrame,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight) {
+    for (SINT i = firstFrame; i < numFrames; ++i) {
+        const CSAMPLE left = std::fabs(pSrc[i * 2]);
+        const CSAMPLE right = std::fabs(pSrc[i * 2 + 1]);
+        if (*pPeakLeft < left) {
+            *pPeakLeft = left;
+        }
+        if (*pPeakRight < right) {
+            *pPeakRight = right;
+        }
+    }
+}
+
+void peakScalarAll(const CSAMPLE* pSrc,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight) {
+    peakScalar(pSrc, 0, numFrames, pPeakLeft, pPeakRight);
+}
+
+#ifdef MIXXX_SIMD_SSE2
+// Folds the lanes L0 R0 L1 R1 into the peaks
+void storePeaksSse2(__m128 vPeak, CSAMPLE* pPeakLeft, CSAMPLE* pPeakRight) {
+    vPeak = _mm_max_ps(vPeak, _mm_movehl_ps(vPeak, vPeak));
+    const CSAMPLE left = _mm_cvtss_f32(vPeak);
+    const CSAMPLE right = _mm_cvtss_f32(_mm_shuffle_ps(vPeak, vPeak, _MM_SHUFFLE(1, 1, 1, 1)));
+    if (*pPeakLeft < left) {
+        *pPeakLeft = left;
+    }
+    if (*pPeakRight < right) {
+        *pPeakRight = right;
+    }
+}
+
+void peakSse2(const CSAMPLE* pSrc,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight) {
+    constexpr SINT kFramesPerVector = 2;
+    const __m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vPeak = _mm_setzero_ps();
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const __m128 vAbs = _mm_and_ps(_mm_loadu_ps(pSrc + i * 2), vAbsMask);
+        // NaN samples are ignored like in the scalar comparison
+        vPeak = _mm_max_ps(vAbs, vPeak);
+    }
+    storePeaksSse2(vPeak, pPeakLeft, pPeakRight);
+    peakScalar(pSrc, i, numFrames, pPeakLeft, pPeakRight);
+}
+#endif
+
+#ifdef MIXXX_SIMD_AVX2
+MIXXX_SIMD_TARGET_AVX2 void peakAvx2(const CSAMPLE* pSrc,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight) {
+    constexpr SINT kFramesPerVector = 4;
+    const __m256 vAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vPeak = _mm256_setzero_ps();
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const __m256 vAbs = _mm256_and_ps(_mm256_loadu_ps(pSrc + i * 2), vAbsMask);
+        vPeak = _mm256_max_ps(vAbs, vPeak);
+    }
+    storePeaksSse2(
+            _mm_max_ps(_mm256_castps256_ps128(vPeak), _mm256_extractf128_ps(vPeak, 1)),
+            pPeakLeft,
+            pPeakRight);
+    peakScalar(pSrc, i, numFrames, pPeakLeft, pPeakRight);
+}
+#endif
+
+typedef void (*RampKernel)(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames);
+
+typedef void (*PeakKernel)(const CSAMPLE* pSrc,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight);
+
+struct Kernels {
+    InstructionSet instructionSet;
+    RampKernel addWithRampingGain;
+    RampKernel copyWithRampingGain;
+    PeakKernel peakAbsStereo;
+};
+
+InstructionSet detectInstructionSet() {
+#ifdef MIXXX_SIMD_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::Avx2;
+    }
+#endif
+#ifdef MIXXX_SIMD_SSE2
+    return InstructionSet::Sse2;
+#else
+    return InstructionSet::Scalar;
+#endif
+}
+
+Kernels selectKernels() {
+    switch (detectInstructionSet()) {
+#ifdef MIXXX_SIMD_AVX2
+    case InstructionSet::Avx2:
+        return {InstructionSet::Avx2, &rampAvx2<AddOp>, &rampAvx2<CopyOp>, &peakAvx2};
+#endif
+#ifdef MIXXX_SIMD_SSE2
+    case InstructionSet::Sse2:
+        return {InstructionSet::Sse2, &rampSse2<AddOp>, &rampSse2<CopyOp>, &peakSse2};
+#endif
+    default:
+        return {InstructionSet::Scalar,
+                &rampScalarAll<AddOp>,
+                &rampScalarAll<CopyOp>,
+                &peakScalarAll};
+    }
+}
+
+const Kernels& kernels() {
+    // Detected only once, the first call is made from SampleUtil's users
+    // during engine setup or by the first analyzer.
+    static const Kernels s_kernels = selectKernels();
+    return s_kernels;
+}
+
+} // anonymous namespace
+
+InstructionSet instructionSet() {
+    return kernels().instructionSet;
+}
+
+const char* instructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Avx2:
+        return "AVX2";
+    case InstructionSet::Sse2:
+        return "SSE2";
+    case InstructionSet::Scalar:
+        break;
+    }
+    return "scalar";
+}
+
+void addWithRampingGainStereo(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    kernels().addWithRampingGain(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+void copyWithRampingGainStereo(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    kernels().copyWithRampingGain(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+void peakAbsStereo(const CSAMPLE* pSrc,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight) {
+    kernels().peakAbsStereo(pSrc, numFrames, pPeakLeft, pPeakRight);
+}
+
+} // namespace simd
+
+} // namespace mixxx
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "util/types.h"
+
+namespace mixxx {
+
+/// Explicitly vectorized kernels for the ramped gain paths of SampleUtil,
+/// which are used for mixing the channels into the main, headphone and
+/// talkover buses, and for the peak detection of the waveform analysis.
+///
+/// The portable build only enables SSE2 at compile time. The AVX2 kernels
+/// are compiled with a function level target attribute and selected at
+/// runtime if the CPU supports them, with a scalar fallback on all other
+/// architectures.
+namespace simd {
+
+enum class InstructionSet {
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+/// The instruction set used by the kernels below, detected once at startup.
+InstructionSet instructionSet();
+
+const char* instructionSetName(InstructionSet instructionSet);
+
+/// All kernels process interleaved stereo frames. The gain applied to both
+/// samples of frame i is startGain + gainDelta * i, the same ramp the scalar
+/// code in SampleUtil uses.
+
+/// pDest[i] += pSrc[i] * gain
+void addWithRampingGainStereo(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames);
+
+/// pDest[i] = pSrc[i] * gain. pDest may be equal to pSrc for applying
+/// the ramp in place, but the buffers must not overlap otherwise.
+void copyWithRampingGainStereo(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames);
+
+/// Raises *pPeakLeft and *pPeakRight to the maximum absolute value of the
+/// left and right samples respectively. The peaks are left untouched if no
+/// sample exceeds them.
+void peakAbsStereo(const CSAMPLE* pSrc,
+        SINT numFrames,
+        CSAMPLE* pPeakLeft,
+        CSAMPLE* pPeakRight);
+
+} // namespace simd
+
+} // namespace mixxx
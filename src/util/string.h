@@ -29,6 +29,12 @@ class StringCollator {
         return m_collator.compare(s1, s2);
     }
 
+    /// Precomputed key for comparing the same string many times.
+    /// Comparing the keys gives the same result as compare().
+    QCollatorSortKey sortKey(const QString& s) const {
+        return m_collator.sortKey(s);
+    }
+
   private:
     QCollator m_collator;
 };
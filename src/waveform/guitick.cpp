@@ -1,6 +1,7 @@
 #include "waveform/guitick.h"
 
 #include "control/controlobject.h"
+#include "control/controlprofiler.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
@@ -20,6 +21,8 @@ GuiTick::GuiTick() {
 // this is called from WaveformWidgetFactory::render in the main thread with the
 // configured waveform frame rate
 void GuiTick::process() {
+    m_changeSet.drain();
+
     m_cpuTimeLastTick += m_cpuTimer.restart();
     double cpuTimeLastTickSeconds = m_cpuTimeLastTick.toDoubleSeconds();
     m_pCOGuiTickTime->set(cpuTimeLastTickSeconds);
@@ -27,5 +30,6 @@ void GuiTick::process() {
     if (m_cpuTimeLastTick - m_lastUpdateTime >= mixxx::Duration::fromMillis(50)) {
         m_lastUpdateTime = m_cpuTimeLastTick;
         m_pCOGuiTick50ms->set(cpuTimeLastTickSeconds);
+        ControlProfiler::updateStats();
     }
 }
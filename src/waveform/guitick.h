@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "control/controlchangeset.h"
 #include "control/controlobject.h"
 #include "util/duration.h"
 #include "util/performancetimer.h"
@@ -14,7 +15,14 @@ class GuiTick {
     GuiTick();
     void process();
 
+    /// Changes of the controls in this set are delivered to the GUI once
+    /// per frame.
+    ControlChangeSet* changeSet() {
+        return &m_changeSet;
+    }
+
   private:
+    ControlChangeSet m_changeSet;
     std::unique_ptr<ControlObject> m_pCOGuiTickTime;
     std::unique_ptr<ControlObject> m_pCOGuiTick50ms;
     PerformanceTimer m_cpuTimer;
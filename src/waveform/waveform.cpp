@@ -1,6 +1,8 @@
 #include "waveform/waveform.h"
 
+#include <QDataStream>
 #include <QtDebug>
+#include <limits>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
@@ -18,6 +20,55 @@ int computeTextureStride(int size) {
     return stride;
 }
 
+namespace {
+
+// The compact encoding stores a small header followed by the planes of
+// all bands and stems. Each plane contains the differences between
+// subsequent values of the same channel, which are mostly close to 0 and
+// compress much better than the protobuf message with its varints. No
+// parsing is needed when loading besides undoing the differences.
+//
+//   magic "MXWF", format version, stem count, 2 reserved bytes,
+//   visual sample rate (double), audio visual ratio (double), data size
+//   all, low, mid, high, stem 1, ..., stem n (data size bytes each)
+const QByteArray kCompactMagic = QByteArrayLiteral("MXWF");
+constexpr quint8 kCompactFormatVersion = 1;
+constexpr int kCompactHeaderSize = 4 + 1 + 1 + 2 + 8 + 8 + 4;
+constexpr int kCompactFilteredPlaneCount = 4;
+
+unsigned char WaveformFilteredData::*const kCompactFilteredPlanes[kCompactFilteredPlaneCount] = {
+        &WaveformFilteredData::all,
+        &WaveformFilteredData::low,
+        &WaveformFilteredData::mid,
+        &WaveformFilteredData::high,
+};
+
+double computeVisualSampleRate(
+        int audioSampleRate,
+        SINT frameLength,
+        int desiredVisualSampleRate,
+        int maxVisualSamples) {
+    DEBUG_ASSERT(audioSampleRate > 0);
+    if (maxVisualSamples == -1) {
+        // Waveform
+        if (desiredVisualSampleRate < audioSampleRate) {
+            return static_cast<double>(desiredVisualSampleRate);
+        } else {
+            return static_cast<double>(audioSampleRate);
+        }
+    } else {
+        // Waveform Summary (Overview)
+        if (frameLength > maxVisualSamples / mixxx::kAnalysisChannels) {
+            return static_cast<double>(audioSampleRate) *
+                    maxVisualSamples / mixxx::kAnalysisChannels / frameLength;
+        } else {
+            return audioSampleRate;
+        }
+    }
+}
+
+} // anonymous namespace
+
 Waveform::Waveform(const QByteArray& data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
@@ -25,7 +76,8 @@ Waveform::Waveform(const QByteArray& data)
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_stemCount(0) {
     readByteArray(data);
 }
 
@@ -45,23 +97,8 @@ Waveform::Waveform(
           m_stemCount(stemCount) {
     int numberOfVisualSamples = 0;
     if (audioSampleRate > 0) {
-        if (maxVisualSamples == -1) {
-            // Waveform
-            if (desiredVisualSampleRate < audioSampleRate) {
-                m_visualSampleRate =
-                        static_cast<double>(desiredVisualSampleRate);
-            } else {
-                m_visualSampleRate = static_cast<double>(audioSampleRate);
-            }
-        } else {
-            // Waveform Summary (Overview)
-            if (frameLength > maxVisualSamples / mixxx::kAnalysisChannels) {
-                m_visualSampleRate = static_cast<double>(audioSampleRate) *
-                        maxVisualSamples / mixxx::kAnalysisChannels / frameLength;
-            } else {
-                m_visualSampleRate = audioSampleRate;
-            }
-        }
+        m_visualSampleRate = computeVisualSampleRate(
+                audioSampleRate, frameLength, desiredVisualSampleRate, maxVisualSamples);
         m_audioVisualRatio = (double)audioSampleRate / (double)m_visualSampleRate;
         numberOfVisualSamples =
                 static_cast<int>(frameLength / m_audioVisualRatio *
@@ -76,6 +113,22 @@ Waveform::Waveform(
 Waveform::~Waveform() {
 }
 
+// static
+double Waveform::computeAudioVisualRatio(
+        int audioSampleRate,
+        SINT frameLength,
+        int desiredVisualSampleRate,
+        int maxVisualSamples) {
+    if (audioSampleRate <= 0) {
+        return 0;
+    }
+    return (double)audioSampleRate /
+            computeVisualSampleRate(audioSampleRate,
+                    frameLength,
+                    desiredVisualSampleRate,
+                    maxVisualSamples);
+}
+
 QByteArray Waveform::toByteArray() const {
     io::Waveform waveform;
     waveform.set_visual_sample_rate(m_visualSampleRate);
@@ -151,11 +204,130 @@ QByteArray Waveform::toByteArray() const {
     return QByteArray(output.data(), static_cast<int>(output.length()));
 }
 
+QByteArray Waveform::toCompactByteArray() const {
+    const int dataSize = getDataSize();
+    QByteArray output;
+    output.reserve(kCompactHeaderSize +
+            (kCompactFilteredPlaneCount + m_stemCount) * dataSize);
+    {
+        QDataStream stream(&output, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        stream.writeRawData(kCompactMagic.constData(), kCompactMagic.size());
+        stream << kCompactFormatVersion
+               << static_cast<quint8>(m_stemCount)
+               << static_cast<quint16>(0)
+               << m_visualSampleRate
+               << m_audioVisualRatio
+               << static_cast<quint32>(dataSize);
+    }
+    DEBUG_ASSERT(output.size() == kCompactHeaderSize);
+
+    const auto appendPlane = [&](auto getValue) {
+        const int offset = static_cast<int>(output.size());
+        output.resize(offset + dataSize);
+        auto* pPlane = reinterpret_cast<unsigned char*>(output.data() + offset);
+        for (int i = 0; i < dataSize; ++i) {
+            // Differences modulo 256 to the previous value of the same channel
+            const unsigned char previous = i >= ChannelCount
+                    ? getValue(m_data[i - ChannelCount])
+                    : 0;
+            pPlane[i] = static_cast<unsigned char>(getValue(m_data[i]) - previous);
+        }
+    };
+    for (const auto pMember : kCompactFilteredPlanes) {
+        appendPlane([pMember](const WaveformData& datum) {
+            return datum.filtered.*pMember;
+        });
+    }
+    for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
+        appendPlane([stemIdx](const WaveformData& datum) {
+            return datum.stems[stemIdx];
+        });
+    }
+    return output;
+}
+
+// static
+bool Waveform::isCompactByteArray(const QByteArray& data) {
+    return data.startsWith(kCompactMagic);
+}
+
+void Waveform::readCompactByteArray(const QByteArray& data) {
+    quint8 formatVersion;
+    quint8 stemCount;
+    quint16 reserved;
+    double visualSampleRate;
+    double audioVisualRatio;
+    quint32 dataSize;
+    {
+        QDataStream stream(data);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        stream.skipRawData(kCompactMagic.size());
+        stream >> formatVersion >> stemCount >> reserved >>
+                visualSampleRate >> audioVisualRatio >> dataSize;
+        if (stream.status() != QDataStream::Ok) {
+            qDebug() << "ERROR: Could not read waveform header from QByteArray of size"
+                     << data.size();
+            return;
+        }
+    }
+    if (formatVersion != kCompactFormatVersion) {
+        qDebug() << "ERROR: Unsupported waveform format version" << formatVersion;
+        return;
+    }
+    if (stemCount > mixxx::kMaxSupportedStems ||
+            dataSize > static_cast<quint32>(std::numeric_limits<int>::max() /
+                               (kCompactFilteredPlaneCount + stemCount)) ||
+            data.size() - kCompactHeaderSize !=
+                    static_cast<qint64>(kCompactFilteredPlaneCount + stemCount) *
+                            dataSize) {
+        qDebug() << "ERROR: Waveform data is truncated or corrupt. Skipping.";
+        return;
+    }
+
+    resize(static_cast<int>(dataSize));
+    m_visualSampleRate = visualSampleRate;
+    m_audioVisualRatio = audioVisualRatio;
+    m_stemCount = stemCount;
+
+    const auto* pPlane = reinterpret_cast<const unsigned char*>(
+            data.constData() + kCompactHeaderSize);
+    const auto readPlane = [&](auto getValue) {
+        for (int i = 0; i < m_dataSize; ++i) {
+            const unsigned char previous = i >= ChannelCount
+                    ? getValue(m_data[i - ChannelCount])
+                    : 0;
+            getValue(m_data[i]) = static_cast<unsigned char>(previous + pPlane[i]);
+        }
+        pPlane += m_dataSize;
+    };
+    for (const auto pMember : kCompactFilteredPlanes) {
+        readPlane([pMember](WaveformData& datum) -> unsigned char& {
+            return datum.filtered.*pMember;
+        });
+    }
+    for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
+        readPlane([stemIdx](WaveformData& datum) -> unsigned char& {
+            return datum.stems[stemIdx];
+        });
+    }
+
+    m_completion = m_dataSize;
+    m_saveState = SaveState::Saved;
+}
+
 void Waveform::readByteArray(const QByteArray& data) {
     if (data.isNull()) {
         return;
     }
 
+    if (isCompactByteArray(data)) {
+        readCompactByteArray(data);
+        return;
+    }
+
     io::Waveform waveform;
 
     if (!waveform.ParseFromArray(data.constData(), data.size())) {
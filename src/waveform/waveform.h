@@ -45,6 +45,14 @@ class Waveform {
 
     virtual ~Waveform();
 
+    // The number of audio frames per visual sample of a waveform that
+    // would be created by the constructor above with the same arguments.
+    static double computeAudioVisualRatio(
+            int audioSampleRate,
+            SINT frameLength,
+            int desiredVisualSampleRate,
+            int maxVisualSamples);
+
     int getId() const {
         const auto locker = lockMutex(&m_mutex);
         return m_id;
@@ -75,7 +83,12 @@ class Waveform {
         m_description = description;
     }
 
+    // Serialize as protobuf message
     QByteArray toByteArray() const;
+    // Serialize with the compact encoding that is stored in the database.
+    // Both encodings are accepted by the constructor.
+    QByteArray toCompactByteArray() const;
+    static bool isCompactByteArray(const QByteArray& data);
 
     SaveState saveState() const {
         return m_saveState;
@@ -137,6 +150,7 @@ class Waveform {
 
   private:
     void readByteArray(const QByteArray& data);
+    void readCompactByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size);
 
@@ -11,6 +11,28 @@ Waveform* WaveformFactory::loadWaveformFromAnalysis(
     return pWaveform;
 }
 
+// static
+bool WaveformFactory::convertAnalysis(
+        AnalysisDao* pAnalysisDao,
+        const AnalysisDao::AnalysisInfo& analysis,
+        Waveform* pWaveform) {
+    AnalysisDao::AnalysisInfo converted = analysis;
+    if (analysis.type == AnalysisDao::TYPE_WAVESUMMARY) {
+        converted.version = currentWaveformSummaryVersion();
+        converted.description = currentWaveformSummaryDescription();
+    } else {
+        converted.version = currentWaveformVersion();
+        converted.description = currentWaveformDescription();
+    }
+    converted.data = pWaveform->toCompactByteArray();
+    if (!pAnalysisDao->saveAnalysis(&converted)) {
+        return false;
+    }
+    pWaveform->setVersion(converted.version);
+    pWaveform->setDescription(converted.description);
+    return true;
+}
+
 // static
 WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(const QString& version) {
     if (version == WAVEFORM_CURRENT_VERSION) {
@@ -18,6 +40,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(con
         return VC_USE;
     }
 
+    if (version == WAVEFORM_5_VERSION || version == WAVEFORM_6_VERSION) {
+        // Same data, but encoded as protobuf message
+        return VC_CONVERT;
+    }
+
     if (version == WAVEFORM_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug #7776
         return VC_REMOVE;
@@ -44,6 +71,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformSummaryVersionToVersionCl
         return VC_USE;
     }
 
+    if (version == WAVEFORMSUMMARY_5_VERSION) {
+        // Same data, but encoded as protobuf message
+        return VC_CONVERT;
+    }
+
     if (version == WAVEFORMSUMMARY_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug #7776
         return VC_REMOVE;
@@ -27,30 +27,39 @@ class Waveform;
 #define WAVEFORM_5_DESCRIPTION "Waveform 5.0"
 #define WAVEFORMSUMMARY_5_DESCRIPTION "WaveformSummary 5.0"
 
-#ifdef __STEM__
 // Used from Mixxx 2.6 with Stem data
 #define WAVEFORM_6_VERSION "Waveform-6.0"
 #define WAVEFORM_6_DESCRIPTION "Waveform 6.0"
 
-#define WAVEFORM_CURRENT_VERSION WAVEFORM_6_VERSION
-#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_6_DESCRIPTION
-#else
-#define WAVEFORM_CURRENT_VERSION WAVEFORM_5_VERSION
-#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_5_DESCRIPTION
-#endif
-#define WAVEFORMSUMMARY_CURRENT_VERSION WAVEFORMSUMMARY_5_VERSION
-#define WAVEFORMSUMMARY_CURRENT_DESCRIPTION WAVEFORMSUMMARY_5_DESCRIPTION
+// Used from Mixxx 2.6 with the compact encoding instead of protobuf
+#define WAVEFORM_7_VERSION "Waveform-7.0"
+#define WAVEFORMSUMMARY_7_VERSION "WaveformSummary-7.0"
+#define WAVEFORM_7_DESCRIPTION "Waveform 7.0"
+#define WAVEFORMSUMMARY_7_DESCRIPTION "WaveformSummary 7.0"
+
+#define WAVEFORM_CURRENT_VERSION WAVEFORM_7_VERSION
+#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_7_DESCRIPTION
+#define WAVEFORMSUMMARY_CURRENT_VERSION WAVEFORMSUMMARY_7_VERSION
+#define WAVEFORMSUMMARY_CURRENT_DESCRIPTION WAVEFORMSUMMARY_7_DESCRIPTION
 
 class WaveformFactory {
   public:
     enum VersionClass {
         VC_USE,
+        // Use, but convert to the current version
+        VC_CONVERT,
         VC_KEEP,
         VC_REMOVE
     };
 
     static Waveform* loadWaveformFromAnalysis(
             const AnalysisDao::AnalysisInfo& analysis);
+    // Store a waveform that has been loaded from an analysis with an
+    // outdated encoding with the current version and encoding in place.
+    static bool convertAnalysis(
+            AnalysisDao* pAnalysisDao,
+            const AnalysisDao::AnalysisInfo& analysis,
+            Waveform* pWaveform);
     static VersionClass waveformVersionToVersionClass(const QString& version);
     static VersionClass waveformSummaryVersionToVersionClass(const QString& version);
     static QString currentWaveformVersion();
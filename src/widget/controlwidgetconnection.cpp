@@ -2,6 +2,7 @@
 
 #include <QStyle>
 
+#include "control/controlchangeset.h"
 #include "control/controlproxy.h"
 #include "moc_controlwidgetconnection.cpp"
 #include "util/assert.h"
@@ -30,14 +31,38 @@ QMetaProperty propertyFromWidget(const QWidget* pWidget, const QString& name) {
 
 } // namespace
 
+ControlChangeSet* ControlWidgetConnection::s_pFrameChangeSet = nullptr;
+
 ControlWidgetConnection::ControlWidgetConnection(
         WBaseWidget* pBaseWidget,
         const ConfigKey& key,
         ValueTransformer* pTransformer)
         : m_pWidget(pBaseWidget),
-          m_pValueTransformer(pTransformer) {
+          m_pValueTransformer(pTransformer),
+          m_pChangeSet(s_pFrameChangeSet),
+          m_changeSetHandle(-1) {
     m_pControl = new ControlProxy(key, this, ControlFlag::NoAssertIfMissing);
-    m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+    if (m_pChangeSet) {
+        m_changeSetHandle = m_pChangeSet->subscribe(
+                key,
+                [this](double value) {
+                    slotControlValueChanged(value);
+                },
+                m_pControl);
+    } else {
+        m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+    }
+}
+
+ControlWidgetConnection::~ControlWidgetConnection() {
+    if (m_changeSetHandle >= 0) {
+        m_pChangeSet->unsubscribe(m_changeSetHandle);
+    }
+}
+
+// static
+void ControlWidgetConnection::setFrameChangeSet(ControlChangeSet* pChangeSet) {
+    s_pFrameChangeSet = pChangeSet;
 }
 
 void ControlWidgetConnection::setControlParameter(double parameter) {
@@ -8,6 +8,7 @@
 #include "control/controlproxy.h"
 #include "util/valuetransformer.h"
 
+class ControlChangeSet;
 class WBaseWidget;
 
 class ControlWidgetConnection : public QObject {
@@ -17,6 +18,12 @@ class ControlWidgetConnection : public QObject {
     ControlWidgetConnection(WBaseWidget* pBaseWidget,
                             const ConfigKey& key,
                             ValueTransformer* pTransformer);
+    ~ControlWidgetConnection() override;
+
+    /// Connections that are created while a change set is installed
+    /// receive the changes of their control once per frame from the set
+    /// instead of a signal for every change.
+    static void setFrameChangeSet(ControlChangeSet* pChangeSet);
 
     double getControlParameter() const;
     double getControlParameterForValue(double value) const;
@@ -42,6 +49,10 @@ class ControlWidgetConnection : public QObject {
 
   private:
     QScopedPointer<ValueTransformer> m_pValueTransformer;
+
+    static ControlChangeSet* s_pFrameChangeSet;
+    ControlChangeSet* m_pChangeSet;
+    int m_changeSetHandle;
 };
 
 class ControlParameterWidgetConnection final : public ControlWidgetConnection {
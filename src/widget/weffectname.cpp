@@ -1,5 +1,7 @@
 #include "widget/weffectname.h"
 
+#include <QEvent>
+
 #include "moc_weffectname.cpp"
 #include "widget/effectwidgetutils.h"
 
@@ -34,18 +36,35 @@ void WEffectName::setEffectSlot(EffectSlotPointer pEffectSlot) {
     }
 }
 
+bool WEffectName::event(QEvent* pEvent) {
+    if (pEvent->type() == QEvent::ToolTip &&
+            m_pEffectSlot && m_pEffectSlot->isLoaded()) {
+        // The CPU usage changes continuously, so it is only
+        // updated when the tooltip is about to be shown.
+        QString tooltip = m_description + QChar('\n') +
+                //: %1 = percentage of the audio buffer duration
+                tr("CPU usage: %1% of the audio buffer")
+                        .arg(m_pEffectSlot->getCpuUsage() * 100, 0, 'f', 1);
+        if (m_pEffectSlot->isBypassedByCpuGovernor()) {
+            tooltip += QChar('\n') +
+                    tr("Bypassed to prevent audio dropouts.");
+        }
+        setBaseTooltip(tooltip);
+    }
+    return WLabel::event(pEvent);
+}
+
 void WEffectName::effectUpdated() {
     QString name;
-    QString description;
     if (m_pEffectSlot && m_pEffectSlot->isLoaded()) {
         EffectManifestPointer pManifest = m_pEffectSlot->getManifest();
         name = pManifest->displayName();
         //: %1 = effect name; %2 = effect description
-        description = tr("%1: %2").arg(pManifest->name(), pManifest->description());
+        m_description = tr("%1: %2").arg(pManifest->name(), pManifest->description());
     } else {
         name = kNoEffectString;
-        description = tr("No effect loaded.");
+        m_description = tr("No effect loaded.");
     }
     setText(name);
-    setBaseTooltip(description);
+    setBaseTooltip(m_description);
 }
@@ -12,6 +12,9 @@ class WEffectName : public WLabel {
 
     void setup(const QDomNode& node, const SkinContext& context) override;
 
+  protected:
+    bool event(QEvent* pEvent) override;
+
   private slots:
     void effectUpdated();
 
@@ -20,4 +23,5 @@ class WEffectName : public WLabel {
 
     EffectsManager* m_pEffectsManager;
     EffectSlotPointer m_pEffectSlot;
+    QString m_description;
 };